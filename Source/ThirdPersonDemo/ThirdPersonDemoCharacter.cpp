@@ -2,20 +2,119 @@
 
 #include "ThirdPersonDemoCharacter.h"
 #include "HeadMountedDisplayFunctionLibrary.h"
+#include "Algo/AnyOf.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
+#include "Components/SphereComponent.h"
+#include "EnhancedInputComponent.h"
+#include "EnhancedInputSubsystems.h"
+#include "EngineUtils.h"
+#include "Engine/AssetManager.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "InputAction.h"
+#include "InputMappingContext.h"
+#include "InputModifiers.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Animation/AnimInstance.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
+#include "TraversableComponent.h"
+#include "TraversalAIController.h"
+#include "TraversalActorPoolSubsystem.h"
+#include "TraversalCameraModifier.h"
+#include "TraversalDebug.h"
+#include "TraversalEdgeIndexSubsystem.h"
+#include "TraversalMath.h"
+#include "TraversalMovementComponent.h"
+#include "TraversalNavLinkGenerator.h"
+#include "TraversalProximitySubsystem.h"
+#include "TraversalSkeletalMeshComponent.h"
+#include "TraversalStats.h"
+#include "TraversalTickSubsystem.h"
+
+static TAutoConsoleVariable<float> CVarTraversalNetMaxAnchorDistance(
+	TEXT("traversal.Net.MaxAnchorDistance"),
+	200.f,
+	TEXT("Farthest a client predicted hang or cover anchor can be from where the server has the character."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTraversalNetAnchorTolerance(
+	TEXT("traversal.Net.AnchorTolerance"),
+	30.f,
+	TEXT("Farthest a client predicted hang or cover anchor can be from the one the server finds with its own probes."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTraversalNetWallRunGraceMoves(
+	TEXT("traversal.Net.WallRunGraceMoves"),
+	3,
+	TEXT("Moves in a row a client may keep wall running without the server finding a wall beside it, covering the client leaving a little later than the server would."),
+	ECVF_Default);
+
+namespace
+{
+	/** Batch of one shared by every character ticking outside of UTraversalTickSubsystem, filled and consumed within a single TickTraversal **/
+	FTraversalBatch SoloTraversalBatch;
+
+	/** Returns true if a client predicted anchor matches the one the server found **/
+	bool IsAnchorWithinTolerance(const FVector& ServerLocation, const FRotator& ServerRotation, const FVector& ClientLocation, const FRotator& ClientRotation)
+	{
+		constexpr float MaxYawError = 15.f;
+		return FVector::DistSquared(ServerLocation, ClientLocation) <= FMath::Square(CVarTraversalNetAnchorTolerance.GetValueOnGameThread())
+			&& FMath::Abs(FMath::FindDeltaAngleDegrees(ServerRotation.Yaw, ClientRotation.Yaw)) <= MaxYawError;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TraversalMemReportCommand(
+	TEXT("Traversal.MemReport"),
+	TEXT("Log the traversal memory of every character in the world, and of the profiles they share"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr) return;
+
+		int32 NumCharacters = 0;
+		SIZE_T TotalSize = 0;
+		SIZE_T MinSize = TNumericLimits<SIZE_T>::Max();
+		SIZE_T MaxSize = 0;
+		TSet<const UTraversalProfile*> Profiles;
+		for (TActorIterator<AThirdPersonDemoCharacter> CharacterIterator(World); CharacterIterator; ++CharacterIterator)
+		{
+			const SIZE_T Size = CharacterIterator->GetTraversalMemorySize();
+			TotalSize += Size;
+			MinSize = FMath::Min(MinSize, Size);
+			MaxSize = FMath::Max(MaxSize, Size);
+			Profiles.Add(&CharacterIterator->GetTraversalProfile());
+			++NumCharacters;
+		}
+
+		if (NumCharacters == 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Traversal memory: no traversal characters in %s"), *World->GetName());
+			return;
+		}
+
+		const SIZE_T AverageSize = TotalSize / NumCharacters;
+		UE_LOG(LogTemp, Log, TEXT("Traversal memory: %d characters, %llu bytes each on average (min %llu, max %llu), %.1f KB total, %.1f KB at 1000 characters"),
+			NumCharacters, static_cast<uint64>(AverageSize), static_cast<uint64>(MinSize), static_cast<uint64>(MaxSize), TotalSize / 1024.0, AverageSize * 1000 / 1024.0);
+		UE_LOG(LogTemp, Log, TEXT("Traversal memory: %d shared profiles of %d bytes, character actor %d bytes, probe hit %d bytes (FHitResult %d)"),
+			Profiles.Num(), UTraversalProfile::StaticClass()->GetStructureSize(), AThirdPersonDemoCharacter::StaticClass()->GetStructureSize(),
+			static_cast<int32>(sizeof(FTraversalProbeHit)), static_cast<int32>(sizeof(FHitResult)));
+	}));
 
 //////////////////////////////////////////////////////////////////////////
 // AThirdPersonDemoCharacter
 
-AThirdPersonDemoCharacter::AThirdPersonDemoCharacter()
+AThirdPersonDemoCharacter::AThirdPersonDemoCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer
+		.SetDefaultSubobjectClass<UTraversalMovementComponent>(ACharacter::CharacterMovementComponentName)
+		.SetDefaultSubobjectClass<UTraversalSkeletalMeshComponent>(ACharacter::MeshComponentName))
 {
+	TraversalMovement = CastChecked<UTraversalMovementComponent>(GetCharacterMovement());
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 
@@ -39,81 +138,979 @@ AThirdPersonDemoCharacter::AThirdPersonDemoCharacter()
 	CameraBoom->SetupAttachment(RootComponent);
 	CameraBoom->TargetArmLength = 300.0f; // The camera follows at this distance behind the character	
 	CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
+	CameraBoom->bDoCollisionTest = false; // The traversal camera rig sweeps the boom asynchronously
 
 	// Create a follow camera
 	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 
+	// Create the proximity sphere. Large enough to contain every ledge and cover probe, it only overlaps world geometry
+	TraversalProximity = CreateDefaultSubobject<USphereComponent>(TEXT("TraversalProximity"));
+	TraversalProximity->SetupAttachment(RootComponent);
+	TraversalProximity->InitSphereRadius(250.f);
+	TraversalProximity->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	// Own object type that only traversable actors respond to, see UTraversableComponent::EnableProximityOverlaps
+	TraversalProximity->SetCollisionObjectType(ECC_TraversalProximity);
+	TraversalProximity->SetCollisionResponseToAllChannels(ECR_Ignore);
+	TraversalProximity->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Overlap);
+	TraversalProximity->SetCollisionResponseToChannel(ECC_WorldDynamic, ECR_Overlap);
+	TraversalProximity->SetGenerateOverlapEvents(true);
+	TraversalProximity->SetCanEverAffectNavigation(false);
+	TraversalProximity->CanCharacterStepUpOn = ECB_No;
+	TraversalProximity->OnComponentBeginOverlap.AddDynamic(this, &AThirdPersonDemoCharacter::OnTraversalProximityBeginOverlap);
+	TraversalProximity->OnComponentEndOverlap.AddDynamic(this, &AThirdPersonDemoCharacter::OnTraversalProximityEndOverlap);
+
+	// AI follows paths through the generated traversal nav links
+	AIControllerClass = ATraversalAIController::StaticClass();
+
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named MyCharacter (to avoid direct content references in C++)
 }
 
-void AThirdPersonDemoCharacter::BeginPlay()
+void AThirdPersonDemoCharacter::PostLoad()
+{
+	Super::PostLoad();
+
+	MigrateDeprecatedTuning();
+}
+
+void AThirdPersonDemoCharacter::MigrateDeprecatedTuning()
+{
+	// A profile set since the tuning moved already holds the values
+	if (TraversalProfile != nullptr) return;
+
+	struct FDeprecatedTuning
+	{
+		float AThirdPersonDemoCharacter::* Deprecated;
+		float UTraversalProfile::* Profile;
+	};
+	static const FDeprecatedTuning DeprecatedTunings[] =
+	{
+		{ &AThirdPersonDemoCharacter::MaxAimMoveRate_DEPRECATED, &UTraversalProfile::MaxAimMoveRate },
+		{ &AThirdPersonDemoCharacter::ClimbForwardDistance_DEPRECATED, &UTraversalProfile::ClimbForwardDistance },
+		{ &AThirdPersonDemoCharacter::ClimbUpMaxDistance_DEPRECATED, &UTraversalProfile::ClimbUpMaxDistance },
+		{ &AThirdPersonDemoCharacter::ClimbUpMinDistance_DEPRECATED, &UTraversalProfile::ClimbUpMinDistance },
+		{ &AThirdPersonDemoCharacter::WallRunSideDistance_DEPRECATED, &UTraversalProfile::WallRunSideDistance },
+		{ &AThirdPersonDemoCharacter::WallRunMinHorizontalSpeed_DEPRECATED, &UTraversalProfile::WallRunMinHorizontalSpeed },
+		{ &AThirdPersonDemoCharacter::WallRunMinVerticalVelocity_DEPRECATED, &UTraversalProfile::WallRunMinVerticalVelocity },
+		{ &AThirdPersonDemoCharacter::WallRunMinJumpOffSpeed_DEPRECATED, &UTraversalProfile::WallRunMinJumpOffSpeed },
+		{ &AThirdPersonDemoCharacter::WallRunMinGravityScale_DEPRECATED, &UTraversalProfile::WallRunMinGravityScale },
+		{ &AThirdPersonDemoCharacter::WallRunVerticalSpeedMultiplier_DEPRECATED, &UTraversalProfile::WallRunVerticalSpeedMultiplier },
+		{ &AThirdPersonDemoCharacter::CoverForwardDistance_DEPRECATED, &UTraversalProfile::CoverForwardDistance },
+		{ &AThirdPersonDemoCharacter::CoverSideDistance_DEPRECATED, &UTraversalProfile::CoverSideDistance },
+		{ &AThirdPersonDemoCharacter::HangHorizontalOffset_DEPRECATED, &UTraversalProfile::HangHorizontalOffset },
+		{ &AThirdPersonDemoCharacter::HangVerticalOffset_DEPRECATED, &UTraversalProfile::HangVerticalOffset },
+		{ &AThirdPersonDemoCharacter::WallRunOffset_DEPRECATED, &UTraversalProfile::WallRunOffset },
+		{ &AThirdPersonDemoCharacter::CoverForwardOffset_DEPRECATED, &UTraversalProfile::CoverForwardOffset },
+		{ &AThirdPersonDemoCharacter::CoverSideOffset_DEPRECATED, &UTraversalProfile::CoverSideOffset },
+		{ &AThirdPersonDemoCharacter::CoverAimYOffset_DEPRECATED, &UTraversalProfile::CoverAimYOffset },
+		{ &AThirdPersonDemoCharacter::CameraCoverYOffset_DEPRECATED, &UTraversalProfile::CameraCoverYOffset },
+		{ &AThirdPersonDemoCharacter::CameraAimYOffset_DEPRECATED, &UTraversalProfile::CameraAimYOffset },
+		{ &AThirdPersonDemoCharacter::CameraBoomAimLength_DEPRECATED, &UTraversalProfile::CameraBoomAimLength },
+		{ &AThirdPersonDemoCharacter::TraceOffset_DEPRECATED, &UTraversalProfile::TraceOffset },
+	};
+
+	// Nothing overridden, the profile class defaults are the old defaults
+	const UTraversalProfile* DefaultProfile = GetDefault<UTraversalProfile>();
+	const bool bOverridden = Algo::AnyOf(DeprecatedTunings, [this, DefaultProfile](const FDeprecatedTuning& Tuning)
+	{
+		return this->*Tuning.Deprecated != DefaultProfile->*Tuning.Profile;
+	});
+	if (!bOverridden) return;
+
+	// Outered to the character, so migrating a blueprint's class default object keeps the profile in the blueprint package
+	TraversalProfile = NewObject<UTraversalProfile>(this, TEXT("MigratedTraversalProfile"), GetMaskedFlags(RF_PropagateToSubObjects));
+	for (const FDeprecatedTuning& Tuning : DeprecatedTunings)
+	{
+		TraversalProfile->*Tuning.Profile = this->*Tuning.Deprecated;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("%s: Moved tuning overrides into a profile of its own, resave it or assign a shared TraversalProfile"), *GetPathName());
+}
+
+void AThirdPersonDemoCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	MaxJumpHeight = GetCharacterMovement()->GetMaxJumpHeight();
+	CameraBoomOriginalLength = CameraBoom->TargetArmLength;
+	RecalculateTargetCameraOffset();
+
+	// Tagged actors only generate overlaps once the world began play, which may be after we spawned
+	TraversalProximity->UpdateOverlaps();
+
+	RequestTraversalAssets();
+
+	// Tick with every other traversal character instead of through our own actor tick
+	if (UTraversalTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UTraversalTickSubsystem>())
+	{
+		TickSubsystem->RegisterCharacter(this);
+	}
+}
+
+void AThirdPersonDemoCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Hand the climb indicator back to the pool
+	HideClimbUI();
+	UTraversalActorPoolSubsystem* ActorPool = GetWorld()->GetSubsystem<UTraversalActorPoolSubsystem>();
+	if (ActorPool != nullptr && ReservedClimbUIClass != nullptr)
+	{
+		ActorPool->Unreserve(ReservedClimbUIClass);
+		ReservedClimbUIClass = nullptr;
+	}
+
+	// Stop loading, or let the assets go if no other character holds them
+	if (TraversalAssetsHandle.IsValid())
+	{
+		TraversalAssetsHandle->CancelHandle();
+		TraversalAssetsHandle.Reset();
+	}
+
+	if (UTraversalTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UTraversalTickSubsystem>())
+	{
+		TickSubsystem->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AThirdPersonDemoCharacter::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	if (UTraversalTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UTraversalTickSubsystem>())
+	{
+		TickSubsystem->AddControllerPrerequisite(NewController);
+	}
+}
+
+void AThirdPersonDemoCharacter::GetTraversalAssetPaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+	if (!ClimbMontage.IsNull()) OutPaths.Add(ClimbMontage.ToSoftObjectPath());
+	if (!ClimbUIClass.IsNull() && !IsRunningDedicatedServer()) OutPaths.Add(ClimbUIClass.ToSoftObjectPath());
+}
+
+void AThirdPersonDemoCharacter::RequestTraversalAssets()
+{
+	TArray<FSoftObjectPath> AssetPaths;
+	GetTraversalAssetPaths(AssetPaths);
+	if (AssetPaths.Num() == 0)
+	{
+		OnTraversalAssetsLoaded();
+		return;
+	}
+
+	// Usually already preloaded by the game mode, in which case this only takes a reference
+	TraversalAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths,
+		FStreamableDelegate::CreateUObject(this, &AThirdPersonDemoCharacter::OnTraversalAssetsLoaded), FStreamableManager::AsyncLoadHighPriority);
+	if (!TraversalAssetsHandle.IsValid())
+	{
+		// Nothing could be requested, e.g. invalid paths. Traversal still runs, without montage or indicator
+		OnTraversalAssetsLoaded();
+	}
+}
+
+void AThirdPersonDemoCharacter::OnTraversalAssetsLoaded()
+{
+	bTraversalAssetsReady = true;
+
+	// Have our own climb indicator ready so showing it never has to spawn mid-game
+	UTraversalActorPoolSubsystem* ActorPool = GetWorld()->GetSubsystem<UTraversalActorPoolSubsystem>();
+	if (ActorPool != nullptr && ClimbUIClass.Get() != nullptr)
+	{
+		ReservedClimbUIClass = ClimbUIClass.Get();
+		ActorPool->Reserve(ReservedClimbUIClass);
+	}
+}
+
+void AThirdPersonDemoCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (IsTraversalLocallyPredicted()) TickTraversal(DeltaSeconds);
+}
+
+void AThirdPersonDemoCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owning client predicts its own state and gets the server's back with corrections
+	DOREPLIFETIME_CONDITION(AThirdPersonDemoCharacter, ReplicatedTraversalState, COND_SimulatedOnly);
+}
+
+void AThirdPersonDemoCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	ReplicatedTraversalState = GetPackedTraversalState();
+	if (bIsAiming) ReplicatedTraversalState |= ETraversalPackedState::Aiming;
+}
+
+void AThirdPersonDemoCharacter::OnRep_ReplicatedTraversalState()
+{
+	const ETraversalState NewState = static_cast<ETraversalState>(ReplicatedTraversalState & ETraversalPackedState::StateMask);
+	if (NewState >= ETraversalState::Count) return;
+
+	bIsAiming = (ReplicatedTraversalState & ETraversalPackedState::Aiming) != 0;
+	UnpackTraversalQualifiers(ReplicatedTraversalState);
+	if (NewState != TraversalState) ForceTraversalState(NewState);
+}
+
+bool AThirdPersonDemoCharacter::IsTraversalLocallyPredicted() const
+{
+	// Simulated proxies follow the replicated state, and the server follows the moves of remote players
+	return GetLocalRole() == ROLE_AutonomousProxy || (GetLocalRole() == ROLE_Authority && GetRemoteRole() != ROLE_AutonomousProxy);
+}
+
+uint8 AThirdPersonDemoCharacter::GetPackedTraversalState() const
+{
+	uint8 PackedState = static_cast<uint8>(TraversalState);
+	if (TraversalState == ETraversalState::WallRunning && bIsRightWallRunning) PackedState |= ETraversalPackedState::RightWallRun;
+	if (TraversalState == ETraversalState::InCover)
+	{
+		if (bIsRightCover) PackedState |= ETraversalPackedState::RightCover;
+		if (bIsTallCover) PackedState |= ETraversalPackedState::TallCover;
+	}
+	return PackedState;
+}
+
+void AThirdPersonDemoCharacter::UnpackTraversalQualifiers(const uint8 PackedState)
+{
+	const ETraversalState State = static_cast<ETraversalState>(PackedState & ETraversalPackedState::StateMask);
+	if (State == ETraversalState::WallRunning)
+	{
+		bIsRightWallRunning = (PackedState & ETraversalPackedState::RightWallRun) != 0;
+	}
+	else if (State == ETraversalState::InCover)
+	{
+		bIsRightCover = (PackedState & ETraversalPackedState::RightCover) != 0;
+		bIsTallCover = (PackedState & ETraversalPackedState::TallCover) != 0;
+	}
+}
+
+void AThirdPersonDemoCharacter::ApplyPredictedAim(const bool bWantsToAim)
+{
+	if (bWantsToAim == bIsAiming) return;
+
+	if (bWantsToAim)
+	{
+		StartAim();
+	}
+	else
+	{
+		EndAim();
+	}
+}
+
+bool AThirdPersonDemoCharacter::ApplyPredictedTraversalState(const uint8 PackedState, const FVector& AnchorLocation, const FRotator& AnchorRotation)
+{
+	const ETraversalState NewState = static_cast<ETraversalState>(PackedState & ETraversalPackedState::StateMask);
+	const bool bHasAnchor = (PackedState & ETraversalPackedState::HasAnchor) != 0;
+	if (NewState >= ETraversalState::Count) return false;
+
+	// Anchors come from the client's probes, only take them near where the server has the character
+	const float MaxAnchorDistance = CVarTraversalNetMaxAnchorDistance.GetValueOnGameThread();
+	if (bHasAnchor && FVector::DistSquared(AnchorLocation, GetActorLocation()) > FMath::Square(MaxAnchorDistance)) return false;
+
+	if (NewState == TraversalState)
+	{
+		// The wall has to stay beside a wall run. The client may leave it a few moves after we stop finding the wall
+		if (NewState == ETraversalState::WallRunning)
+		{
+			WallRunValidationMisses = HasWallRunWall(bIsRightWallRunning) ? 0 : WallRunValidationMisses + 1;
+			if (WallRunValidationMisses > CVarTraversalNetWallRunGraceMoves.GetValueOnGameThread())
+			{
+				ExitWallRun();
+				return false;
+			}
+		}
+
+		// Popping out of cover to aim moves the anchor without changing state. ApplyPredictedAim already moved ours there
+		if (bHasAnchor && TraversalMovement->HasTraversalAnchor())
+		{
+			if (!IsAnchorWithinTolerance(TraversalMovement->GetAnchorLocation(), TraversalMovement->GetAnchorRotation(), AnchorLocation, AnchorRotation)) return false;
+			TraversalMovement->InterpolateTo(AnchorLocation, AnchorRotation);
+		}
+
+		UnpackTraversalQualifiers(PackedState);
+		return true;
+	}
+
+	if (!CanTransitionTraversalState(TraversalState, NewState)) return false;
+
+	// Entries are only followed if our own probes find what the client found
+	switch (NewState)
+	{
+	case ETraversalState::Hanging:
+	{
+		FVector HangLocation;
+		FRotator HangRotation;
+		if (!bHasAnchor || !FindHang(HangLocation, HangRotation) || !IsAnchorWithinTolerance(HangLocation, HangRotation, AnchorLocation, AnchorRotation)) return false;
+		if (!SetTraversalState(ETraversalState::Hanging)) return false;
+		TraversalMovement->EnterTraversalMode(ETraversalMovementMode::Hang, AnchorLocation, AnchorRotation);
+		break;
+	}
+	case ETraversalState::Climbing:
+		TryClimbUp();
+		break;
+	case ETraversalState::WallRunning:
+		if (!TraversalMovement->IsFalling() || !HasWallRunWall((PackedState & ETraversalPackedState::RightWallRun) != 0)) return false;
+		WallRunValidationMisses = 0;
+		UnpackTraversalQualifiers(PackedState);
+		EnterWallRun();
+		break;
+	case ETraversalState::InCover:
+	{
+		FVector CoverLocation;
+		FRotator CoverRotation;
+		if (!bHasAnchor || !TraversalMovement->IsMovingOnGround()) return false;
+		if (!FindCover(CoverLocation, CoverRotation) || !IsAnchorWithinTolerance(CoverLocation, CoverRotation, AnchorLocation, AnchorRotation)) return false;
+		UnpackTraversalQualifiers(PackedState);
+		EnterCover(AnchorLocation, AnchorRotation);
+		break;
+	}
+	default:
+		// Leave the current state the way the client did
+		switch (TraversalState)
+		{
+		case ETraversalState::Hanging: TryDropDown(); break;
+		case ETraversalState::Climbing: OnClimbUpFinished(); break;
+		case ETraversalState::WallRunning: ExitWallRun(); break;
+		case ETraversalState::InCover: ExitCover(); break;
+		default: break;
+		}
+		break;
+	}
+
+	return TraversalState == NewState;
+}
+
+void AThirdPersonDemoCharacter::ApplyCorrectedTraversalState(const uint8 PackedState, const FVector& AnchorLocation, const FRotator& AnchorRotation)
+{
+	const ETraversalState NewState = static_cast<ETraversalState>(PackedState & ETraversalPackedState::StateMask);
+	if (NewState >= ETraversalState::Count) return;
+
+	UnpackTraversalQualifiers(PackedState);
+	if (NewState != TraversalState) ForceTraversalState(NewState);
+
+	// Replayed moves carry on towards the server's anchor
+	if ((PackedState & ETraversalPackedState::HasAnchor) && TraversalMovement->HasTraversalAnchor())
+	{
+		TraversalMovement->InterpolateTo(AnchorLocation, AnchorRotation);
+	}
+	RecalculateTargetCameraOffset();
+}
+
+void AThirdPersonDemoCharacter::TickTraversal(const float DeltaSeconds, const bool bRunEntryChecks /*= true*/)
+{
+	// Same phases as UTraversalTickSubsystem, with a batch of one
+	check(IsInGameThread());
+	SoloTraversalBatch.SetNum(1);
+	GatherTraversal(SoloTraversalBatch, 0, bRunEntryChecks);
+	TraversalKernel::PlanProbes(SoloTraversalBatch, 0, 1);
+	RunTraversalProbes(SoloTraversalBatch, 0);
+	TraversalKernel::Decide(SoloTraversalBatch, 0, 1);
+	ApplyTraversal(SoloTraversalBatch, 0, DeltaSeconds);
+}
+
+void AThirdPersonDemoCharacter::GatherTraversal(FTraversalBatch& Batch, const int32 Index, const bool bRunEntryChecks)
+{
+	const UTraversalProfile& Profile = GetTraversalProfile();
+
+	// Ledges and wall runs can only be entered once the climb montage and indicator are loaded
+	const bool bEntryChecks = bRunEntryChecks && bTraversalAssetsReady;
+
+	// Only run the checks the current state asks for
+	uint8 Checks = ETraversalCheck::None;
+	if (ShouldRunTraversalCheck(ETraversalCheck::WallRunMove))
+	{
+		Checks |= ETraversalCheck::WallRunMove;
+	}
+	else if (ShouldRunTraversalCheck(ETraversalCheck::DefaultMove))
+	{
+		Checks |= ETraversalCheck::DefaultMove;
+	}
+	if (bEntryChecks && ShouldRunTraversalCheck(ETraversalCheck::WallRunEnter))
+	{
+		Checks |= ETraversalCheck::WallRunEnter;
+	}
+
+	uint8 Flags = ETraversalBatchFlags::None;
+	if (Controller != nullptr) Flags |= ETraversalBatchFlags::HasController;
+	if (bIsAiming) Flags |= ETraversalBatchFlags::Aiming;
+	if (GetCharacterMovement()->IsFalling()) Flags |= ETraversalBatchFlags::Falling;
+	if (bEntryChecks) Flags |= ETraversalBatchFlags::RunEntryChecks;
+	if (bIsRightWallRunning) Flags |= ETraversalBatchFlags::RightWall;
+
+	// Keep the input this update runs on, for recording. Actions tapped since the last update count as held
+	if (bUseScriptedInput)
+	{
+		LastInputFrame = ScriptedInput;
+	}
+	else
+	{
+		const FRotator ControlRotation = GetControlRotation();
+		LastInputFrame.MoveForward = MoveInputValue.X;
+		LastInputFrame.MoveRight = MoveInputValue.Y;
+		LastInputFrame.ControlYaw = ControlRotation.Yaw;
+		LastInputFrame.ControlPitch = ControlRotation.Pitch;
+		LastInputFrame.Actions = HeldInputActions | PressedInputActions;
+	}
+	PressedInputActions = ETraversalInputAction::None;
+
+	// Get movement vector from inputs, rotate by controller yaw to get world direction, then normalise magnitude to 1
+	FVector ControlMoveVector = FVector::ZeroVector;
+	if (Controller != nullptr)
+	{
+		ControlMoveVector = FVector(LastInputFrame.MoveForward, LastInputFrame.MoveRight, 0.f);
+		ControlMoveVector = RotateAngleZAxis(ControlMoveVector, true, GetControlRotation().Yaw);
+		ControlMoveVector.Normalize();
+	}
+
+	// Side probes for wall run entry only run while the predicted jump passes a wall
+	if ((Checks & ETraversalCheck::WallRunEnter) && (Flags & ETraversalBatchFlags::Falling))
+	{
+		FTraversalWallRunPredictorInput PredictorInput;
+		PredictorInput.Location = GetActorLocation();
+		PredictorInput.Forward = GetActorForwardVector();
+		PredictorInput.Velocity = GetCharacterMovement()->Velocity;
+		PredictorInput.ControlMoveVector = ControlMoveVector;
+		PredictorInput.GravityZ = GetCharacterMovement()->GetGravityZ();
+		PredictorInput.SideProbeDrop = GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+		PredictorInput.WallRunSideDistance = Profile.WallRunSideDistance;
+		PredictorInput.WallRunMinVerticalVelocity = Profile.WallRunMinVerticalVelocity;
+		PredictorInput.MaxLookaheadTime = Profile.WallRunPredictionTime;
+		PredictorInput.VelocityTolerance = Profile.WallRunPredictionTolerance;
+		if (!WallRunPredictor.Update(this, PredictorInput, GetWorld()->GetTimeSeconds())) Flags |= ETraversalBatchFlags::NoPredictedWall;
+	}
+	else
+	{
+		WallRunPredictor.Reset();
+	}
+
+	Batch.States[Index] = TraversalState;
+	Batch.Checks[Index] = Checks;
+	Batch.Flags[Index] = Flags;
+	Batch.Locations[Index] = GetActorLocation();
+	Batch.Forwards[Index] = GetActorForwardVector();
+	Batch.Velocities[Index] = GetCharacterMovement()->Velocity;
+	Batch.ControlMoveVectors[Index] = ControlMoveVector;
+	Batch.ControlMoveMagnitudes[Index] = ControlMoveVector.Size();
+	Batch.CapsuleHalfHeights[Index] = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	Batch.CapsuleHalfHeightsWithoutHemisphere[Index] = GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+	Batch.Profiles[Index] = &Profile;
+}
+
+void AThirdPersonDemoCharacter::RunTraversalProbes(FTraversalBatch& Batch, const int32 Index)
+{
+	const uint8 Requests = Batch.ProbeRequests[Index];
+	uint8& Flags = Batch.Flags[Index];
+
+	// Check for a wall on the right side first, and only on the left side if there is none
+	FTraversalProbeHit SideHit;
+	bool bSideHit = false;
+	bool bRightSide = false;
+	if (Requests & ETraversalBatchProbe::SideRight)
+	{
+		bSideHit = DoProbeTraceCheck(ETraversalProbe::SideWallRunRight, Batch.SideProbeStarts[Index], Batch.SideRightProbeEnds[Index], SideHit);
+		bRightSide = true;
+	}
+	if (!bSideHit && (Requests & ETraversalBatchProbe::SideLeft))
+	{
+		bSideHit = DoProbeTraceCheck(ETraversalProbe::SideWallRunLeft, Batch.SideProbeStarts[Index], Batch.SideLeftProbeEnds[Index], SideHit);
+		bRightSide = false;
+	}
+
+	if (Requests & (ETraversalBatchProbe::SideRight | ETraversalBatchProbe::SideLeft))
+	{
+		bIsRightWallRunning = bRightSide;
+		if (bRightSide)
+		{
+			Flags |= ETraversalBatchFlags::RightWall;
+		}
+		else
+		{
+			Flags &= ~ETraversalBatchFlags::RightWall;
+		}
+		if (bSideHit)
+		{
+			Flags |= ETraversalBatchFlags::SideWallHit;
+			Batch.SideWallLocations[Index] = SideHit.Location;
+			Batch.SideWallNormals[Index] = SideHit.Normal;
+		}
+	}
+
+	// Check for ground to exit wall running
+	if (Requests & ETraversalBatchProbe::Down)
+	{
+		FTraversalProbeHit DownHit;
+		if (DoProbeTraceCheck(ETraversalProbe::DownWallRun, Batch.Locations[Index], Batch.DownProbeEnds[Index], DownHit))
+		{
+			Flags |= ETraversalBatchFlags::DownHit;
+		}
+	}
+}
+
+void AThirdPersonDemoCharacter::ApplyTraversal(const FTraversalBatch& Batch, const int32 Index, const float DeltaSeconds)
+{
+	ApplyTraversalMove(Batch, Index);
+
+	// Ledge checks need the full probe logic and stay on the game thread. Each one can change state, so the next one looks it up again.
+	// They only run near a traversable ledge
+	if (Batch.Flags[Index] & ETraversalBatchFlags::RunEntryChecks)
+	{
+		if (HasLedgeCandidate())
+		{
+			if (ShouldRunTraversalCheck(ETraversalCheck::LedgeIndicator)) TryUIHang();
+			if (ShouldRunTraversalCheck(ETraversalCheck::Ledge)) TryHang();
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_TraversalProximityCulledChecks);
+		}
+	}
+
+	// Grabbing a ledge wins over starting a wall run on the same frame
+	if (Batch.Decisions[Index] & ETraversalDecision::EnterWallRun) TryEnterWallRun();
+
+	// Presses that came too early may be valid in the state this update left us in
+	FlushInputBuffer();
+}
+
+bool AThirdPersonDemoCharacter::SetTraversalState(const ETraversalState NewState)
+{
+	if (!CanTransitionTraversalState(TraversalState, NewState))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Invalid traversal transition %s -> %s"), *GetName(), *UEnum::GetValueAsString(TraversalState), *UEnum::GetValueAsString(NewState));
+		return false;
+	}
+
+	ForceTraversalState(NewState);
+	return true;
+}
+
+void AThirdPersonDemoCharacter::ForceTraversalState(const ETraversalState NewState)
+{
+	const ETraversalState OldState = TraversalState;
+	TraversalState = NewState;
+
+	// Keep the anim blueprint flags in sync. Climbing still counts as hanging for the anim graph
+	bIsHanging = NewState == ETraversalState::Hanging || NewState == ETraversalState::Climbing;
+	bIsClimbing = NewState == ETraversalState::Climbing;
+	bIsWallRunning = NewState == ETraversalState::WallRunning;
+	bIsInCover = NewState == ETraversalState::InCover;
+
+	TraversalTrace::OutputStateTransition(this, OldState, NewState);
+
+	// Hits from the old state describe what it was anchored to, not what the new state looks for
+	ProbeCache.Invalidate();
+
+	// The indicator is only updated in states that check for it, so don't leave it behind
+	if (!HasTraversalCheck(ETraversalCheck::LedgeIndicator))
+	{
+		ClearUIHangOverlap();
+		HideClimbUI();
+	}
+}
+
+void AThirdPersonDemoCharacter::OnTraversalProximityBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	bool bHasLedges, bHasCover;
+	UTraversableComponent::GetTraversalFeatures(OtherActor, bHasLedges, bHasCover);
+	if (bHasLedges) LedgeCandidates.AddUnique(OtherComp);
+	if (bHasCover) CoverCandidates.AddUnique(OtherComp);
+}
+
+void AThirdPersonDemoCharacter::OnTraversalProximityEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	LedgeCandidates.RemoveSingleSwap(OtherComp);
+	CoverCandidates.RemoveSingleSwap(OtherComp);
+
+	// Drop components destroyed without ending their overlap
+	LedgeCandidates.RemoveAllSwap([](const TWeakObjectPtr<UPrimitiveComponent>& Candidate) { return !Candidate.IsValid(); });
+	CoverCandidates.RemoveAllSwap([](const TWeakObjectPtr<UPrimitiveComponent>& Candidate) { return !Candidate.IsValid(); });
+
+	// The indicator is no longer updated once the last ledge is out of range
+	if (!HasLedgeCandidate())
+	{
+		ClearUIHangOverlap();
+		HideClimbUI();
+	}
+}
+
+bool AThirdPersonDemoCharacter::HasLedgeCandidate() const
+{
+	if (LedgeCandidates.Num() > 0) return true;
+
+	const UTraversalProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UTraversalProximitySubsystem>();
+	return ProximitySubsystem == nullptr || !ProximitySubsystem->IsProximityCullingActive();
+}
+
+bool AThirdPersonDemoCharacter::HasCoverCandidate() const
+{
+	if (CoverCandidates.Num() > 0) return true;
+
+	const UTraversalProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UTraversalProximitySubsystem>();
+	return ProximitySubsystem == nullptr || !ProximitySubsystem->IsProximityCullingActive();
+}
+
+bool AThirdPersonDemoCharacter::HasTraversalCheck(const ETraversalCheck::Type Check) const
+{
+	return (GetTraversalStateDesc(TraversalState).Checks & Check) != 0;
+}
+
+bool AThirdPersonDemoCharacter::ShouldRunTraversalCheck(const ETraversalCheck::Type Check) const
+{
+	const bool bRun = HasTraversalCheck(Check);
+	if (bRun)
+	{
+		INC_DWORD_STAT(STAT_TraversalChecksRun);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_TraversalChecksSkipped);
+	}
+	return bRun;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Input
+
+namespace
+{
+	/** Map a key onto one axis of a 2D input action, like a legacy axis mapping with the sign of Scale **/
+	void MapAxisKey(UInputMappingContext* MappingContext, const UInputAction* Action, const FKey& Key, const bool bYAxis, const float Scale)
+	{
+		FEnhancedActionKeyMapping& Mapping = MappingContext->MapKey(Action, Key);
+		if (bYAxis)
+		{
+			UInputModifierSwizzleAxis* Swizzle = NewObject<UInputModifierSwizzleAxis>(MappingContext);
+			Swizzle->Order = EInputAxisSwizzle::YXZ;
+			Mapping.Modifiers.Add(Swizzle);
+		}
+		if (Scale < 0.f)
+		{
+			Mapping.Modifiers.Add(NewObject<UInputModifierNegate>(MappingContext));
+		}
+	}
+}
+
+void AThirdPersonDemoCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
+{
+	// Set up gameplay key bindings
+	check(PlayerInputComponent);
+
+	// Actions go through one handler so they can be recorded and replayed, see HandleInputAction
+	UEnhancedInputComponent* EnhancedInput = Cast<UEnhancedInputComponent>(PlayerInputComponent);
+	if (EnhancedInput != nullptr)
+	{
+		CreateDefaultInputMappings();
+	}
+	if (EnhancedInput != nullptr && TraversalMappingContext != nullptr)
+	{
+		EnhancedInput->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AThirdPersonDemoCharacter::OnMoveAction);
+		EnhancedInput->BindAction(MoveAction, ETriggerEvent::Completed, this, &AThirdPersonDemoCharacter::OnMoveActionCompleted);
+		EnhancedInput->BindAction(LookAction, ETriggerEvent::Triggered, this, &AThirdPersonDemoCharacter::OnLookAction);
+		EnhancedInput->BindAction(LookRateAction, ETriggerEvent::Triggered, this, &AThirdPersonDemoCharacter::OnLookRateAction);
+
+		for (const UInputAction* InputAction : { JumpAction, ClimbUpAction, DropDownAction, ToggleCoverAction, AimAction })
+		{
+			EnhancedInput->BindAction(InputAction, ETriggerEvent::Started, this, &AThirdPersonDemoCharacter::OnTraversalActionStarted);
+			EnhancedInput->BindAction(InputAction, ETriggerEvent::Completed, this, &AThirdPersonDemoCharacter::OnTraversalActionCompleted);
+		}
+		return;
+	}
+
+	// Legacy bindings, for input components other than the enhanced one set in DefaultInput.ini
+	PlayerInputComponent->BindAxis("MoveForward", this, &AThirdPersonDemoCharacter::OnMoveForwardAxis);
+	PlayerInputComponent->BindAxis("MoveRight", this, &AThirdPersonDemoCharacter::OnMoveRightAxis);
+
+	struct FActionBinding
+	{
+		const TCHAR* ActionName;
+		ETraversalInputAction::Type Action;
+	};
+	const FActionBinding ActionBindings[] =
+	{
+		{ TEXT("Jump"), ETraversalInputAction::Jump },
+		{ TEXT("ClimbUp"), ETraversalInputAction::ClimbUp },
+		{ TEXT("DropDown"), ETraversalInputAction::DropDown },
+		{ TEXT("ToggleCover"), ETraversalInputAction::ToggleCover },
+		{ TEXT("Aim"), ETraversalInputAction::Aim }
+	};
+	for (const FActionBinding& ActionBinding : ActionBindings)
+	{
+		PlayerInputComponent->BindAction<FTraversalActionDelegate>(ActionBinding.ActionName, IE_Pressed, this, &AThirdPersonDemoCharacter::OnInputActionPressed, ActionBinding.Action);
+		PlayerInputComponent->BindAction<FTraversalActionDelegate>(ActionBinding.ActionName, IE_Released, this, &AThirdPersonDemoCharacter::OnInputActionReleased, ActionBinding.Action);
+	}
+
+	// We have 2 versions of the rotation bindings to handle different kinds of devices differently
+	// "turn" handles devices that provide an absolute delta, such as a mouse.
+	// "turnrate" is for devices that we choose to treat as a rate of change, such as an analog joystick
+	PlayerInputComponent->BindAxis("Turn", this, &AThirdPersonDemoCharacter::Turn);
+	PlayerInputComponent->BindAxis("TurnRate", this, &AThirdPersonDemoCharacter::TurnAtRate);
+	PlayerInputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput);
+	PlayerInputComponent->BindAxis("LookUpRate", this, &AThirdPersonDemoCharacter::LookUpAtRate);
+}
+
+void AThirdPersonDemoCharacter::SetScriptedInput(const FTraversalInputFrame& Frame)
+{
+	const uint8 PressedActions = Frame.Actions & ~ScriptedInput.Actions;
+	const uint8 ReleasedActions = ScriptedInput.Actions & ~Frame.Actions;
+	ScriptedInput = Frame;
+
+	// Scripts start from an empty buffer, so a replay buffers the same presses as its recording
+	if (!bUseScriptedInput) InputBuffer.Reset();
+	bUseScriptedInput = true;
+
+	if (Controller != nullptr)
+	{
+		Controller->SetControlRotation(FRotator(Frame.ControlPitch, Frame.ControlYaw, 0.f));
+	}
+
+	for (uint8 Action = ETraversalInputAction::Jump; Action <= ETraversalInputAction::Aim; Action <<= 1)
+	{
+		if (PressedActions & Action) PressInputAction(static_cast<ETraversalInputAction::Type>(Action));
+		if (ReleasedActions & Action) HandleInputAction(static_cast<ETraversalInputAction::Type>(Action), false);
+	}
+}
+
+void AThirdPersonDemoCharacter::ClearScriptedInput()
+{
+	ScriptedInput = FTraversalInputFrame();
+	bUseScriptedInput = false;
+	InputBuffer.Reset();
+}
+
+uint32 AThirdPersonDemoCharacter::GetTraversalChecksum() const
+{
+	const FVector Location = GetActorLocation();
+	const FRotator Rotation = GetActorRotation();
+	const FVector Velocity = GetCharacterMovement()->Velocity;
+	const uint8 MovementMode = GetCharacterMovement()->MovementMode;
+	const uint8 Qualifiers = (bIsAiming << 0) | (bIsRightCover << 1) | (bIsTallCover << 2) | (bIsRightWallRunning << 3);
+
+	uint32 Crc = FCrc::MemCrc32(&Location, sizeof(Location));
+	Crc = FCrc::MemCrc32(&Rotation, sizeof(Rotation), Crc);
+	Crc = FCrc::MemCrc32(&Velocity, sizeof(Velocity), Crc);
+	Crc = FCrc::MemCrc32(&MovementMode, sizeof(MovementMode), Crc);
+	Crc = FCrc::MemCrc32(&TraversalState, sizeof(TraversalState), Crc);
+	return FCrc::MemCrc32(&Qualifiers, sizeof(Qualifiers), Crc);
+}
+
+void AThirdPersonDemoCharacter::OnInputActionPressed(ETraversalInputAction::Type Action)
+{
+	HeldInputActions |= Action;
+	PressedInputActions |= Action;
+	PressInputAction(Action);
+}
+
+void AThirdPersonDemoCharacter::OnInputActionReleased(ETraversalInputAction::Type Action)
+{
+	HeldInputActions &= ~Action;
+	HandleInputAction(Action, false);
+}
+
+void AThirdPersonDemoCharacter::OnTraversalActionStarted(const FInputActionInstance& Instance)
+{
+	const ETraversalInputAction::Type Action = GetTraversalInputAction(Instance.GetSourceAction());
+	if (Action != ETraversalInputAction::None) OnInputActionPressed(Action);
+}
+
+void AThirdPersonDemoCharacter::OnTraversalActionCompleted(const FInputActionInstance& Instance)
+{
+	const ETraversalInputAction::Type Action = GetTraversalInputAction(Instance.GetSourceAction());
+	if (Action != ETraversalInputAction::None) OnInputActionReleased(Action);
+}
+
+ETraversalInputAction::Type AThirdPersonDemoCharacter::GetTraversalInputAction(const UInputAction* InputAction) const
+{
+	if (InputAction == nullptr) return ETraversalInputAction::None;
+	if (InputAction == JumpAction) return ETraversalInputAction::Jump;
+	if (InputAction == ClimbUpAction) return ETraversalInputAction::ClimbUp;
+	if (InputAction == DropDownAction) return ETraversalInputAction::DropDown;
+	if (InputAction == ToggleCoverAction) return ETraversalInputAction::ToggleCover;
+	if (InputAction == AimAction) return ETraversalInputAction::Aim;
+	return ETraversalInputAction::None;
+}
+
+void AThirdPersonDemoCharacter::CreateDefaultInputMappings()
+{
+	if (TraversalMappingContext != nullptr) return;
+
+	const auto CreateAction = [this](const TCHAR* Name, const EInputActionValueType ValueType)
+	{
+		UInputAction* InputAction = NewObject<UInputAction>(this, Name, RF_Transient);
+		InputAction->ValueType = ValueType;
+		return InputAction;
+	};
+
+	// The actions of the blueprint are replaced too, they can't be used without its mapping context
+	TraversalMappingContext = NewObject<UInputMappingContext>(this, TEXT("DefaultTraversalMappingContext"), RF_Transient);
+	MoveAction = CreateAction(TEXT("DefaultMoveAction"), EInputActionValueType::Axis2D);
+	LookAction = CreateAction(TEXT("DefaultLookAction"), EInputActionValueType::Axis2D);
+	LookRateAction = CreateAction(TEXT("DefaultLookRateAction"), EInputActionValueType::Axis2D);
+	JumpAction = CreateAction(TEXT("DefaultJumpAction"), EInputActionValueType::Boolean);
+	ClimbUpAction = CreateAction(TEXT("DefaultClimbUpAction"), EInputActionValueType::Boolean);
+	DropDownAction = CreateAction(TEXT("DefaultDropDownAction"), EInputActionValueType::Boolean);
+	ToggleCoverAction = CreateAction(TEXT("DefaultToggleCoverAction"), EInputActionValueType::Boolean);
+	AimAction = CreateAction(TEXT("DefaultAimAction"), EInputActionValueType::Boolean);
+
+	// Move is X right and Y forward, see OnMoveAction
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::W, true, 1.f);
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::S, true, -1.f);
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::Up, true, 1.f);
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::Down, true, -1.f);
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::Gamepad_LeftY, true, 1.f);
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::A, false, -1.f);
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::D, false, 1.f);
+	MapAxisKey(TraversalMappingContext, MoveAction, EKeys::Gamepad_LeftX, false, 1.f);
+
+	// Look is X turn and Y pitch
+	MapAxisKey(TraversalMappingContext, LookAction, EKeys::MouseX, false, 1.f);
+	MapAxisKey(TraversalMappingContext, LookAction, EKeys::MouseY, true, -1.f);
+	MapAxisKey(TraversalMappingContext, LookRateAction, EKeys::Gamepad_RightX, false, 1.f);
+	MapAxisKey(TraversalMappingContext, LookRateAction, EKeys::Left, false, -1.f);
+	MapAxisKey(TraversalMappingContext, LookRateAction, EKeys::Right, false, 1.f);
+	MapAxisKey(TraversalMappingContext, LookRateAction, EKeys::Gamepad_RightY, true, 1.f);
+
+	TraversalMappingContext->MapKey(JumpAction, EKeys::SpaceBar);
+	TraversalMappingContext->MapKey(JumpAction, EKeys::Gamepad_FaceButton_Bottom);
+	TraversalMappingContext->MapKey(ClimbUpAction, EKeys::SpaceBar);
+	TraversalMappingContext->MapKey(ClimbUpAction, EKeys::Gamepad_LeftStick_Up);
+	TraversalMappingContext->MapKey(DropDownAction, EKeys::C);
+	TraversalMappingContext->MapKey(DropDownAction, EKeys::Gamepad_LeftStick_Down);
+	TraversalMappingContext->MapKey(ToggleCoverAction, EKeys::F);
+	TraversalMappingContext->MapKey(AimAction, EKeys::RightMouseButton);
+}
+
+void AThirdPersonDemoCharacter::OnMoveAction(const FInputActionValue& Value)
+{
+	// Enhanced input moves along X/Y, like the MoveRight/MoveForward axes
+	const FVector2D MoveValue = Value.Get<FVector2D>();
+	MoveInputValue = FVector2D(MoveValue.Y, MoveValue.X);
+}
+
+void AThirdPersonDemoCharacter::OnMoveActionCompleted(const FInputActionValue& Value)
+{
+	MoveInputValue = FVector2D::ZeroVector;
+}
+
+void AThirdPersonDemoCharacter::OnLookAction(const FInputActionValue& Value)
+{
+	const FVector2D LookValue = Value.Get<FVector2D>();
+	Turn(LookValue.X);
+	AddControllerPitchInput(LookValue.Y);
+}
+
+void AThirdPersonDemoCharacter::OnLookRateAction(const FInputActionValue& Value)
+{
+	const FVector2D LookValue = Value.Get<FVector2D>();
+	TurnAtRate(LookValue.X);
+	LookUpAtRate(LookValue.Y);
+}
+
+void AThirdPersonDemoCharacter::OnMoveForwardAxis(float Value)
 {
-	Super::BeginPlay();
+	MoveInputValue.X = Value;
+}
 
-	MaxJumpHeight = GetCharacterMovement()->GetMaxJumpHeight();
-	CameraBoomOriginalLength = CameraBoom->TargetArmLength;
-	RecalculateTargetCameraOffset();
+void AThirdPersonDemoCharacter::OnMoveRightAxis(float Value)
+{
+	MoveInputValue.Y = Value;
 }
 
-void AThirdPersonDemoCharacter::Tick(float DeltaSeconds)
+void AThirdPersonDemoCharacter::PressInputAction(const ETraversalInputAction::Type Action)
 {
-	Super::Tick(DeltaSeconds);
+	// A new press replaces an older buffered one
+	InputBuffer.Consume(Action);
 
-	Movecharacter();
-	TryUIHang();
-	TryHang();
-	TryEnterWallRun();
-	AdjustCameraOffset(DeltaSeconds);
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (HandleInputAction(Action, true))
+	{
+		InputBuffer.OnActed(Now);
+	}
+	else if (Action & ETraversalInputAction::Buffered)
+	{
+		InputBuffer.Buffer(Action, Now);
+	}
 }
 
-//////////////////////////////////////////////////////////////////////////
-// Input
-
-void AThirdPersonDemoCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
+void AThirdPersonDemoCharacter::FlushInputBuffer()
 {
-	// Set up gameplay key bindings
-	check(PlayerInputComponent);
-	PlayerInputComponent->BindAxis("MoveForward");
-	PlayerInputComponent->BindAxis("MoveRight");
-
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &AThirdPersonDemoCharacter::Jump);
-	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
-	PlayerInputComponent->BindAction("ClimbUp", IE_Pressed, this, &AThirdPersonDemoCharacter::TryClimbUp);
-	PlayerInputComponent->BindAction("DropDown", IE_Pressed, this, &AThirdPersonDemoCharacter::TryDropDown);
-	PlayerInputComponent->BindAction("ToggleCover", IE_Pressed, this, &AThirdPersonDemoCharacter::ToggleCover);
-	PlayerInputComponent->BindAction("Aim", IE_Pressed, this, &AThirdPersonDemoCharacter::StartAim);
-	PlayerInputComponent->BindAction("Aim", IE_Released, this, &AThirdPersonDemoCharacter::EndAim);
+	const double Now = GetWorld()->GetTimeSeconds();
+	const uint8 BufferedActions = InputBuffer.GetBufferedActions(Now, GetTraversalProfile().InputBufferTime);
+	if (BufferedActions == ETraversalInputAction::None) return;
 
-	// We have 2 versions of the rotation bindings to handle different kinds of devices differently
-	// "turn" handles devices that provide an absolute delta, such as a mouse.
-	// "turnrate" is for devices that we choose to treat as a rate of change, such as an analog joystick
-	PlayerInputComponent->BindAxis("Turn", this, &AThirdPersonDemoCharacter::Turn);
-	PlayerInputComponent->BindAxis("TurnRate", this, &AThirdPersonDemoCharacter::TurnAtRate);
-	PlayerInputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput);
-	PlayerInputComponent->BindAxis("LookUpRate", this, &AThirdPersonDemoCharacter::LookUpAtRate);
+	for (uint8 Action = ETraversalInputAction::Jump; Action <= ETraversalInputAction::ToggleCover; Action <<= 1)
+	{
+		if ((BufferedActions & Action) && HandleInputAction(static_cast<ETraversalInputAction::Type>(Action), true))
+		{
+			InputBuffer.ConsumeActed(static_cast<ETraversalInputAction::Type>(Action));
+			return;
+		}
+	}
 }
 
-void AThirdPersonDemoCharacter::Jump()
+bool AThirdPersonDemoCharacter::HandleInputAction(const ETraversalInputAction::Type Action, const bool bPressed)
 {
-	// If wallrunning, jump off wall at an angle
-	if (bIsWallRunning)
+	const ETraversalState PreviousState = TraversalState;
+
+	switch (Action)
 	{
-		GetCharacterMovement()->Velocity = RotateAngleZAxis(GetActorForwardVector(), !bIsRightWallRunning, 45.f) * WallRunMinJumpOffSpeed;
+	case ETraversalInputAction::Jump:
+		if (!bPressed)
+		{
+			StopJumping();
+			return true;
+		}
+		if (!CanJump()) return false;
+		Jump();
+		return true;
+	case ETraversalInputAction::ClimbUp:
+		if (bPressed) TryClimbUp();
+		break;
+	case ETraversalInputAction::DropDown:
+		if (bPressed) TryDropDown();
+		break;
+	case ETraversalInputAction::ToggleCover:
+		if (bPressed) ToggleCover();
+		break;
+	case ETraversalInputAction::Aim:
+		if (bPressed) StartAim(); else EndAim();
+		return true;
+	default:
+		return true;
 	}
 
-	Super::Jump();
+	// Traversal actions only took if they changed state
+	return !bPressed || TraversalState != PreviousState;
 }
 
 bool AThirdPersonDemoCharacter::CanJumpInternal_Implementation() const
 {
-	const bool bCanJump = bIsWallRunning || (!bIsHanging && !bIsClimbing && !bIsInCover && Super::CanJumpInternal_Implementation());
+	const bool bCanJump = TraversalState == ETraversalState::WallRunning || (TraversalState == ETraversalState::Default && Super::CanJumpInternal_Implementation());
 
 	return bCanJump;
 }
 
+void AThirdPersonDemoCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode /*= 0*/)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	// Simulated proxies get their state replicated
+	if (GetLocalRole() == ROLE_SimulatedProxy) return;
+
+	// Landing and jumping off the wall happen inside the movement component
+	const bool bWasWallRunning = PrevMovementMode == MOVE_Custom && PreviousCustomMode == static_cast<uint8>(ETraversalMovementMode::WallRun);
+	if (bWasWallRunning && TraversalState == ETraversalState::WallRunning)
+	{
+		SetTraversalState(ETraversalState::Default);
+	}
+}
+
 void AThirdPersonDemoCharacter::OnResetVR()
 {
 	// If ThirdPersonDemo is added to a project via 'Add Feature' in the Unreal Editor the dependency on HeadMountedDisplay in ThirdPersonDemo.Build.cs is not automatically propagated
@@ -147,80 +1144,32 @@ void AThirdPersonDemoCharacter::LookUpAtRate(float Rate)
 	AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds());
 }
 
-void AThirdPersonDemoCharacter::Movecharacter()
-{
-	if (Controller == nullptr) return;
-
-	// Get movement vector from inputs, rotate by controller yaw to get world direction, then normalise magnitude to 1
-	ControlMoveVector = FVector(GetInputAxisValue("MoveForward"), GetInputAxisValue("MoveRight"), 0.f);
-	ControlMoveVector = RotateAngleZAxis(ControlMoveVector, true, GetControlRotation().Yaw);
-	ControlMoveVector.Normalize();
-
-	// Get movement magnitude from vector
-	ControlMoveMagnitude = ControlMoveVector.Size();
-
-	if (bIsWallRunning)
-	{
-		MoveCharacterWallRun();
-	}
-	else
-	{
-		MoveCharacterDefault();
-	}
-}
-
-void AThirdPersonDemoCharacter::MoveCharacterDefault()
+void AThirdPersonDemoCharacter::ApplyTraversalMove(const FTraversalBatch& Batch, const int32 Index)
 {
-	if (bIsHanging || (bIsInCover && !bIsAiming)) return;
-	if (ControlMoveMagnitude == 0.0f) return;
-
-	// Clamp movement speed it if player is aiming when walking
-	if (bIsAiming && !GetCharacterMovement()->IsFalling()) 
-	{
-		ControlMoveMagnitude = FMath::Min(ControlMoveMagnitude, MaxAimMoveRate);
-	}
-	AddMovementInput(ControlMoveVector, ControlMoveMagnitude);
-		
-	if (!bIsAiming) return;
-
-	// Keep character facing front when walking while aiming
-	FRotator ActorRotation = GetActorRotation();
-	ActorRotation.Yaw = GetControlRotation().Yaw;
-	SetActorRotation(ActorRotation.Quaternion());
-
-	// If already popping out from cover, exit cover
-	if (bIsInCover) ExitCover();
-}
+	SCOPE_CYCLE_COUNTER(STAT_TraversalMoveCharacter);
 
-void AThirdPersonDemoCharacter::MoveCharacterWallRun()
-{
-	// If there is no more wall or the character touches the floor, exit wallrun
-	if (!TraceSideWallRun() || TraceDownWallRun())
+	const uint8 Decision = Batch.Decisions[Index];
+	if (Decision & ETraversalDecision::ExitWallRun)
 	{
 		ExitWallRun();
 		return;
 	}
 
-	// If there is no input in the wallrun direction, exit wallrun
-	FVector WallRunDirection = RotateAngleZAxis(TraceSideWallRunResult.Normal, bIsRightWallRunning);
-	if (ControlMoveMagnitude <= 0.1f || FVector::DotProduct(ControlMoveVector, WallRunDirection) <= 0.0f)
+	if (Decision & ETraversalDecision::Move)
 	{
-		ExitWallRun();
-		return;
+		AddMovementInput(Batch.MoveDirections[Index], Batch.MoveMagnitudes[Index]);
 	}
 
-	// If the character moves too slowly, exit wallrun
-	if (GetHorizontalVector(GetCharacterMovement()->Velocity).Size() < WallRunMinHorizontalSpeed)
+	// Keep character facing front when walking while aiming
+	if (Decision & ETraversalDecision::FaceControl)
 	{
-		ExitWallRun();
-		return;
+		FRotator ActorRotation = GetActorRotation();
+		ActorRotation.Yaw = GetControlRotation().Yaw;
+		SetActorRotation(ActorRotation.Quaternion());
 	}
 
-	float CorrectionAngle = (FVector::PointPlaneDist(GetActorLocation(), TraceSideWallRunResult.Location, TraceSideWallRunResult.Normal) - WallRunOffset) / 2;
-	WallRunDirection = RotateAngleZAxis(WallRunDirection, bIsRightWallRunning, CorrectionAngle);
-
-	//GEngine->AddOnScreenDebugMessage(-1, 999.f, FColor::Red, FString::Printf(TEXT("Offset Difference %f"), CorrectionAngle));
-	AddMovementInput(WallRunDirection, ControlMoveMagnitude);
+	// If already popping out from cover, exit cover
+	if (Decision & ETraversalDecision::ExitCover) ExitCover();
 }
 
 void AThirdPersonDemoCharacter::Turn(float Rate)
@@ -240,22 +1189,43 @@ void AThirdPersonDemoCharacter::Turn(float Rate)
 //////////////////////////////////////////////////////////////////////////
 // Camera Control
 
-void AThirdPersonDemoCharacter::AdjustCameraOffset(const float DeltaSeconds)
+void AThirdPersonDemoCharacter::PawnClientRestart()
 {
-	CameraBoom->SocketOffset = UKismetMathLibrary::VInterpTo(CameraBoom->SocketOffset, CameraOffset, DeltaSeconds, CameraOffsetSpeed);
-	CameraBoom->TargetArmLength = UKismetMathLibrary::FInterpTo(CameraBoom->TargetArmLength, CameraBoomLength, DeltaSeconds, CameraOffsetSpeed);
+	Super::PawnClientRestart();
+
+	// Clients don't go through PossessedBy
+	if (UTraversalTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UTraversalTickSubsystem>())
+	{
+		TickSubsystem->AddControllerPrerequisite(GetController());
+	}
+
+	const APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	APlayerCameraManager* CameraManager = PlayerController ? PlayerController->PlayerCameraManager : nullptr;
+	if (CameraManager != nullptr && CameraManager->FindCameraModifierByClass(UTraversalCameraModifier::StaticClass()) == nullptr)
+	{
+		CameraManager->AddNewCameraModifier(UTraversalCameraModifier::StaticClass());
+	}
+
+	// Map the traversal actions for the local player
+	UEnhancedInputLocalPlayerSubsystem* InputSubsystem = PlayerController ? ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()) : nullptr;
+	if (InputSubsystem != nullptr && TraversalMappingContext != nullptr)
+	{
+		InputSubsystem->AddMappingContext(TraversalMappingContext, 0);
+	}
 }
 
 void AThirdPersonDemoCharacter::RecalculateTargetCameraOffset()
 {
+	const UTraversalProfile& Profile = GetTraversalProfile();
+
 	if (bIsAiming)
 	{
-		CameraOffset = FVector(0.f, bIsRightCover ? CameraAimYOffset : -CameraAimYOffset, 0.f);
-		CameraBoomLength = CameraBoomAimLength;
+		CameraOffset = FVector(0.f, bIsRightCover ? Profile.CameraAimYOffset : -Profile.CameraAimYOffset, 0.f);
+		CameraBoomLength = Profile.CameraBoomAimLength;
 	}
-	else if (bIsInCover && bIsTallCover)
+	else if (TraversalState == ETraversalState::InCover && bIsTallCover)
 	{
-		CameraOffset = FVector(0.f, bIsRightCover ? CameraCoverYOffset : -CameraCoverYOffset, 0.f);
+		CameraOffset = FVector(0.f, bIsRightCover ? Profile.CameraCoverYOffset : -Profile.CameraCoverYOffset, 0.f);
 		CameraBoomLength = CameraBoomOriginalLength;
 	}
 	else
@@ -267,12 +1237,12 @@ void AThirdPersonDemoCharacter::RecalculateTargetCameraOffset()
 
 void AThirdPersonDemoCharacter::StartAim()
 {
-	if (bIsInCover)
+	if (TraversalState == ETraversalState::InCover)
 	{
 		FVector ActorLocation = GetActorLocation();
-		if (bIsTallCover) ActorLocation += RotateAngleZAxis(GetActorForwardVector(), !bIsRightCover) * CoverAimYOffset;
+		if (bIsTallCover) ActorLocation += RotateAngleZAxis(GetActorForwardVector(), !bIsRightCover) * GetTraversalProfile().CoverAimYOffset;
 
-		MoveCapsuleComponentTo(ActorLocation, GetCoverRotation() + FRotator(0.f, 180.f, 0.f));
+		TraversalMovement->InterpolateTo(ActorLocation, GetCoverRotation() + FRotator(0.f, 180.f, 0.f));
 	}
 	
 	//bUseControllerRotationYaw = true;
@@ -282,9 +1252,9 @@ void AThirdPersonDemoCharacter::StartAim()
 
 void AThirdPersonDemoCharacter::EndAim()
 {
-	if (bIsInCover)
+	if (TraversalState == ETraversalState::InCover)
 	{
-		MoveCapsuleComponentTo(GetCoverLocation(), GetCoverRotation());
+		TraversalMovement->InterpolateTo(GetCoverLocation(), GetCoverRotation());
 	}
 
 	bUseControllerRotationYaw = false;
@@ -297,37 +1267,122 @@ void AThirdPersonDemoCharacter::EndAim()
 
 void AThirdPersonDemoCharacter::TryUIHang()
 {
-	if (bIsInCover || GetCharacterMovement()->IsFalling()) return;
+	SCOPE_CYCLE_COUNTER(STAT_TraversalTryUIHang);
+
+	// No indicator to show, e.g. on dedicated servers, so no need to look for ledges
+	if (ClimbUIClass.Get() == nullptr) return;
+
+	const UTraversalProfile& Profile = GetTraversalProfile();
 
-	bool bCanShowHangUI = !bIsHanging && TraceUpClimb(true) && TraceForwardClimb(true) && UKismetMathLibrary::InRange_FloatFloat(TraceUpClimbResult.Location.Z - GetActorLocation().Z, ClimbUpMinDistance, ClimbUpMaxDistance + MaxJumpHeight);
+	if (GetCharacterMovement()->IsFalling())
+	{
+		// Drop any in-flight results so they are not consumed once the character is back on the ground
+		ClearUIHangOverlap();
+		return;
+	}
+
+	// Same ledges TryHang finds, so the indicator never shows one the character can't hang from.
+	// Static ledges come straight from the baked index. Otherwise reuse the last scan while nothing it saw has moved,
+	// or run the ray fan on the overlap issued last frame. The indicator is cosmetic so a frame of latency is fine
+	const bool bIndexedLedge = FindBakedLedge();
+	bool bHasLedge = bIndexedLedge;
+	bool bNeedsOverlap = !bIndexedLedge;
+	if (!bIndexedLedge)
+	{
+		if (const FTraversalLedgeScanEntry* CoherentScan = ProbeCache.FindCoherentLedgeScan(MakeLedgeScanSettings()))
+		{
+			bHasLedge = CoherentScan->bFound;
+			LedgeProfile = CoherentScan->Profile;
+			bNeedsOverlap = false;
+		}
+		else if (bUIHangOverlapsReady)
+		{
+			bHasLedge = TraversalLedgeScanner::ScanOverlaps(this, UIHangScanSettings, UIHangOverlaps, LedgeProfile);
+			ProbeCache.StoreLedgeScan(UIHangScanSettings, UIHangOverlaps, bHasLedge, LedgeProfile);
+			bUIHangOverlapsReady = false;
+		}
+		else
+		{
+			// Nothing to go on until the overlap issued below comes back, keep showing what was shown
+			RequestUIHangOverlap();
+			return;
+		}
+	}
+	const bool bCanShowHangUI = bHasLedge && UKismetMathLibrary::InRange_FloatFloat(LedgeProfile.LipLocation.Z - GetActorLocation().Z, Profile.ClimbUpMinDistance, Profile.ClimbUpMaxDistance + MaxJumpHeight);
 
 	// If there is a climbable object in range, show the UI Actor
 	if (bCanShowHangUI)
 	{
-		// If UI Actor doesn't exist, spawn it. If not, move the existing on to the new location
-		FVector UILocation = TraceForwardClimbResult.Location;
-		UILocation.Z = TraceUpClimbResult.Location.Z;
-		UILocation = UILocation - TraceForwardClimbResult.Normal * TraceOffset;
+		// If UI Actor isn't shown, take one from the pool. If not, move the existing one to the new location
+		const FVector UILocation = LedgeProfile.LipLocation - LedgeProfile.WallNormal * Profile.TraceOffset;
+		const FRotator UIRotation = LedgeProfile.WallNormal.Rotation();
 
 		if (CurrentClimbUI == nullptr)
 		{
-			const FRotator UIRotation = TraceForwardClimbResult.Normal.Rotation();
-			CurrentClimbUI = GetWorld()->SpawnActor<AActor>(ClimbUIClass, UILocation, UIRotation);
+			CurrentClimbUI = GetWorld()->GetSubsystem<UTraversalActorPoolSubsystem>()->Acquire(ClimbUIClass.Get(), UILocation, UIRotation);
 		}
 		else
 		{
-			CurrentClimbUI->SetActorLocation(UILocation);
+			CurrentClimbUI->SetActorLocationAndRotation(UILocation, UIRotation);
 		}
 	}
-	// If there is no climbable object, remove the current UI Actor if it exists
+	// If there is no climbable object, return the current UI Actor to the pool if it exists
 	else
 	{
-		if (CurrentClimbUI != nullptr)
-		{
-			CurrentClimbUI->Destroy();
-			CurrentClimbUI = nullptr;
-		}
+		HideClimbUI();
+	}
+
+	if (!bNeedsOverlap)
+	{
+		// No need for the scene query while the index has a ledge in range or the last scan still holds
+		ClearUIHangOverlap();
+		return;
+	}
+
+	RequestUIHangOverlap();
+}
+
+void AThirdPersonDemoCharacter::RequestUIHangOverlap()
+{
+	if (!UIHangOverlapDelegate.IsBound())
+	{
+		UIHangOverlapDelegate.BindUObject(this, &AThirdPersonDemoCharacter::OnUIHangOverlapDone);
+	}
+
+	// Same overlap the synchronous ledge scan starts with, so the indicator agrees with TryHang
+	UIHangScanSettings = MakeLedgeScanSettings();
+	const FTraversalLedgeScanQuery Query = TraversalLedgeScanner::MakeQuery(this, UIHangScanSettings);
+
+	INC_DWORD_STAT(STAT_TraversalAsyncTraces);
+	++GTraversalTraceCount;
+	UIHangOverlapHandle = GetWorld()->AsyncOverlapByChannel(Query.Center, Query.Rotation, Query.Channel, Query.Shape, Query.QueryParams, FCollisionResponseParams::DefaultResponseParam, &UIHangOverlapDelegate);
+}
+
+void AThirdPersonDemoCharacter::OnUIHangOverlapDone(const FTraceHandle& TraceHandle, FOverlapDatum& OverlapDatum)
+{
+	// Results of an overlap issued before the last ClearUIHangOverlap are dropped
+	if (TraceHandle != UIHangOverlapHandle) return;
+
+	UIHangOverlaps = MoveTemp(OverlapDatum.OutOverlaps);
+	bUIHangOverlapsReady = true;
+}
+
+void AThirdPersonDemoCharacter::ClearUIHangOverlap()
+{
+	UIHangOverlapHandle = FTraceHandle();
+	UIHangOverlaps.Reset();
+	bUIHangOverlapsReady = false;
+}
+
+void AThirdPersonDemoCharacter::HideClimbUI()
+{
+	if (CurrentClimbUI == nullptr) return;
+
+	if (UTraversalActorPoolSubsystem* ActorPool = GetWorld()->GetSubsystem<UTraversalActorPoolSubsystem>())
+	{
+		ActorPool->Release(CurrentClimbUI);
 	}
+	CurrentClimbUI = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -335,53 +1390,82 @@ void AThirdPersonDemoCharacter::TryUIHang()
 
 void AThirdPersonDemoCharacter::TryHang()
 {
+	SCOPE_CYCLE_COUNTER(STAT_TraversalTryHang);
+
 	// Return if character is not in the right state for wall hang or no ledge is available
-	if (!(GetCharacterMovement()->IsFalling()) || bIsWallRunning || bIsHanging || !TraceUpClimb() || !TraceForwardClimb()) return;
+	if (!(GetCharacterMovement()->IsFalling())) return;
 
-	// Return if ledge is not within the right height range
-	if (!UKismetMathLibrary::InRange_FloatFloat(TraceUpClimbResult.Location.Z - GetActorLocation().Z, ClimbUpMinDistance, ClimbUpMaxDistance)) return;
+	FVector HangLocation;
+	FRotator HangRotation;
+	if (!FindHang(HangLocation, HangRotation) || !SetTraversalState(ETraversalState::Hanging)) return;
+
+	TraversalMovement->EnterTraversalMode(ETraversalMovementMode::Hang, HangLocation, HangRotation);
+}
 
-	bIsHanging = true;
-	GetCharacterMovement()->SetMovementMode(MOVE_Flying);
-	GetCharacterMovement()->StopMovementImmediately();
+bool AThirdPersonDemoCharacter::FindHang(FVector& OutLocation, FRotator& OutRotation)
+{
+	const UTraversalProfile& Profile = GetTraversalProfile();
+
+	if (!ScanLedge()) return false;
 
-	FVector HangLocation = TraceForwardClimbResult.Location + TraceForwardClimbResult.Normal * HangHorizontalOffset;
-	HangLocation.Z = TraceUpClimbResult.Location.Z - HangVerticalOffset;
-	const FRotator HangRotation = UKismetMathLibrary::MakeRotFromX(TraceForwardClimbResult.Normal * -1);
+	// Return if ledge is not within the right height range
+	if (!UKismetMathLibrary::InRange_FloatFloat(LedgeProfile.LipLocation.Z - GetActorLocation().Z, Profile.ClimbUpMinDistance, Profile.ClimbUpMaxDistance)) return false;
 
-	MoveCapsuleComponentTo(HangLocation, HangRotation);
+	OutLocation = LedgeProfile.WallLocation + LedgeProfile.WallNormal * Profile.HangHorizontalOffset;
+	OutLocation.Z = LedgeProfile.LipLocation.Z - Profile.HangVerticalOffset;
+	OutRotation = UKismetMathLibrary::MakeRotFromX(LedgeProfile.WallNormal * -1);
+	return true;
 }
 
 void AThirdPersonDemoCharacter::TryClimbUp()
 {
-	if (bIsClimbing || !bIsHanging) return;
+	if (TraversalState != ETraversalState::Hanging) return;
+
+	SetTraversalState(ETraversalState::Climbing);
+	TraversalMovement->SetMovementMode(MOVE_Custom, static_cast<uint8>(ETraversalMovementMode::ClimbUp));
 
-	// Play climbing animation montage and set timer for "callback" when animation ends
-	const float AnimDuration = PlayAnimMontage(ClimbMontage);
-	FTimerHandle ClimbUpTimerHandle;
-	GetWorldTimerManager().SetTimer(ClimbUpTimerHandle, this, &AThirdPersonDemoCharacter::OnClimbUpFinished, AnimDuration - ClimbMontage->BlendOutTriggerTime);
-	bIsClimbing = true;
-	//GEngine->AddOnScreenDebugMessage(-1, 999.f, FColor::Red, FString::Printf(TEXT("Moving in %f"), AnimDuration - ClimbMontage->BlendOutTriggerTime));
+	// Play climbing animation montage and finish when it blends out, so play rate and frame rate are followed.
+	// The server waits for remote players to finish climbing in their moves instead
+	UAnimMontage* Montage = ClimbMontage.Get();
+	const float AnimDuration = PlayAnimMontage(Montage);
+	if (!IsTraversalLocallyPredicted()) return;
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimDuration <= 0.f || AnimInstance == nullptr)
+	{
+		// Nothing to wait for, e.g. without a mesh in headless runs
+		OnClimbUpFinished();
+		return;
+	}
+
+	FOnMontageBlendingOutStarted BlendingOutDelegate = FOnMontageBlendingOutStarted::CreateUObject(this, &AThirdPersonDemoCharacter::OnClimbMontageBlendingOut);
+	AnimInstance->Montage_SetBlendingOutDelegate(BlendingOutDelegate, Montage);
+}
+
+void AThirdPersonDemoCharacter::OnClimbMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted)
+{
+	// Interrupted climbs finish too, the character would otherwise be left in the climb state
+	OnClimbUpFinished();
 }
 
 void AThirdPersonDemoCharacter::OnClimbUpFinished()
 {
-	// Move the character forward after climbing
+	if (TraversalState != ETraversalState::Climbing) return;
+
+	// Move the character forward after climbing, the movement component walks once there
 	const FVector EndLocation = GetActorLocation() + GetActorForwardVector() * 30.f;
-	MoveCapsuleComponentTo(EndLocation, GetActorRotation());
+	TraversalMovement->FinishClimbUp(EndLocation, GetActorRotation());
 
-	bIsHanging = false;
-	bIsClimbing = false;
-	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+	SetTraversalState(ETraversalState::Default);
 }
 
 void AThirdPersonDemoCharacter::TryDropDown()
 {
-	if (!bIsHanging || bIsClimbing) return;
+	if (TraversalState != ETraversalState::Hanging) return;
 
 	// Exit hang animation and set state to falling
-	GetCharacterMovement()->SetMovementMode(MOVE_Falling);
-	bIsHanging = false;
+	TraversalMovement->SetMovementMode(MOVE_Falling);
+	SetTraversalState(ETraversalState::Default);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -389,28 +1473,43 @@ void AThirdPersonDemoCharacter::TryDropDown()
 
 void AThirdPersonDemoCharacter::TryEnterWallRun()
 {
-	// Return if character is not in the air or already wallrunning
-	if (!GetCharacterMovement()->IsFalling() || bIsWallRunning ) return;
+	SCOPE_CYCLE_COUNTER(STAT_TraversalTryEnterWallRun);
+
+	// Return if character landed or grabbed a ledge since the wall was found
+	if (!GetCharacterMovement()->IsFalling() || !CanTransitionTraversalState(TraversalState, ETraversalState::WallRunning)) return;
+
+	EnterWallRun();
+}
 
-	// Return if character is falling too fast or horizontal move speed is too slow for wallrun
-	const FVector HorizontalVector = GetHorizontalVector(GetCharacterMovement()->Velocity);
-	const float VerticalVelocity = GetCharacterMovement()->Velocity.Z;
-	if (HorizontalVector.Size() < WallRunMinHorizontalSpeed || VerticalVelocity < WallRunMinVerticalVelocity) return;
+void AThirdPersonDemoCharacter::EnterWallRun()
+{
+	const UTraversalProfile& Profile = GetTraversalProfile();
 
-	// Return if there is no available wall or player is not controlling character to move in the same direction as the wallrun
-	FVector WallRunDirection = RotateAngleZAxis(TraceSideWallRunResult.Normal, bIsRightWallRunning);
-	if (!TraceSideWallRun() || ControlMoveMagnitude <= 0.1f || FVector::DotProduct(ControlMoveVector, WallRunDirection) <= 0.0f) return;
+	if (!SetTraversalState(ETraversalState::WallRunning)) return;
 
 	// Set appropriate initial Z velocity and gravity scale for wallrun
-	GetCharacterMovement()->GravityScale = WallRunMinGravityScale;
-	GetCharacterMovement()->Velocity.Z *= WallRunVerticalSpeedMultiplier;
-	bIsWallRunning = true;
+	TraversalMovement->StartWallRun(Profile.WallRunMinGravityScale);
+	TraversalMovement->Velocity.Z *= Profile.WallRunVerticalSpeedMultiplier;
 }
 
 void AThirdPersonDemoCharacter::ExitWallRun()
 {
-	GetCharacterMovement()->GravityScale = 1.f;
-	bIsWallRunning = false;
+	SetTraversalState(ETraversalState::Default);
+	if (TraversalMovement->IsInTraversalMode(ETraversalMovementMode::WallRun))
+	{
+		TraversalMovement->SetMovementMode(MOVE_Falling);
+	}
+}
+
+bool AThirdPersonDemoCharacter::HasWallRunWall(const bool bRightWall)
+{
+	// Same side probe as the traversal kernel plans
+	const FVector TraceStart = GetActorLocation() + FVector::DownVector * GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+	const float Reach = GetTraversalProfile().WallRunSideDistance + CVarTraversalNetAnchorTolerance.GetValueOnGameThread();
+	const FVector TraceEnd = TraceStart + TraversalMath::RotateAboutZ90(GetActorForwardVector(), bRightWall) * Reach;
+
+	FHitResult HitResult;
+	return DoLineTraceCheck(TraceStart, TraceEnd, HitResult);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -418,9 +1517,9 @@ void AThirdPersonDemoCharacter::ExitWallRun()
 
 void AThirdPersonDemoCharacter::ToggleCover()
 {
-	if (GetCharacterMovement()->MovementMode != EMovementMode::MOVE_Walking) return;
+	if (!TraversalMovement->IsMovingOnGround() && !TraversalMovement->IsInTraversalMode(ETraversalMovementMode::Cover)) return;
 
-	if (!bIsInCover)
+	if (TraversalState != ETraversalState::InCover)
 	{
 		TryEnterCover();
 	}
@@ -431,9 +1530,33 @@ void AThirdPersonDemoCharacter::ToggleCover()
 }
 
 void AThirdPersonDemoCharacter::TryEnterCover()
+{
+	// Don't probe for cover from states that can't take it, or away from traversable cover
+	if (!CanTransitionTraversalState(TraversalState, ETraversalState::InCover)) return;
+	if (!HasCoverCandidate())
+	{
+		INC_DWORD_STAT(STAT_TraversalProximityCulledChecks);
+		return;
+	}
+
+	FVector CoverLocation;
+	FRotator CoverRotation;
+	if (!FindCover(CoverLocation, CoverRotation)) return;
+
+	// Ideally play an animation of getting into cover but it's a little janky right now
+	/*
+	const float AnimDuration = PlayAnimMontage(EnterCoverRightMontage);
+	FTimerHandle CoverTimerHandle;
+	GetWorldTimerManager().SetTimer(CoverTimerHandle, this, &AThirdPersonDemoCharacter::OnEnterCoverFinished, AnimDuration - EnterCoverRightMontage->BlendOutTriggerTime);
+	*/
+
+	EnterCover(CoverLocation, CoverRotation);
+}
+
+bool AThirdPersonDemoCharacter::FindCover(FVector& OutLocation, FRotator& OutRotation)
 {
 	// Check if there is a valid wall in front of the player to take cover against
-	if (!TraceForwardCover()) return;
+	if (!TraceForwardCover()) return false;
 
 	// Get the angle of the line trace against the wall to determine if peeking out of the left or right cover
 	const FVector2D CharacterForwardVector = FVector2D(GetActorForwardVector().X, GetActorForwardVector().Y);
@@ -446,143 +1569,305 @@ void AThirdPersonDemoCharacter::TryEnterCover()
 	if (bIsTallCover && !TraceSideCover())
 	{
 		bIsRightCover = !bIsRightCover;
-		if (!TraceSideCover()) return;
+		if (!TraceSideCover()) return false;
 	}
 
-	// Ideally play an animation of getting into cover but it's a little janky right now
-	/*
-	const float AnimDuration = PlayAnimMontage(EnterCoverRightMontage);
-	FTimerHandle CoverTimerHandle;
-	GetWorldTimerManager().SetTimer(CoverTimerHandle, this, &AThirdPersonDemoCharacter::OnEnterCoverFinished, AnimDuration - EnterCoverRightMontage->BlendOutTriggerTime);
-	*/
+	OutLocation = GetCoverLocation();
+	OutRotation = GetCoverRotation();
+	return true;
+}
+
+void AThirdPersonDemoCharacter::EnterCover(const FVector& CoverLocation, const FRotator& CoverRotation)
+{
+	// Set the cover state and move character to cover location
+	if (!SetTraversalState(ETraversalState::InCover)) return;
 
-	// Set the booleans for cover state and move character to cover location
-	bIsInCover = true;
 	bIsAiming = false;
-	MoveCapsuleComponentTo(GetCoverLocation(), GetCoverRotation());
+	TraversalMovement->EnterTraversalMode(ETraversalMovementMode::Cover, CoverLocation, CoverRotation);
 	RecalculateTargetCameraOffset();
 }
 
 void AThirdPersonDemoCharacter::ExitCover()
 {
-	bIsInCover = false;
+	SetTraversalState(ETraversalState::Default);
+	if (TraversalMovement->IsInTraversalMode(ETraversalMovementMode::Cover))
+	{
+		TraversalMovement->SetMovementMode(MOVE_Walking);
+	}
 	RecalculateTargetCameraOffset();
 }
 
 //////////////////////////////////////////////////////////////////////////
 // Line Trace Functions
 
-bool AThirdPersonDemoCharacter::TraceUpClimb(const bool bDisableDraw /*= false*/)
+bool AThirdPersonDemoCharacter::ScanLedge()
 {
-	// Check if there is a platform of the right height in front of the player to hang on
-	const FVector TraceEnd = GetActorLocation() + GetActorForwardVector() * ClimbForwardDistance + FVector::UpVector * ClimbUpMinDistance;
-	const FVector TraceStart = TraceEnd + FVector::UpVector * (ClimbUpMaxDistance + MaxJumpHeight);
+	// Static ledges come from the baked index
+	if (FindBakedLedge()) return true;
 
-	return DoLineTraceCheck(TraceStart, TraceEnd, TraceUpClimbResult, bDisableDraw);
+	// Check if there is a platform of the right height and distance in front of the player to hang on
+	return TraversalLedgeScanner::Scan(this, MakeLedgeScanSettings(), LedgeProfile);
 }
 
-bool AThirdPersonDemoCharacter::TraceForwardClimb(const bool bDisableDraw /*= false*/)
+bool AThirdPersonDemoCharacter::FindBakedLedge()
 {
-	// Check if there is a platform of the right distance in front of the player to hang on
-	const FVector TraceStart = FVector(GetActorLocation().X, GetActorLocation().Y, TraceUpClimbResult.Location.Z - TraceOffset * 2);
-	const FVector TraceEnd = TraceStart + GetActorForwardVector() * ClimbForwardDistance;
+	ActiveEdgeIndex = FindEdgeIndex();
+	FTraversalProbeHit IndexedUpResult, IndexedForwardResult;
+	if (!FindIndexedLedge(ActiveEdgeIndex, IndexedUpResult, IndexedForwardResult)) return false;
+
+	LedgeProfile = FTraversalLedgeProfile();
+	LedgeProfile.WallLocation = IndexedForwardResult.Location;
+	LedgeProfile.WallNormal = IndexedForwardResult.Normal;
+	LedgeProfile.LipLocation = FVector(IndexedForwardResult.Location.X, IndexedForwardResult.Location.Y, IndexedUpResult.Location.Z);
+	return true;
+}
 
-	return DoLineTraceCheck(TraceStart, TraceEnd, TraceForwardClimbResult, bDisableDraw);
+FTraversalLedgeScanSettings AThirdPersonDemoCharacter::MakeLedgeScanSettings() const
+{
+	const UTraversalProfile& Profile = GetTraversalProfile();
+
+	// With an index only geometry it does not describe is left to find
+	FTraversalLedgeScanSettings Settings;
+	Settings.Origin = GetActorLocation();
+	Settings.Forward = TraversalMath::GetHorizontal(GetActorForwardVector()).GetSafeNormal();
+	Settings.ForwardDistance = Profile.ClimbForwardDistance;
+	Settings.MinHeight = Profile.ClimbUpMinDistance;
+	Settings.MaxHeight = Profile.ClimbUpMinDistance + Profile.ClimbUpMaxDistance + MaxJumpHeight;
+	Settings.LipInset = Profile.TraceOffset * 2;
+	Settings.DepthReach = Profile.LedgeScanDepthReach;
+	Settings.ClearanceReach = Profile.LedgeScanClearanceReach;
+	Settings.NumVerticalRays = Profile.LedgeScanVerticalRays;
+	Settings.NumHorizontalRays = Profile.LedgeScanHorizontalRays;
+	Settings.bSkipBaked = ActiveEdgeIndex != nullptr;
+	Settings.bDrawDebug = bDrawDebug;
+	return Settings;
 }
 
-bool AThirdPersonDemoCharacter::TraceSideWallRun()
+bool AThirdPersonDemoCharacter::TraceForwardCover()
 {
-	const FVector TraceStart = GetActorLocation() + FVector::DownVector * GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
-	FVector TraceEnd;
+	const UTraversalProfile& Profile = GetTraversalProfile();
 
-	// If already wallrunning, keep checking if a wall is available on the current side
-	if (bIsWallRunning)
+	// Static cover comes from the baked index. With an index only geometry it does not describe is left to trace
+	ActiveEdgeIndex = FindEdgeIndex();
+	IndexedCoverFace = FTraversalEdgeHit();
+	const bool bSkipBaked = ActiveEdgeIndex != nullptr;
+
+	// First check for tall wall cover
+	FVector TraceStart = GetActorLocation() + FVector::UpVector * GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+	FVector TraceEnd = TraceStart + GetActorForwardVector() * Profile.CoverForwardDistance;
+	bIsTallCover = true;
+	if (ActiveEdgeIndex && ActiveEdgeIndex->FindCoverFace(TraceStart, GetActorForwardVector(), Profile.CoverForwardDistance, IndexedCoverFace))
+	{
+		TraceForwardCoverResult = FTraversalProbeHit(IndexedCoverFace.Location, IndexedCoverFace.Normal);
+		return true;
+	}
+	if (DoProbeTraceCheck(ETraversalProbe::ForwardCoverTall, TraceStart, TraceEnd, TraceForwardCoverResult, false, bSkipBaked))
 	{
-		TraceEnd = TraceStart + RotateAngleZAxis(GetActorForwardVector(), bIsRightWallRunning) * WallRunSideDistance;
-		return DoLineTraceCheck(TraceStart, TraceEnd, TraceSideWallRunResult);
+		return true;
 	}
 
-	// If not already wallrunning, first check for a wall on the right side
-	TraceEnd = TraceStart + RotateAngleZAxis(GetActorForwardVector(), true) * WallRunSideDistance;
-	if (DoLineTraceCheck(TraceStart, TraceEnd, TraceSideWallRunResult))
+	// If no tall cover is available, check for a short wall cover
+	bIsTallCover = false;
+	TraceStart = GetActorLocation();
+	TraceEnd = TraceStart + GetActorForwardVector() * Profile.CoverForwardDistance;
+	if (ActiveEdgeIndex && ActiveEdgeIndex->FindCoverFace(TraceStart, GetActorForwardVector(), Profile.CoverForwardDistance, IndexedCoverFace))
 	{
-		bIsRightWallRunning = true;
+		TraceForwardCoverResult = FTraversalProbeHit(IndexedCoverFace.Location, IndexedCoverFace.Normal);
 		return true;
 	}
+	return DoProbeTraceCheck(ETraversalProbe::ForwardCoverShort, TraceStart, TraceEnd, TraceForwardCoverResult, false, bSkipBaked);
+}
+
+bool AThirdPersonDemoCharacter::TraceSideCover()
+{
+	const UTraversalProfile& Profile = GetTraversalProfile();
+
+	// Check where the wall cover ends
+	const FVector SideDirection = RotateAngleZAxis(TraceForwardCoverResult.Normal, !bIsRightCover);
+	const FVector TraceEnd = TraceForwardCoverResult.Location - TraceForwardCoverResult.Normal * Profile.TraceOffset;
+	const FVector TraceStart = TraceEnd + SideDirection * Profile.CoverSideDistance;
 
-	// If no wall on the right side is available, check the left side
-	TraceEnd = TraceStart + RotateAngleZAxis(GetActorForwardVector(), false) * WallRunSideDistance;
-	bIsRightWallRunning = false;
-	return DoLineTraceCheck(TraceStart, TraceEnd, TraceSideWallRunResult);
+	// Baked cover faces know their exposed corners
+	FTraversalEdgeHit CornerHit;
+	if (ActiveEdgeIndex && ActiveEdgeIndex->FindCoverCorner(IndexedCoverFace, SideDirection, Profile.CoverSideDistance, CornerHit))
+	{
+		TraceSideCoverResult = FTraversalProbeHit(CornerHit.Location - TraceForwardCoverResult.Normal * Profile.TraceOffset, CornerHit.Normal);
+		return true;
+	}
 
+	const ETraversalProbe SideProbe = bIsRightCover ? ETraversalProbe::SideCoverRight : ETraversalProbe::SideCoverLeft;
+	return DoProbeTraceCheck(SideProbe, TraceStart, TraceEnd, TraceSideCoverResult, false, ActiveEdgeIndex != nullptr);
 }
 
-bool AThirdPersonDemoCharacter::TraceDownWallRun()
+//////////////////////////////////////////////////////////////////////////
+// Helper Functions
+
+bool AThirdPersonDemoCharacter::DoLineTraceCheck(const FVector TraceStart, const FVector TraceEnd, FHitResult& OutHit, const bool bSkipBaked /*= false*/)
 {
-	const FVector TraceStart = GetActorLocation();
-	const FVector TraceEnd = TraceStart + FVector::DownVector * (GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + 5.f);
-	FHitResult HitResult;
+	SCOPE_CYCLE_COUNTER(STAT_TraversalLineTrace);
+	INC_DWORD_STAT(STAT_TraversalTraces);
+	++GTraversalTraceCount;
 
-	return DoLineTraceCheck(TraceStart, TraceEnd, HitResult);
+	if (!UKismetSystemLibrary::LineTraceSingle(GetWorld(), TraceStart, TraceEnd, TraceTypeQuery_MAX, false, { this }, EDrawDebugTrace::None, OutHit, true)) return false;
+
+	// The baked edge index already answered for its components. Anything behind them is out of reach anyway
+	if (bSkipBaked)
+	{
+		const UTraversalEdgeIndexSubsystem* EdgeIndexSubsystem = GetWorld()->GetSubsystem<UTraversalEdgeIndexSubsystem>();
+		if (EdgeIndexSubsystem != nullptr && EdgeIndexSubsystem->IsBaked(OutHit.GetComponent()))
+		{
+			OutHit = FHitResult(TraceStart, TraceEnd);
+			return false;
+		}
+	}
+	return true;
 }
 
-bool AThirdPersonDemoCharacter::TraceForwardCover()
+bool AThirdPersonDemoCharacter::DoProbeTraceCheck(const ETraversalProbe Probe, const FVector TraceStart, const FVector TraceEnd, FTraversalProbeHit& OutHit, const bool bDisableDraw /*= false*/, const bool bSkipBaked /*= false*/)
 {
-	// First check for tall wall cover
-	FVector TraceStart = GetActorLocation() + FVector::UpVector * GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
-	FVector TraceEnd = TraceStart + GetActorForwardVector() * CoverForwardDistance;
-	if (DoLineTraceCheck(TraceStart, TraceEnd, TraceForwardCoverResult))
+	// Reuse the result if another consumer already ran this probe this frame
+	if (const FTraversalProbeEntry* CachedEntry = ProbeCache.Find(Probe, TraceStart, TraceEnd))
 	{
-		bIsTallCover = true;
+		INC_DWORD_STAT(STAT_TraversalCachedProbes);
+		OutHit = CachedEntry->Hit;
+		return CachedEntry->bHit;
+	}
+
+	// Reuse an earlier hit on static geometry if the probe has barely moved since
+	const FTraversalProbeEntry* CoherentEntry = ProbeCache.FindCoherent(Probe, TraceStart, TraceEnd);
+	if (CoherentEntry != nullptr)
+	{
+		ProbeCache.Refresh(Probe, TraceStart, TraceEnd);
+		OutHit = CoherentEntry->Hit;
 		return true;
 	}
 
-	// If no tall cover is available, check for a short wall cover
-	bIsTallCover = false;
-	TraceStart = GetActorLocation();
-	TraceEnd = TraceStart + GetActorForwardVector() * CoverForwardDistance;
-	return DoLineTraceCheck(TraceStart, TraceEnd, TraceForwardCoverResult);
+	FHitResult HitResult;
+	const bool bHit = DoLineTraceCheck(TraceStart, TraceEnd, HitResult, bSkipBaked);
+	OutHit = FTraversalProbeHit(HitResult);
+	ProbeCache.Store(Probe, TraceStart, TraceEnd, bHit, OutHit);
+
+#if WITH_TRAVERSAL_DEBUG
+	TraversalDebug::RecordProbe(this, Probe, TraceStart, TraceEnd, bHit, HitResult.ImpactPoint, bDrawDebug && !bDisableDraw);
+#endif
+	return bHit;
 }
 
-bool AThirdPersonDemoCharacter::TraceSideCover()
+void AThirdPersonDemoCharacter::GetUpClimbTrace(FVector& OutTraceStart, FVector& OutTraceEnd) const
 {
-	// Check where the wall cover ends
-	const FVector TraceEnd = TraceForwardCoverResult.Location - TraceForwardCoverResult.Normal * TraceOffset;
-	const FVector TraceStart = TraceEnd + RotateAngleZAxis(TraceForwardCoverResult.Normal, !bIsRightCover) * CoverSideDistance;
-
-	return DoLineTraceCheck(TraceStart, TraceEnd, TraceSideCoverResult);
+	const UTraversalProfile& Profile = GetTraversalProfile();
+	OutTraceEnd = GetActorLocation() + GetActorForwardVector() * Profile.ClimbForwardDistance + FVector::UpVector * Profile.ClimbUpMinDistance;
+	OutTraceStart = OutTraceEnd + FVector::UpVector * (Profile.ClimbUpMaxDistance + MaxJumpHeight);
 }
 
-//////////////////////////////////////////////////////////////////////////
-// Helper Functions
+const UTraversalEdgeIndex* AThirdPersonDemoCharacter::FindEdgeIndex() const
+{
+	const UTraversalEdgeIndexSubsystem* EdgeIndexSubsystem = GetWorld()->GetSubsystem<UTraversalEdgeIndexSubsystem>();
+	return EdgeIndexSubsystem ? EdgeIndexSubsystem->FindIndex(GetActorLocation()) : nullptr;
+}
 
-bool AThirdPersonDemoCharacter::DoLineTraceCheck(const FVector TraceStart, const FVector TraceEnd, FHitResult& OutHit, const bool bDisableDraw /*= false*/)
+bool AThirdPersonDemoCharacter::FindIndexedLedge(const UTraversalEdgeIndex* EdgeIndex, FTraversalProbeHit& OutUpResult, FTraversalProbeHit& OutForwardResult) const
 {
-	const EDrawDebugTrace::Type DrawMode = (bDrawDebug && !bDisableDraw) ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None;
-	return UKismetSystemLibrary::LineTraceSingle(GetWorld(), TraceStart, TraceEnd, TraceTypeQuery_MAX, false, { this }, DrawMode, OutHit, true);
+	const UTraversalProfile& Profile = GetTraversalProfile();
+
+	if (EdgeIndex == nullptr) return false;
+
+	// Look for a lip crossed by the forward probe within the height range of the downward probe
+	FVector UpTraceStart, UpTraceEnd;
+	GetUpClimbTrace(UpTraceStart, UpTraceEnd);
+
+	FTraversalEdgeHit LedgeHit;
+	if (!EdgeIndex->FindLedge(GetActorLocation(), GetActorForwardVector(), Profile.ClimbForwardDistance, UpTraceEnd.Z, UpTraceStart.Z, LedgeHit)) return false;
+
+	// Fill the results the way the downward and forward ledge probes would have
+	OutUpResult = FTraversalProbeHit(FVector(UpTraceEnd.X, UpTraceEnd.Y, LedgeHit.Location.Z), FVector::UpVector);
+
+	const float ForwardTraceZ = LedgeHit.Location.Z - Profile.TraceOffset * 2;
+	OutForwardResult = FTraversalProbeHit(FVector(LedgeHit.Location.X, LedgeHit.Location.Y, ForwardTraceZ), LedgeHit.Normal);
+
+	return true;
 }
 
-void AThirdPersonDemoCharacter::MoveCapsuleComponentTo(const FVector TargetLocation, const FRotator TargetRotation, const float OverTime /*= 0.2f*/)
+FVector AThirdPersonDemoCharacter::GetWallRunJumpOffVelocity() const
 {
-	FLatentActionInfo LatentActionInfo;
-	LatentActionInfo.CallbackTarget = this;
-	UKismetSystemLibrary::MoveComponentTo(GetCapsuleComponent(), TargetLocation, TargetRotation, true, true, 0.2f, true, EMoveComponentAction::Move, LatentActionInfo);
+	// Jump off the wall at an angle
+	return RotateAngleZAxis(GetActorForwardVector(), !bIsRightWallRunning, 45.f) * GetTraversalProfile().WallRunMinJumpOffSpeed;
 }
 
 FVector AThirdPersonDemoCharacter::GetCoverLocation() const
 {
-	if (bIsTallCover)
+	// The side probe runs TraceOffset behind the face
+	const FVector CornerLocation = TraceSideCoverResult.Location + TraceForwardCoverResult.Normal * GetTraversalProfile().TraceOffset;
+	return MakeCoverLocation(bIsTallCover, TraceForwardCoverResult.Location, TraceForwardCoverResult.Normal, CornerLocation, TraceSideCoverResult.Normal);
+}
+
+FVector AThirdPersonDemoCharacter::MakeCoverLocation(const bool bTallCover, const FVector& FaceLocation, const FVector& FaceNormal, const FVector& CornerLocation, const FVector& SideDirection) const
+{
+	const UTraversalProfile& Profile = GetTraversalProfile();
+
+	if (bTallCover)
 	{
-		return TraceSideCoverResult.Location - TraceSideCoverResult.Normal * CoverSideOffset 
-			+ TraceForwardCoverResult.Normal * (CoverForwardOffset + TraceOffset) 
+		return CornerLocation - SideDirection * Profile.CoverSideOffset
+			+ FaceNormal * Profile.CoverForwardOffset
 			+ FVector::DownVector * GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
 	}
 	else
 	{
-		return TraceForwardCoverResult.Location + TraceForwardCoverResult.Normal * CoverForwardOffset;
+		return FaceLocation + FaceNormal * Profile.CoverForwardOffset;
 	}
 }
 
+void AThirdPersonDemoCharacter::GetCoverProbeHeights(float& OutShortHeight, float& OutTallHeight) const
+{
+	// Same probes as TraceForwardCover, from the capsule center and the top of its cylinder
+	OutShortHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	OutTallHeight = OutShortHeight + GetCapsuleComponent()->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+}
+
+SIZE_T AThirdPersonDemoCharacter::GetTraversalMemorySize() const
+{
+	// Traversal members of the actor
+	SIZE_T Size = sizeof(TraversalProfile) + sizeof(LedgeProfile) + sizeof(TraceForwardCoverResult) + sizeof(TraceSideCoverResult)
+		+ sizeof(ScriptedInput) + sizeof(LastInputFrame) + sizeof(InputBuffer)
+		+ sizeof(LedgeCandidates) + sizeof(CoverCandidates) + sizeof(ProbeCache) + sizeof(WallRunPredictor)
+		+ sizeof(UIHangOverlapDelegate) + sizeof(UIHangOverlapHandle) + sizeof(UIHangScanSettings) + sizeof(UIHangOverlaps)
+		+ sizeof(ActiveEdgeIndex) + sizeof(IndexedCoverFace);
+
+	// What they hold on the heap
+	Size += LedgeCandidates.GetAllocatedSize() + CoverCandidates.GetAllocatedSize() + UIHangOverlaps.GetAllocatedSize();
+
+	// The proximity sphere, and what the traversal movement component adds to the character movement component
+	Size += TraversalProximity->GetClass()->GetStructureSize();
+	Size += TraversalMovement->GetClass()->GetStructureSize() - UCharacterMovementComponent::StaticClass()->GetStructureSize();
+	return Size;
+}
+
+const UTraversalProfile& AThirdPersonDemoCharacter::GetTraversalProfile() const
+{
+	return TraversalProfile != nullptr ? *TraversalProfile : *GetDefault<UTraversalProfile>();
+}
+
+void AThirdPersonDemoCharacter::GetTraversalRouteRules(const float GravityZ, FTraversalRouteRules& OutRules) const
+{
+	const UTraversalProfile& Profile = GetTraversalProfile();
+	const UCharacterMovementComponent* Movement = GetCharacterMovement();
+	const float Gravity = FMath::Max(-GravityZ * Movement->GravityScale, KINDA_SMALL_NUMBER);
+
+	OutRules.CapsuleRadius = GetCapsuleComponent()->GetScaledCapsuleRadius();
+	OutRules.CapsuleHalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	// TryHang takes lips ClimbUpMinDistance to ClimbUpMaxDistance above the capsule center, which a jump raises by up to its apex
+	const float JumpHeight = FMath::Square(Movement->JumpZVelocity) / (2.f * Gravity);
+	OutRules.MinLipHeight = OutRules.CapsuleHalfHeight + Profile.ClimbUpMinDistance;
+	OutRules.MaxLipHeight = OutRules.CapsuleHalfHeight + Profile.ClimbUpMaxDistance + JumpHeight;
+
+	// Wall runs start from a jump off the ground at full speed, and last until the reduced gravity brings the character back down
+	OutRules.bCanWallRun = Movement->MaxWalkSpeed >= Profile.WallRunMinHorizontalSpeed;
+	OutRules.WallRunOffset = Profile.WallRunOffset;
+	const float WallRunVerticalSpeed = Movement->JumpZVelocity * Profile.WallRunVerticalSpeedMultiplier;
+	OutRules.MaxWallRunLength = Movement->MaxWalkSpeed * 2.f * WallRunVerticalSpeed / (Gravity * FMath::Max(Profile.WallRunMinGravityScale, KINDA_SMALL_NUMBER));
+}
+
 FRotator AThirdPersonDemoCharacter::GetCoverRotation() const
 {
 	return TraceForwardCoverResult.Normal.Rotation();
@@ -590,12 +1875,11 @@ FRotator AThirdPersonDemoCharacter::GetCoverRotation() const
 
 FVector AThirdPersonDemoCharacter::RotateAngleZAxis(const FVector InVector, bool bClockWise, float Degree /*= 90.f*/) const
 {
-	return UKismetMathLibrary::RotateAngleAxis(InVector, bClockWise ? Degree : -Degree, FVector::UpVector);
+	if (Degree == 90.f) return TraversalMath::RotateAboutZ90(InVector, bClockWise);
+	return TraversalMath::RotateAboutZ(InVector, TraversalMath::FYaw(bClockWise ? Degree : -Degree));
 }
 
 FVector AThirdPersonDemoCharacter::GetHorizontalVector(const FVector InVector) const
 {
-	FVector OutVector = InVector;
-	OutVector.Z = 0;
-	return OutVector;
+	return TraversalMath::GetHorizontal(InVector);
 }
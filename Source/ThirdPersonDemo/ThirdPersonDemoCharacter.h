@@ -5,9 +5,29 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "WorldCollision.h"
+#include "TraversalEdgeIndex.h"
+#include "TraversalInput.h"
+#include "TraversalKernel.h"
+#include "TraversalLedgeScanner.h"
+#include "TraversalProbeCache.h"
+#include "TraversalProfile.h"
+#include "TraversalState.h"
+#include "TraversalWallRunPredictor.h"
 #include "ThirdPersonDemoCharacter.generated.h"
 
 class UAnimMontage;
+class UInputAction;
+class UInputMappingContext;
+class USphereComponent;
+class UTraversalEdgeIndex;
+class UTraversalMovementComponent;
+struct FInputActionInstance;
+struct FInputActionValue;
+struct FStreamableHandle;
+struct FTraversalRouteRules;
+
+DECLARE_DELEGATE_OneParam(FTraversalActionDelegate, ETraversalInputAction::Type);
 
 UCLASS(config=Game)
 class AThirdPersonDemoCharacter : public ACharacter
@@ -21,8 +41,15 @@ class AThirdPersonDemoCharacter : public ACharacter
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UCameraComponent* FollowCamera;
+	/** Overlaps traversable actors in probe range. Ledge and cover probes only run while it does **/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Traversal, meta = (AllowPrivateAccess = "true"))
+	USphereComponent* TraversalProximity;
+
+	/** Character movement component, with the traversal movement modes **/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+	UTraversalMovementComponent* TraversalMovement;
 public:
-	AThirdPersonDemoCharacter();
+	AThirdPersonDemoCharacter(const FObjectInitializer& ObjectInitializer);
 
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
@@ -37,6 +64,43 @@ protected:
 	/** Resets HMD orientation in VR. */
 	void OnResetVR();
 
+	/** Called via input when a traversal action is pressed **/
+	void OnInputActionPressed(ETraversalInputAction::Type Action);
+
+	/** Called via input when a traversal action is released **/
+	void OnInputActionReleased(ETraversalInputAction::Type Action);
+
+	/** Called via enhanced input when a traversal action starts or completes **/
+	void OnTraversalActionStarted(const FInputActionInstance& Instance);
+	void OnTraversalActionCompleted(const FInputActionInstance& Instance);
+
+	/** Traversal action bound to an input action, None if it isn't one **/
+	ETraversalInputAction::Type GetTraversalInputAction(const UInputAction* InputAction) const;
+
+	/** Called via enhanced input to cache the movement input read by GatherTraversal **/
+	void OnMoveAction(const FInputActionValue& Value);
+	void OnMoveActionCompleted(const FInputActionValue& Value);
+
+	/** Called via enhanced input to turn and look up, by a delta or at a normalized rate **/
+	void OnLookAction(const FInputActionValue& Value);
+	void OnLookRateAction(const FInputActionValue& Value);
+
+	/** Called via legacy input to cache the movement input read by GatherTraversal **/
+	void OnMoveForwardAxis(float Value);
+	void OnMoveRightAxis(float Value);
+
+	/** Handle a press, and buffer it if it could not be acted on yet **/
+	void PressInputAction(const ETraversalInputAction::Type Action);
+
+	/** Retry buffered presses now that the state may allow them **/
+	void FlushInputBuffer();
+
+	/**
+	 * Run the handler of an action, for live and scripted input alike
+	 * @return False if a press could not be acted on in the current state
+	 */
+	bool HandleInputAction(const ETraversalInputAction::Type Action, const bool bPressed);
+
 	/** 
 	 * Called via input to turn at a given rate. 
 	 * @param Rate	This is a normalized rate, i.e. 1.0 means 100% of desired turn rate
@@ -60,129 +124,346 @@ protected:
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	// End of APawn interface
 
+	/** Create the mapping context and input actions, with the keys of DefaultInput.ini, if the blueprint sets no mapping context **/
+	void CreateDefaultInputMappings();
+
+	virtual void PostLoad() override;
+
+	/** Move tuning a blueprint overrode in the deprecated properties into a profile of its own, if it has no profile yet **/
+	void MigrateDeprecatedTuning();
+
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual bool CanJumpInternal_Implementation() const override;
 
-	virtual void Jump() override;
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** Add the traversal camera rig and input mapping to the local player **/
+	virtual void PawnClientRestart() override;
+
+	/** Order the traversal batch after the new controller **/
+	virtual void PossessedBy(AController* NewController) override;
 
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns TraversalProximity subobject **/
+	FORCEINLINE USphereComponent* GetTraversalProximity() const { return TraversalProximity; }
+	/** Returns TraversalMovement subobject **/
+	FORCEINLINE UTraversalMovementComponent* GetTraversalMovement() const { return TraversalMovement; }
+
+	/** Camera offset and boom length the camera rig converges to in the current state **/
+	FVector GetTargetCameraOffset() const { return CameraOffset; }
+	float GetTargetCameraBoomLength() const { return CameraBoomLength; }
+	float GetCameraSmoothTime() const { return GetTraversalProfile().CameraSmoothTime; }
+
+	/**
+	 * Per-frame traversal update, called by UTraversalTickSubsystem or by Tick when not batched
+	 * @param bRunEntryChecks	False on frames where the batch staggers out the ledge and wall run entry probes
+	 */
+	void TickTraversal(const float DeltaSeconds, const bool bRunEntryChecks = true);
+
+	/** Drive the character from a script instead of its input component. Actions fire on the frames their bit changes **/
+	void SetScriptedInput(const FTraversalInputFrame& Frame);
+
+	/** Go back to reading the input component **/
+	void ClearScriptedInput();
+
+	ETraversalState GetTraversalState() const { return TraversalState; }
+
+	/** Input read by the last traversal update, live or scripted **/
+	const FTraversalInputFrame& GetLastInputFrame() const { return LastInputFrame; }
+
+	/** CRC of the state traversal drives (transform, velocity, movement mode and traversal state) **/
+	uint32 GetTraversalChecksum() const;
+
+	/** True where traversal decisions are made for this character: on the owning client, and on the server for its own and AI characters **/
+	bool IsTraversalLocallyPredicted() const;
+
+	bool IsAiming() const { return bIsAiming; }
+
+	/** Current state as ETraversalPackedState bits, without aiming and anchor **/
+	uint8 GetPackedTraversalState() const;
+
+	/** Server: follow the aim input of a client move **/
+	void ApplyPredictedAim(const bool bWantsToAim);
+
+	/**
+	 * Server: follow the traversal state a client predicted for a move, through the same entry and exit code the client ran.
+	 * Entries and anchors are checked against our own probes first, exits are always followed
+	 * @param PackedState	ETraversalPackedState bits of the move
+	 * @return False if the transition or anchor was rejected, in which case the client gets corrected
+	 */
+	bool ApplyPredictedTraversalState(const uint8 PackedState, const FVector& AnchorLocation, const FRotator& AnchorRotation);
+
+	/** Client: take the traversal state of a server correction as is **/
+	void ApplyCorrectedTraversalState(const uint8 PackedState, const FVector& AnchorLocation, const FRotator& AnchorRotation);
+
+	/** Velocity of a jump off the current wall run **/
+	FVector GetWallRunJumpOffVelocity() const;
+
+	/** Move onto the ledge once the climb animation is done, from the climb montage or UTraversalClimbFinishedNotify **/
+	void OnClimbUpFinished();
+
+	/**
+	 * Where the character stands in cover, shared by TryEnterCover and the cover point bake
+	 * @param FaceLocation		Forward cover probe hit on the face
+	 * @param CornerLocation	Tall cover only: exposed corner of the face at the tall probe height
+	 * @param SideDirection		Tall cover only: horizontal direction along the face towards the corner
+	 */
+	FVector MakeCoverLocation(const bool bTallCover, const FVector& FaceLocation, const FVector& FaceNormal, const FVector& CornerLocation, const FVector& SideDirection) const;
+
+	/** Heights above the floor of the short and tall forward cover probes **/
+	void GetCoverProbeHeights(float& OutShortHeight, float& OutTallHeight) const;
+
+	/** Soft references to load before traversal starts, leaving out the ledge indicator where it never shows **/
+	void GetTraversalAssetPaths(TArray<FSoftObjectPath>& OutPaths) const;
+
+	/** False until the traversal assets are loaded. Ledge and wall run entry checks wait for it **/
+	bool AreTraversalAssetsReady() const { return bTraversalAssetsReady; }
+
+	/** Bytes of traversal state this character holds, inline and on the heap, for Traversal.MemReport. Shared profiles are not counted **/
+	SIZE_T GetTraversalMemorySize() const;
+
+	/** Tuning of this character, its profile or the profile class defaults **/
+	const UTraversalProfile& GetTraversalProfile() const;
+
+	/** Hang, climb and wall run limits for the nav link generator. Works on the class default object, hence the gravity **/
+	void GetTraversalRouteRules(const float GravityZ, FTraversalRouteRules& OutRules) const;
+
+	/** Batch phase 1: write input, state and tuning into the batch **/
+	void GatherTraversal(FTraversalBatch& Batch, const int32 Index, const bool bRunEntryChecks);
+
+	/** Batch phase 2: run the probes planned by TraversalKernel::PlanProbes **/
+	void RunTraversalProbes(FTraversalBatch& Batch, const int32 Index);
+
+	/** Batch phase 3: apply the decisions of TraversalKernel::Decide, then run the game thread only checks **/
+	void ApplyTraversal(const FTraversalBatch& Batch, const int32 Index, const float DeltaSeconds);
 
 protected:
 
+	/** Loaded with the map, after the character spawned, see RequestTraversalAssets **/
 	UPROPERTY(EditAnywhere, Category = "Anim Montages")
-	UAnimMontage* ClimbMontage;
-
+	TSoftObjectPtr<UAnimMontage> ClimbMontage;
+
+	/** Enhanced input mapping of the actions below. Leave unset for a default mapping of the legacy bindings, see CreateDefaultInputMappings **/
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputMappingContext* TraversalMappingContext;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* MoveAction;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* LookAction;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* LookRateAction;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* JumpAction;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* ClimbUpAction;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* DropDownAction;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* ToggleCoverAction;
+	UPROPERTY(EditDefaultsOnly, Category = "Input")
+	UInputAction* AimAction;
+
+	/** Draw this character's probes in the traversal debug visualizer, see traversal.Debug.Draw **/
 	UPROPERTY(EditAnywhere, Category = "Debug Toggle")
-	bool bDrawDebug = true;
+	bool bDrawDebug = false;
 
+	/** Ledge indicator. Never loaded on dedicated servers **/
 	UPROPERTY(EditAnywhere, Category = "3D UI Blueprints")
-	TSubclassOf<AActor> ClimbUIClass;
+	TSoftClassPtr<AActor> ClimbUIClass;
 
+	/** Traversal tuning shared by every character using it. The class defaults of UTraversalProfile if unset **/
 	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float MaxAimMoveRate = 0.4f;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float ClimbForwardDistance = 50;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float ClimbUpMaxDistance = 100;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float ClimbUpMinDistance = 30;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float WallRunSideDistance = 30;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float WallRunMinHorizontalSpeed = 500;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float WallRunMinVerticalVelocity = -100;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float WallRunMinJumpOffSpeed = 800.f;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float WallRunMinGravityScale = 0.15f;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float WallRunVerticalSpeedMultiplier = 0.5f;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float CoverForwardDistance = 100;
-	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
-	float CoverSideDistance = 100;
-
-	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
-	float HangHorizontalOffset = 50.f;
-	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
-	float HangVerticalOffset = 50.f;
-	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
-	float WallRunOffset = 45.f;
-	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
-	float CoverForwardOffset = 50.f;
-	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
-	float CoverSideOffset = 50.f;
-	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
-	float CoverAimYOffset = 50.f;
-
-	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
-	float CameraCoverYOffset = 50.f;
-	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
-	float CameraAimYOffset = 30.f;
-	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
-	float CameraOffsetSpeed = 100.f;
-	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
-	float CameraBoomAimLength = 150.f;
-	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
-	float TraceOffset = 10.f;
+	UTraversalProfile* TraversalProfile;
+
+	/** Tuning saved on character blueprints before it moved to UTraversalProfile, see MigrateDeprecatedTuning **/
+	UPROPERTY()
+	float MaxAimMoveRate_DEPRECATED = 0.4f;
+	UPROPERTY()
+	float ClimbForwardDistance_DEPRECATED = 50;
+	UPROPERTY()
+	float ClimbUpMaxDistance_DEPRECATED = 100;
+	UPROPERTY()
+	float ClimbUpMinDistance_DEPRECATED = 30;
+	UPROPERTY()
+	float WallRunSideDistance_DEPRECATED = 30;
+	UPROPERTY()
+	float WallRunMinHorizontalSpeed_DEPRECATED = 500;
+	UPROPERTY()
+	float WallRunMinVerticalVelocity_DEPRECATED = -100;
+	UPROPERTY()
+	float WallRunMinJumpOffSpeed_DEPRECATED = 800.f;
+	UPROPERTY()
+	float WallRunMinGravityScale_DEPRECATED = 0.15f;
+	UPROPERTY()
+	float WallRunVerticalSpeedMultiplier_DEPRECATED = 0.5f;
+	UPROPERTY()
+	float CoverForwardDistance_DEPRECATED = 100;
+	UPROPERTY()
+	float CoverSideDistance_DEPRECATED = 100;
+	UPROPERTY()
+	float HangHorizontalOffset_DEPRECATED = 50.f;
+	UPROPERTY()
+	float HangVerticalOffset_DEPRECATED = 50.f;
+	UPROPERTY()
+	float WallRunOffset_DEPRECATED = 45.f;
+	UPROPERTY()
+	float CoverForwardOffset_DEPRECATED = 50.f;
+	UPROPERTY()
+	float CoverSideOffset_DEPRECATED = 50.f;
+	UPROPERTY()
+	float CoverAimYOffset_DEPRECATED = 50.f;
+	UPROPERTY()
+	float CameraCoverYOffset_DEPRECATED = 50.f;
+	UPROPERTY()
+	float CameraAimYOffset_DEPRECATED = 30.f;
+	UPROPERTY()
+	float CameraBoomAimLength_DEPRECATED = 150.f;
+	UPROPERTY()
+	float TraceOffset_DEPRECATED = 10.f;
 
 	float MaxJumpHeight;
 	float CameraBoomOriginalLength;
 
 	AActor* CurrentClimbUI;
 
+	/** Indicator class a pooled actor is reserved for, handed back in EndPlay **/
+	TSubclassOf<AActor> ReservedClimbUIClass;
+
 	FVector CameraOffset;
 	float CameraOffsetFOV;
 	float CameraBoomLength;
 
-	FVector ControlMoveVector;
-	float ControlMoveMagnitude;
+	/** Ledge found by the last ScanLedge. Depth and Clearance are only measured by the ray scan, not for baked ledges **/
+	FTraversalLedgeProfile LedgeProfile;
+	FTraversalProbeHit TraceForwardCoverResult;
+	FTraversalProbeHit TraceSideCoverResult;
+
+	/** Input set by SetScriptedInput, used instead of the input component while bUseScriptedInput is set **/
+	FTraversalInputFrame ScriptedInput;
+	bool bUseScriptedInput;
+
+	/** Input read by the last GatherTraversal **/
+	FTraversalInputFrame LastInputFrame;
+
+	/** ETraversalInputAction bits held down on the input component, and pressed since the last GatherTraversal **/
+	uint8 HeldInputActions;
+	uint8 PressedInputActions;
+
+	/** MoveForward/MoveRight values cached by the input bindings **/
+	FVector2D MoveInputValue;
+
+	/** Presses waiting for the state to allow them **/
+	FTraversalInputBuffer InputBuffer;
+
+	/** Traversable primitives overlapping TraversalProximity, by what their actor offers **/
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> LedgeCandidates;
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> CoverCandidates;
+
+	/** Probe results shared by every consumer within the current frame **/
+	FTraversalProbeCache ProbeCache;
 
-	FHitResult TraceForwardClimbResult;
-	FHitResult TraceUpClimbResult;
-	FHitResult TraceSideWallRunResult;
-	FHitResult TraceForwardCoverResult;
-	FHitResult TraceSideCoverResult;
+	/** Window of the current jump in which a wall run can start **/
+	FTraversalWallRunPredictor WallRunPredictor;
+
+	/** Async ledge indicator overlap. Issued one frame, its ray fan is run on the next against the settings it was issued with **/
+	FOverlapDelegate UIHangOverlapDelegate;
+	FTraceHandle UIHangOverlapHandle;
+	FTraversalLedgeScanSettings UIHangScanSettings;
+	TArray<FOverlapResult> UIHangOverlaps;
+	bool bUIHangOverlapsReady = false;
+
+	/** Keeps the traversal assets loaded while the character is in play **/
+	TSharedPtr<FStreamableHandle> TraversalAssetsHandle;
+	bool bTraversalAssetsReady;
+
+	/** Baked edge index covering the character, refreshed by the first probe of each climb/cover check **/
+	const UTraversalEdgeIndex* ActiveEdgeIndex;
+
+	/** Cover face found in the edge index by the last TraceForwardCover, if any **/
+	FTraversalEdgeHit IndexedCoverFace;
+
+	/** Packed state for simulated proxies, see ETraversalPackedState. The owning client predicts its own **/
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedTraversalState)
+	uint8 ReplicatedTraversalState;
+
+	UFUNCTION()
+	void OnRep_ReplicatedTraversalState();
+
+	/** Server: moves in a row of a remote player's wall run without a wall beside it **/
+	int32 WallRunValidationMisses = 0;
+
+	/** Current traversal state. Only changed through SetTraversalState **/
+	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
+	ETraversalState TraversalState = ETraversalState::Default;
 
 	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
 	bool bIsAiming;
 	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
+	bool bIsRightCover;
+	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
+	bool bIsTallCover;
+	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
+	bool bIsRightWallRunning;
+
+	/** Mirrors of TraversalState for the anim blueprint, written by SetTraversalState only **/
+	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
 	bool bIsHanging;
 	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
 	bool bIsClimbing;
 	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
 	bool bIsInCover;
 	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
-	bool bIsRightCover;
-	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
-	bool bIsTallCover;
-	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
 	bool bIsWallRunning;
-	UPROPERTY(BlueprintReadOnly, Category = "Movement State")
-	bool bIsRightWallRunning;
 
 	virtual void Tick(float DeltaSeconds) override;
 
-	/** Called every tick to move the character **/
-	void Movecharacter();
+	/** Move to a new traversal state if the transition table allows it. Returns false otherwise **/
+	bool SetTraversalState(const ETraversalState NewState);
+
+	/** Move to a new traversal state without checking the transition table, for states decided by the server **/
+	void ForceTraversalState(const ETraversalState NewState);
+
+	/** Set the qualifiers of the packed state that belong to its traversal state **/
+	void UnpackTraversalQualifiers(const uint8 PackedState);
+
+	/** Returns true if the current state asks for a per-tick check **/
+	bool HasTraversalCheck(const ETraversalCheck::Type Check) const;
+
+	/** Same as HasTraversalCheck, counting run and skipped checks for stat Traversal **/
+	bool ShouldRunTraversalCheck(const ETraversalCheck::Type Check) const;
+
+	/** Apply the movement decided by the traversal kernel **/
+	void ApplyTraversalMove(const FTraversalBatch& Batch, const int32 Index);
+
+	UFUNCTION()
+	void OnTraversalProximityBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnTraversalProximityEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
-	/** Default movement control when not in any special state **/
-	void MoveCharacterDefault();
+	/** Returns true if a ledge could be in probe range: a traversable ledge overlaps the proximity sphere, or the world doesn't cull by proximity **/
+	bool HasLedgeCandidate() const;
 
-	/** Control movement during wallrunning **/
-	void MoveCharacterWallRun();
+	/** Same as HasLedgeCandidate, for cover **/
+	bool HasCoverCandidate() const;
 
 	/** Called via input to turn the camera. Also turn the actor if needed when aiming **/
 	void Turn(float Rate);
 
-	/** Called every tick to adjust camera position based on current target camera offset **/
-	void AdjustCameraOffset(const float DeltaSeconds);
+	/** Load the traversal assets asynchronously, OnTraversalAssetsLoaded lets traversal start once they are in **/
+	void RequestTraversalAssets();
+	void OnTraversalAssetsLoaded();
 
 	/** Set target camera offset based on current character state **/
 	void RecalculateTargetCameraOffset();
@@ -196,44 +477,68 @@ protected:
 	/** Check if ledge is available in range and display indicator UI **/
 	void TryUIHang();
 
+	/** Issue the async ledge indicator overlap to be consumed by next frame's TryUIHang **/
+	void RequestUIHangOverlap();
+
+	/** Called by the async trace system when the indicator overlap finishes **/
+	void OnUIHangOverlapDone(const FTraceHandle& TraceHandle, FOverlapDatum& OverlapDatum);
+
+	/** Drop the in-flight and last frame's indicator overlap **/
+	void ClearUIHangOverlap();
+
+	/** Return the ledge indicator to the pool if it is shown **/
+	void HideClimbUI();
+
 	/** Check if ledge is available in range and enter hang state if possible **/
 	void TryHang();
 
+	/** Find a ledge in the right height range and the hang transform it gives **/
+	bool FindHang(FVector& OutLocation, FRotator& OutRotation);
+
 	/** Climbup ledge from hanging state **/
 	void TryClimbUp();
 
-	/** Call when climbing up animation has finished **/
-	void OnClimbUpFinished();
+	/** Climb montage blending out, which is when climbing up finishes unless a notify finished it earlier **/
+	void OnClimbMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted);
 
 	/** Drop down from hanging state **/
 	void TryDropDown();
 
-	/** Check if wall is available in range and enter wall run state if possible **/
+	/** Enter wall run state if still possible, once the traversal kernel found a wall **/
 	void TryEnterWallRun();
 
+	/** Enter wall run state along the wall found by the last side probe **/
+	void EnterWallRun();
+
 	/** Exit wall run state **/
 	void ExitWallRun();
 
+	/** Server: check there is a wall to run along on the side a client claims, with the anchor tolerance as extra reach **/
+	bool HasWallRunWall(const bool bRightWall);
+
 	/** Toggle in/out of cover state **/
 	void ToggleCover();
 
 	/** Check if cover is available in range and enter cover state if possible **/
 	void TryEnterCover();
 
+	/** Find a wall to take cover against and the cover transform it gives. Sets bIsRightCover and bIsTallCover **/
+	bool FindCover(FVector& OutLocation, FRotator& OutRotation);
+
+	/** Enter cover state and move the character to the cover location **/
+	void EnterCover(const FVector& CoverLocation, const FRotator& CoverRotation);
+
 	/** Exit cover state **/
 	void ExitCover();
 
-	/** Trace forward to check geometry for climbing **/
-	bool TraceForwardClimb(const bool bDisableDraw = false);
-
-	/** Trace downward to check geometry for climbing **/
-	bool TraceUpClimb(const bool bDisableDraw = false);
+	/** Look for a ledge to hang from in front of the character, in the edge index and then with the ray scan **/
+	bool ScanLedge();
 
-	/** Trace to the side to check geometry for wall running **/
-	bool TraceSideWallRun();
+	/** Look for a ledge in the baked edge index only. Sets ActiveEdgeIndex, and LedgeProfile if one was found **/
+	bool FindBakedLedge();
 
-	/** Trace downward to check for ground to exit wall running **/
-	bool TraceDownWallRun();
+	/** Settings of the ray scan in front of the character. Call after FindBakedLedge, the scan skips what the index describes **/
+	FTraversalLedgeScanSettings MakeLedgeScanSettings() const;
 
 	/** Trace forward to check geometry for entering cover **/
 	bool TraceForwardCover();
@@ -244,11 +549,20 @@ protected:
 	//////////////////////////////////////////////////////////////////////////
 	// Helper Functions
 
-	/** Helper function for Line Traces **/
-	bool DoLineTraceCheck(const FVector TraceStart, const FVector TraceEnd, FHitResult& OutHit, const bool bDisableDraw = false);
+	/** Helper function for Line Traces. bSkipBaked ignores hits on geometry the baked edge index already describes **/
+	bool DoLineTraceCheck(const FVector TraceStart, const FVector TraceEnd, FHitResult& OutHit, const bool bSkipBaked = false);
+
+	/** Helper function for traversal probes. Runs the trace at most once per frame and segment **/
+	bool DoProbeTraceCheck(const ETraversalProbe Probe, const FVector TraceStart, const FVector TraceEnd, FTraversalProbeHit& OutHit, const bool bDisableDraw = false, const bool bSkipBaked = false);
+
+	/** Helper function to get the downward ledge probe the edge index is queried with **/
+	void GetUpClimbTrace(FVector& OutTraceStart, FVector& OutTraceEnd) const;
+
+	/** Helper function to get the baked edge index covering the character, if the level has one **/
+	const UTraversalEdgeIndex* FindEdgeIndex() const;
 
-	/** Helper function for MoveComponentTo for Capsule Component **/
-	void MoveCapsuleComponentTo(const FVector TargetLocation, const FRotator TargetRotation, const float OverTime = 0.2f);
+	/** Helper function to answer both climb probes from the baked edge index **/
+	bool FindIndexedLedge(const UTraversalEdgeIndex* EdgeIndex, FTraversalProbeHit& OutUpResult, FTraversalProbeHit& OutForwardResult) const;
 
 	/** Helper function to get cover location **/
 	FVector GetCoverLocation() const;
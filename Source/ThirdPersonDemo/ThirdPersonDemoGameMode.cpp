@@ -2,14 +2,138 @@
 
 #include "ThirdPersonDemoGameMode.h"
 #include "ThirdPersonDemoCharacter.h"
-#include "UObject/ConstructorHelpers.h"
+#include "Engine/AssetManager.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarTraversalAssetsLoadSynchronously(
+	TEXT("traversal.Assets.LoadSynchronously"),
+	0,
+	TEXT("Load the pawn class and its traversal assets synchronously in InitGame, like the hard references did before. Compare the \"Traversal assets ready\" log of both paths."),
+	ECVF_Default);
 
 AThirdPersonDemoGameMode::AThirdPersonDemoGameMode()
 {
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/ThirdPersonCPP/Blueprints/ThirdPersonCharacter"));
-	if (PlayerPawnBPClass.Class != NULL)
+	// set default pawn class to our Blueprinted character, loaded in InitGame
+	TraversalPawnClass = TSoftClassPtr<APawn>(FSoftClassPath(TEXT("/Game/ThirdPersonCPP/Blueprints/ThirdPersonCharacter.ThirdPersonCharacter_C")));
+	DefaultPawnClass = AThirdPersonDemoCharacter::StaticClass();
+}
+
+void AThirdPersonDemoGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	LoadStartTime = FPlatformTime::Seconds();
+	bLoadSynchronously = CVarTraversalAssetsLoadSynchronously.GetValueOnGameThread() != 0;
+	if (TraversalPawnClass.IsNull())
+	{
+		OnPawnClassLoaded();
+		return;
+	}
+
+	if (bLoadSynchronously)
+	{
+		TraversalPawnClass.LoadSynchronous();
+		OnPawnClassLoaded();
+		return;
+	}
+
+	// Through the Asset Manager when the pawn is a registered primary asset, so it is tracked and cooked as one
+	const FStreamableDelegate OnLoaded = FStreamableDelegate::CreateUObject(this, &AThirdPersonDemoGameMode::OnPawnClassLoaded);
+	UAssetManager& AssetManager = UAssetManager::Get();
+	const FPrimaryAssetId PawnAssetId = AssetManager.GetPrimaryAssetIdForPath(TraversalPawnClass.ToSoftObjectPath());
+	if (PawnAssetId.IsValid())
+	{
+		PawnClassHandle = AssetManager.LoadPrimaryAsset(PawnAssetId, TArray<FName>(), OnLoaded, FStreamableManager::AsyncLoadHighPriority);
+	}
+	else
+	{
+		PawnClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(TraversalPawnClass.ToSoftObjectPath(), OnLoaded, FStreamableManager::AsyncLoadHighPriority);
+	}
+	if (!PawnClassHandle.IsValid())
+	{
+		OnPawnClassLoaded();
+	}
+}
+
+void AThirdPersonDemoGameMode::OnPawnClassLoaded()
+{
+	// An async load can fail where a blocking one still works, e.g. a package missing from the async loader's view
+	UClass* PawnClass = TraversalPawnClass.Get();
+	if (PawnClass == nullptr && !TraversalPawnClass.IsNull())
+	{
+		PawnClass = TraversalPawnClass.LoadSynchronous();
+	}
+
+	if (PawnClass != nullptr)
+	{
+		DefaultPawnClass = PawnClass;
+	}
+	else if (!TraversalPawnClass.IsNull())
+	{
+		// The native fallback has no mesh or anim blueprint, players get an invisible character
+		UE_LOG(LogTemp, Error, TEXT("Failed to load pawn class %s, players get %s without a mesh"), *TraversalPawnClass.ToString(), *GetNameSafe(DefaultPawnClass));
+	}
+
+	LoadTraversalAssets();
+}
+
+void AThirdPersonDemoGameMode::LoadTraversalAssets()
+{
+	// Preload what the pawn needs to traverse, so characters are ready as soon as they spawn
+	TArray<FSoftObjectPath> AssetPaths;
+	if (const AThirdPersonDemoCharacter* CharacterCDO = Cast<AThirdPersonDemoCharacter>(DefaultPawnClass->GetDefaultObject()))
 	{
-		DefaultPawnClass = PlayerPawnBPClass.Class;
+		CharacterCDO->GetTraversalAssetPaths(AssetPaths);
 	}
+	if (AssetPaths.Num() > 0)
+	{
+		if (bLoadSynchronously)
+		{
+			TraversalAssetsHandle = UAssetManager::GetStreamableManager().RequestSyncLoad(AssetPaths);
+		}
+		else
+		{
+			TraversalAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths,
+				FStreamableDelegate::CreateUObject(this, &AThirdPersonDemoGameMode::OnTraversalAssetsLoaded), FStreamableManager::AsyncLoadHighPriority);
+			if (TraversalAssetsHandle.IsValid()) return;
+		}
+	}
+
+	OnTraversalAssetsLoaded();
+}
+
+void AThirdPersonDemoGameMode::OnTraversalAssetsLoaded()
+{
+	bTraversalReady = true;
+	UE_LOG(LogTemp, Log, TEXT("Traversal assets ready after %.1f ms, loaded %s"), (FPlatformTime::Seconds() - LoadStartTime) * 1000.0, bLoadSynchronously ? TEXT("synchronously") : TEXT("asynchronously"));
+
+	// Start the players that joined while loading
+	TArray<APlayerController*> Players = MoveTemp(PendingPlayers);
+	for (APlayerController* Player : Players)
+	{
+		if (Player != nullptr && !Player->IsPendingKill())
+		{
+			Super::HandleStartingNewPlayer_Implementation(Player);
+		}
+	}
+}
+
+void AThirdPersonDemoGameMode::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
+{
+	if (!bTraversalReady)
+	{
+		// Spawned once loading finished, so the player never gets the fallback pawn
+		PendingPlayers.AddUnique(NewPlayer);
+		return;
+	}
+
+	Super::HandleStartingNewPlayer_Implementation(NewPlayer);
+}
+
+void AThirdPersonDemoGameMode::Logout(AController* Exiting)
+{
+	PendingPlayers.Remove(Cast<APlayerController>(Exiting));
+
+	Super::Logout(Exiting);
 }
@@ -6,6 +6,14 @@
 #include "GameFramework/GameModeBase.h"
 #include "ThirdPersonDemoGameMode.generated.h"
 
+struct FStreamableHandle;
+
+/**
+ * Loads the pawn class and its traversal assets asynchronously while the map loads, instead of
+ * hard referencing them from the game mode. The pawn is loaded as a TraversalPawn primary asset when
+ * the Asset Manager knows it, see DefaultGame.ini. Players that join before everything is loaded are
+ * only started, and so spawned, once loading finished.
+ */
 UCLASS(minimalapi)
 class AThirdPersonDemoGameMode : public AGameModeBase
 {
@@ -13,7 +21,35 @@ class AThirdPersonDemoGameMode : public AGameModeBase
 
 public:
 	AThirdPersonDemoGameMode();
-};
 
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
+	virtual void Logout(AController* Exiting) override;
+
+	/** True once the pawn class and its traversal assets are loaded **/
+	bool IsTraversalReady() const { return bTraversalReady; }
+
+	/** Pawn spawned for players. DefaultPawnClass is used until it is loaded, and if it fails to load **/
+	UPROPERTY(EditDefaultsOnly, Category = "Classes")
+	TSoftClassPtr<APawn> TraversalPawnClass;
+
+private:
+	void OnPawnClassLoaded();
+	void OnTraversalAssetsLoaded();
 
+	/** Load the traversal assets of the pawn class, or continue if it has none **/
+	void LoadTraversalAssets();
 
+	TSharedPtr<FStreamableHandle> PawnClassHandle;
+	TSharedPtr<FStreamableHandle> TraversalAssetsHandle;
+
+	/** Set by traversal.Assets.LoadSynchronously when InitGame ran **/
+	bool bLoadSynchronously = false;
+
+	/** Players waiting for loading to finish **/
+	UPROPERTY()
+	TArray<APlayerController*> PendingPlayers;
+
+	bool bTraversalReady = false;
+	double LoadStartTime = 0.0;
+};
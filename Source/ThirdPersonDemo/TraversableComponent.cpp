@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversableComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "TraversalProximitySubsystem.h"
+
+const FName UTraversableComponent::ActorTag(TEXT("Traversable"));
+
+UTraversableComponent::UTraversableComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UTraversableComponent::GetTraversalFeatures(const AActor* Actor, bool& bOutHasLedges, bool& bOutHasCover)
+{
+	bOutHasLedges = false;
+	bOutHasCover = false;
+	if (Actor == nullptr) return;
+
+	if (Actor->ActorHasTag(ActorTag))
+	{
+		bOutHasLedges = true;
+		bOutHasCover = true;
+		return;
+	}
+
+	if (const UTraversableComponent* Traversable = Actor->FindComponentByClass<UTraversableComponent>())
+	{
+		bOutHasLedges = Traversable->bHasLedges;
+		bOutHasCover = Traversable->bHasCover;
+	}
+}
+
+void UTraversableComponent::EnableProximityOverlaps(AActor* Actor)
+{
+	if (Actor == nullptr) return;
+
+	// Static meshes don't generate overlap events by default, and both sides of an overlap need them.
+	// Everything else ignores the proximity channel, so the spheres don't overlap pawns, each other or the rest of the level
+	TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(Actor);
+	for (UPrimitiveComponent* PrimitiveComponent : PrimitiveComponents)
+	{
+		PrimitiveComponent->SetGenerateOverlapEvents(true);
+		PrimitiveComponent->SetCollisionResponseToChannel(ECC_TraversalProximity, ECR_Overlap);
+	}
+}
+
+void UTraversableComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Editor worlds would save the changed collision settings into the level
+	const UWorld* World = GetWorld();
+	if (World != nullptr && World->IsGameWorld())
+	{
+		EnableProximityOverlaps(GetOwner());
+	}
+}
+
+void UTraversableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UTraversalProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UTraversalProximitySubsystem>())
+	{
+		ProximitySubsystem->RegisterTraversable();
+	}
+}
+
+void UTraversableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTraversalProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UTraversalProximitySubsystem>())
+	{
+		ProximitySubsystem->UnregisterTraversable();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
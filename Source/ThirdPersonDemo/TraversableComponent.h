@@ -0,0 +1,47 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TraversableComponent.generated.h"
+
+/** Object channel of the proximity spheres of characters, see DefaultEngine.ini. Only traversable geometry responds to it **/
+#define ECC_TraversalProximity ECC_GameTraceChannel1
+
+/**
+ * Marks the geometry of its actor as traversable. Characters only run their ledge and cover probes while their
+ * proximity sphere overlaps a traversable actor. Actors tagged "Traversable" offer both ledges and cover.
+ */
+UCLASS(ClassGroup = Traversal, meta = (BlueprintSpawnableComponent))
+class UTraversableComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTraversableComponent();
+
+	/** Actor tag with the same effect as a component offering ledges and cover **/
+	static const FName ActorTag;
+
+	/** Ledges of this actor can be hung from **/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Traversal")
+	bool bHasLedges = true;
+
+	/** Faces of this actor can be taken cover against **/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Traversal")
+	bool bHasCover = true;
+
+	/** Returns what the actor offers, from its component or tag **/
+	static void GetTraversalFeatures(const AActor* Actor, bool& bOutHasLedges, bool& bOutHasCover);
+
+	/** Let the proximity sphere of characters overlap the primitives of the actor, and nothing but traversable actors **/
+	static void EnableProximityOverlaps(AActor* Actor);
+
+protected:
+	virtual void OnRegister() override;
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
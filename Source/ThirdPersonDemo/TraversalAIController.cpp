@@ -0,0 +1,18 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalAIController.h"
+#include "TraversalPathFollowingComponent.h"
+
+ATraversalAIController::ATraversalAIController(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UTraversalPathFollowingComponent>(TEXT("PathFollowingComponent")))
+{
+}
+
+void ATraversalAIController::UpdateControlRotation(float DeltaTime, bool bUpdatePawn)
+{
+	// On a traversal link the control rotation is the scripted input's, which the character's move input is relative to
+	const UTraversalPathFollowingComponent* TraversalPathFollowing = Cast<UTraversalPathFollowingComponent>(GetPathFollowingComponent());
+	if (TraversalPathFollowing != nullptr && TraversalPathFollowing->IsOnTraversalLink()) return;
+
+	Super::UpdateControlRotation(DeltaTime, bUpdatePawn);
+}
@@ -0,0 +1,19 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "TraversalAIController.generated.h"
+
+/** AI controller of traversal characters, following paths through the generated traversal nav links **/
+UCLASS()
+class ATraversalAIController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	ATraversalAIController(const FObjectInitializer& ObjectInitializer);
+
+	virtual void UpdateControlRotation(float DeltaTime, bool bUpdatePawn = true) override;
+};
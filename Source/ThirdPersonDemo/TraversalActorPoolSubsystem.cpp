@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalActorPoolSubsystem.h"
+#include "Engine/World.h"
+
+void UTraversalActorPoolSubsystem::Reserve(TSubclassOf<AActor> ActorClass)
+{
+	if (ActorClass == nullptr) return;
+
+	FTraversalActorPool& Pool = Pools.FindOrAdd(ActorClass);
+	++Pool.NumReserved;
+	while (Pool.FreeActors.Num() + Pool.NumAcquired < Pool.NumReserved)
+	{
+		AActor* Actor = SpawnPooledActor(ActorClass);
+		if (Actor == nullptr) return;
+
+		Pool.FreeActors.Add(Actor);
+	}
+}
+
+void UTraversalActorPoolSubsystem::Unreserve(TSubclassOf<AActor> ActorClass)
+{
+	FTraversalActorPool* Pool = ActorClass != nullptr ? Pools.Find(ActorClass) : nullptr;
+	if (Pool == nullptr || Pool->NumReserved == 0) return;
+
+	--Pool->NumReserved;
+	while (Pool->FreeActors.Num() > 0 && Pool->FreeActors.Num() + Pool->NumAcquired > Pool->NumReserved)
+	{
+		AActor* Actor = Pool->FreeActors.Pop(false);
+		if (IsValid(Actor)) Actor->Destroy();
+	}
+}
+
+AActor* UTraversalActorPoolSubsystem::Acquire(TSubclassOf<AActor> ActorClass, const FVector& Location, const FRotator& Rotation)
+{
+	if (ActorClass == nullptr) return nullptr;
+
+	// Reuse an idle actor if there is one still alive, otherwise grow the pool
+	AActor* Actor = nullptr;
+	FTraversalActorPool& Pool = Pools.FindOrAdd(ActorClass);
+	while (Actor == nullptr && Pool.FreeActors.Num() > 0)
+	{
+		Actor = Pool.FreeActors.Pop(false);
+		if (!IsValid(Actor)) Actor = nullptr;
+	}
+
+	if (Actor == nullptr)
+	{
+		Actor = SpawnPooledActor(ActorClass);
+		if (Actor == nullptr) return nullptr;
+	}
+
+	++Pool.NumAcquired;
+	Actor->SetActorLocationAndRotation(Location, Rotation);
+	SetPooledActorActive(Actor, true);
+	return Actor;
+}
+
+void UTraversalActorPoolSubsystem::Release(AActor* Actor)
+{
+	if (!IsValid(Actor)) return;
+
+	SetPooledActorActive(Actor, false);
+	FTraversalActorPool& Pool = Pools.FindOrAdd(Actor->GetClass());
+	if (Pool.FreeActors.Contains(Actor)) return;
+
+	Pool.FreeActors.Add(Actor);
+	Pool.NumAcquired = FMath::Max(Pool.NumAcquired - 1, 0);
+}
+
+AActor* UTraversalActorPoolSubsystem::SpawnPooledActor(TSubclassOf<AActor> ActorClass)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters);
+	if (Actor == nullptr) return nullptr;
+
+	SetPooledActorActive(Actor, false);
+	return Actor;
+}
+
+void UTraversalActorPoolSubsystem::SetPooledActorActive(AActor* Actor, const bool bActive)
+{
+	Actor->SetActorHiddenInGame(!bActive);
+	Actor->SetActorEnableCollision(bActive);
+	Actor->SetActorTickEnabled(bActive);
+}
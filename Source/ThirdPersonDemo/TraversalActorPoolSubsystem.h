@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TraversalActorPoolSubsystem.generated.h"
+
+/** Idle actors of a single class **/
+USTRUCT()
+struct FTraversalActorPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> FreeActors;
+
+	/** Actors handed out and not released yet **/
+	int32 NumAcquired = 0;
+
+	/** Actors that may be shown at the same time, one per reservation **/
+	int32 NumReserved = 0;
+};
+
+/**
+ * Small per-world pool for in-world traversal UI actors (climb indicator, ...).
+ * Pooled actors are hidden and shown instead of being spawned and destroyed.
+ */
+UCLASS()
+class UTraversalActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Reserve one actor of the class, spawned now so acquiring it never has to spawn mid-game. Call once per user, e.g. per character **/
+	void Reserve(TSubclassOf<AActor> ActorClass);
+
+	/** Give back a reservation, destroying the idle actor it no longer needs **/
+	void Unreserve(TSubclassOf<AActor> ActorClass);
+
+	/** Take an actor of the class out of the pool, spawning one if the pool is empty, and show it at the given transform **/
+	AActor* Acquire(TSubclassOf<AActor> ActorClass, const FVector& Location, const FRotator& Rotation);
+
+	/** Hide the actor and return it to the pool **/
+	void Release(AActor* Actor);
+
+private:
+	/** Spawn a hidden actor for the pool **/
+	AActor* SpawnPooledActor(TSubclassOf<AActor> ActorClass);
+
+	/** Show or hide a pooled actor **/
+	void SetPooledActorActive(AActor* Actor, const bool bActive);
+
+	UPROPERTY()
+	TMap<UClass*, FTraversalActorPool> Pools;
+};
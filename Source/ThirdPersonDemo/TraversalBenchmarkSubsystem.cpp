@@ -0,0 +1,471 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalBenchmarkSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "ThirdPersonDemoCharacter.h"
+#include "TraversableComponent.h"
+#include "TraversalStats.h"
+#include "TraversalTickSubsystem.h"
+
+namespace
+{
+	/** The course is built far from the level so the level geometry doesn't interfere **/
+	const FVector CourseOrigin(0.f, 100000.f, 0.f);
+	const float LaneWidth = 600.f;
+	const float LaneLength = 5000.f;
+
+	/** Frames after which the script loops and characters are sent back to the start of their lane **/
+	const int32 ScriptPeriod = 480;
+
+	bool IsInWindow(const int32 Phase, const int32 Start, const int32 End)
+	{
+		return Phase >= Start && Phase < End;
+	}
+
+	struct FMetricSummary
+	{
+		float Mean = 0.f;
+		float P95 = 0.f;
+		float Max = 0.f;
+	};
+
+	FMetricSummary Summarize(TArray<float> Values)
+	{
+		FMetricSummary Summary;
+		if (Values.Num() == 0) return Summary;
+
+		Values.Sort();
+		float Total = 0.f;
+		for (const float Value : Values)
+		{
+			Total += Value;
+		}
+		Summary.Mean = Total / Values.Num();
+		Summary.P95 = Values[FMath::Min(Values.Num() - 1, FMath::FloorToInt(Values.Num() * 0.95f))];
+		Summary.Max = Values.Last();
+		return Summary;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TraversalBenchmarkCommand(
+	TEXT("Traversal.Benchmark"),
+	TEXT("Run the headless traversal benchmark. Args: Characters=N CharacterCounts=N,N,... Frames=N Warmup=N Baseline=<report.json> Threshold=0.1 Quit"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UTraversalBenchmarkSubsystem* BenchmarkSubsystem = World ? World->GetSubsystem<UTraversalBenchmarkSubsystem>() : nullptr;
+		if (BenchmarkSubsystem == nullptr) return;
+
+		const FString CommandLine = FString::Join(Args, TEXT(" "));
+		FTraversalBenchmarkSettings Settings;
+		FParse::Value(*CommandLine, TEXT("Characters="), Settings.NumCharacters);
+		FParse::Value(*CommandLine, TEXT("Frames="), Settings.NumFrames);
+		FParse::Value(*CommandLine, TEXT("Warmup="), Settings.WarmupFrames);
+		FParse::Value(*CommandLine, TEXT("Baseline="), Settings.BaselinePath);
+		FParse::Value(*CommandLine, TEXT("Threshold="), Settings.RegressionThreshold);
+		Settings.bQuitWhenDone = Args.Contains(TEXT("Quit"));
+
+		FString CharacterCounts;
+		if (FParse::Value(*CommandLine, TEXT("CharacterCounts="), CharacterCounts, false))
+		{
+			TArray<FString> Counts;
+			CharacterCounts.ParseIntoArray(Counts, TEXT(","));
+			for (const FString& Count : Counts)
+			{
+				Settings.CharacterCounts.Add(FMath::Max(1, FCString::Atoi(*Count)));
+			}
+		}
+
+		if (!BenchmarkSubsystem->StartBenchmark(Settings))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Traversal benchmark already running"));
+		}
+	}));
+
+void UTraversalBenchmarkSubsystem::Deinitialize()
+{
+	if (bRunning) Cleanup();
+
+	Super::Deinitialize();
+}
+
+bool UTraversalBenchmarkSubsystem::StartBenchmark(const FTraversalBenchmarkSettings& InSettings)
+{
+	if (bRunning) return false;
+
+	Settings = InSettings;
+	Settings.NumCharacters = FMath::Max(1, Settings.NumCharacters);
+	Settings.NumFrames = FMath::Max(1, Settings.NumFrames);
+	Settings.WarmupFrames = FMath::Max(0, Settings.WarmupFrames);
+
+	CharacterCountIndex = 0;
+	AnimScalingRows.Reset();
+	bAllRunsPassed = true;
+	if (Settings.CharacterCounts.Num() > 0) Settings.NumCharacters = Settings.CharacterCounts[0];
+
+	StartRun();
+	return true;
+}
+
+void UTraversalBenchmarkSubsystem::StartRun()
+{
+	bRunning = true;
+	FrameIndex = 0;
+	Frames.Reset(Settings.NumFrames);
+
+	BuildCourse();
+	SpawnCharacters();
+
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UTraversalBenchmarkSubsystem::OnWorldTickStart);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UTraversalBenchmarkSubsystem::OnWorldPostActorTick);
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal benchmark started: %d characters, %d frames"), Settings.NumCharacters, Settings.NumFrames);
+}
+
+void UTraversalBenchmarkSubsystem::StopBenchmark()
+{
+	if (!bRunning) return;
+
+	bAllRunsPassed &= WriteReport();
+
+	if (Settings.CharacterCounts.Num() > 0)
+	{
+		TArray<float> AnimMs, AnimTicks, WorldTickMs;
+		for (const FTraversalBenchmarkFrame& Frame : Frames)
+		{
+			AnimMs.Add(Frame.AnimMs);
+			AnimTicks.Add(Frame.AnimTicks);
+			WorldTickMs.Add(Frame.WorldTickMs);
+		}
+		const FMetricSummary AnimMsSummary = Summarize(AnimMs);
+
+		TSharedRef<FJsonObject> RowObject = MakeShared<FJsonObject>();
+		RowObject->SetNumberField(TEXT("Characters"), Characters.Num());
+		RowObject->SetNumberField(TEXT("AnimMsMean"), AnimMsSummary.Mean);
+		RowObject->SetNumberField(TEXT("AnimMsP95"), AnimMsSummary.P95);
+		RowObject->SetNumberField(TEXT("AnimTicksMean"), Summarize(AnimTicks).Mean);
+		RowObject->SetNumberField(TEXT("WorldTickMsMean"), Summarize(WorldTickMs).Mean);
+		AnimScalingRows.Add(MakeShared<FJsonValueObject>(RowObject));
+	}
+	Cleanup();
+
+	// Next character count of the scaling run
+	if (++CharacterCountIndex < Settings.CharacterCounts.Num())
+	{
+		Settings.NumCharacters = Settings.CharacterCounts[CharacterCountIndex];
+		StartRun();
+		return;
+	}
+	if (AnimScalingRows.Num() > 0) WriteAnimScalingReport();
+
+	if (Settings.bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bAllRunsPassed ? 0 : 1);
+	}
+}
+
+void UTraversalBenchmarkSubsystem::BuildCourse()
+{
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (CubeMesh == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Traversal benchmark: could not load the engine cube mesh"));
+		return;
+	}
+
+	// One lane per character so they don't run into each other. Along +X each lane has
+	// a ledge to hang from, a corridor to wall run in, then a tall and a short cover
+	LaneStarts.Reset(Settings.NumCharacters);
+	for (int32 LaneIndex = 0; LaneIndex < Settings.NumCharacters; ++LaneIndex)
+	{
+		const FVector LaneOrigin = CourseOrigin + FVector(0.f, LaneIndex * LaneWidth, 0.f);
+		LaneStarts.Add(LaneOrigin + FVector(100.f, 0.f, 100.f));
+
+		SpawnCourseBox(CubeMesh, LaneOrigin + FVector(LaneLength / 2, 0.f, -10.f), FVector(LaneLength, LaneWidth, 20.f), false);
+		SpawnCourseBox(CubeMesh, LaneOrigin + FVector(900.f, 0.f, 90.f), FVector(200.f, 500.f, 180.f));
+		SpawnCourseBox(CubeMesh, LaneOrigin + FVector(2300.f, 120.f, 200.f), FVector(1400.f, 40.f, 400.f));
+		SpawnCourseBox(CubeMesh, LaneOrigin + FVector(2300.f, -120.f, 200.f), FVector(1400.f, 40.f, 400.f));
+		SpawnCourseBox(CubeMesh, LaneOrigin + FVector(3600.f, 0.f, 100.f), FVector(60.f, 300.f, 200.f));
+		SpawnCourseBox(CubeMesh, LaneOrigin + FVector(4200.f, 0.f, 50.f), FVector(60.f, 300.f, 100.f));
+	}
+}
+
+void UTraversalBenchmarkSubsystem::SpawnCourseBox(UStaticMesh* CubeMesh, const FVector& Center, const FVector& Size, const bool bTraversable /*= true*/)
+{
+	// The engine cube is 100 units wide. Spawn deferred so the mesh is set before the static component registers
+	const FTransform Transform(FRotator::ZeroRotator, Center, Size / 100.f);
+	AStaticMeshActor* BoxActor = GetWorld()->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (BoxActor == nullptr) return;
+
+	BoxActor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	if (bTraversable)
+	{
+		UTraversableComponent* Traversable = NewObject<UTraversableComponent>(BoxActor, TEXT("Traversable"));
+		BoxActor->AddInstanceComponent(Traversable);
+		Traversable->RegisterComponent();
+	}
+	BoxActor->FinishSpawning(Transform);
+	CourseActors.Add(BoxActor);
+}
+
+void UTraversalBenchmarkSubsystem::SpawnCharacters()
+{
+	// Use the game's character blueprint if there is one so the benchmark includes its animation cost
+	TSubclassOf<AThirdPersonDemoCharacter> CharacterClass = AThirdPersonDemoCharacter::StaticClass();
+	if (const AGameModeBase* GameMode = GetWorld()->GetAuthGameMode())
+	{
+		if (GameMode->DefaultPawnClass != nullptr && GameMode->DefaultPawnClass->IsChildOf(AThirdPersonDemoCharacter::StaticClass()))
+		{
+			CharacterClass = *GameMode->DefaultPawnClass;
+		}
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	Characters.Reset(LaneStarts.Num());
+	for (const FVector& LaneStart : LaneStarts)
+	{
+		AThirdPersonDemoCharacter* Character = GetWorld()->SpawnActor<AThirdPersonDemoCharacter>(CharacterClass, LaneStart, FRotator::ZeroRotator, SpawnParameters);
+		if (Character == nullptr) continue;
+
+		// Scripted input needs a controller to hold the control rotation
+		if (Character->Controller == nullptr) Character->SpawnDefaultController();
+		Characters.Add(Character);
+	}
+}
+
+void UTraversalBenchmarkSubsystem::Cleanup()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	for (AThirdPersonDemoCharacter* Character : Characters)
+	{
+		if (!IsValid(Character)) continue;
+
+		if (AController* CharacterController = Character->Controller)
+		{
+			CharacterController->UnPossess();
+			CharacterController->Destroy();
+		}
+		Character->Destroy();
+	}
+	Characters.Reset();
+
+	for (AActor* CourseActor : CourseActors)
+	{
+		if (IsValid(CourseActor)) CourseActor->Destroy();
+	}
+	CourseActors.Reset();
+
+	bRunning = false;
+}
+
+FTraversalInputFrame UTraversalBenchmarkSubsystem::MakeScriptedInput(const int32 CharacterIndex, const int32 Frame) const
+{
+	const int32 Phase = (Frame + CharacterIndex * 7) % ScriptPeriod;
+
+	// Run down the lane, weaving into the corridor walls, jumping at the ledge and in the corridor,
+	// then take cover, aim out of it and take cover again
+	FTraversalInputFrame Input;
+	Input.MoveForward = IsInWindow(Phase, 335, 360) ? 0.f : 1.f;
+	Input.MoveRight = 0.5f * FMath::Sin(Phase * 0.1f);
+
+	if (IsInWindow(Phase, 50, 58) || IsInWindow(Phase, 130, 138) || IsInWindow(Phase, 200, 208)) Input.Actions |= ETraversalInputAction::Jump;
+	if (IsInWindow(Phase, 75, 80)) Input.Actions |= ETraversalInputAction::ClimbUp;
+	if (IsInWindow(Phase, 110, 113)) Input.Actions |= ETraversalInputAction::DropDown;
+	if (IsInWindow(Phase, 330, 335) || IsInWindow(Phase, 400, 405)) Input.Actions |= ETraversalInputAction::ToggleCover;
+	if (IsInWindow(Phase, 360, 380)) Input.Actions |= ETraversalInputAction::Aim;
+
+	return Input;
+}
+
+void UTraversalBenchmarkSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld()) return;
+
+	// Whole frame time of the previous recorded frame
+	const double Now = FPlatformTime::Seconds();
+	if (Frames.Num() > 0 && FrameIndex > Settings.WarmupFrames)
+	{
+		Frames.Last().FrameMs = static_cast<float>((Now - WorldTickStartTime) * 1000.0);
+	}
+
+	if (FrameIndex >= Settings.WarmupFrames + Settings.NumFrames)
+	{
+		StopBenchmark();
+		return;
+	}
+
+	WorldTickStartTime = Now;
+	TraceCountAtTickStart = GTraversalTraceCount;
+	AnimCyclesAtTickStart = GTraversalAnimCycles;
+	AnimTicksAtTickStart = GTraversalAnimTicks;
+#if UE_STATS
+	MallocCallsAtTickStart = FMalloc::TotalMallocCalls.Load();
+#endif
+
+	for (int32 CharacterIndex = 0; CharacterIndex < Characters.Num(); ++CharacterIndex)
+	{
+		AThirdPersonDemoCharacter* Character = Characters[CharacterIndex];
+		if (!IsValid(Character)) continue;
+
+		// Send the character back to the start of its lane when the script loops
+		const int32 Phase = (FrameIndex + CharacterIndex * 7) % ScriptPeriod;
+		if (Phase == 0 && FrameIndex > 0)
+		{
+			Character->GetCharacterMovement()->StopMovementImmediately();
+			Character->SetActorLocationAndRotation(LaneStarts[CharacterIndex], FRotator::ZeroRotator, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+
+		Character->SetScriptedInput(MakeScriptedInput(CharacterIndex, FrameIndex));
+	}
+}
+
+void UTraversalBenchmarkSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld()) return;
+
+	if (FrameIndex++ < Settings.WarmupFrames) return;
+
+	FTraversalBenchmarkFrame& Frame = Frames.AddDefaulted_GetRef();
+	Frame.WorldTickMs = static_cast<float>((FPlatformTime::Seconds() - WorldTickStartTime) * 1000.0);
+	Frame.Traces = static_cast<int32>(GTraversalTraceCount - TraceCountAtTickStart);
+	Frame.AnimMs = static_cast<float>(FPlatformTime::ToMilliseconds64(GTraversalAnimCycles - AnimCyclesAtTickStart));
+	Frame.AnimTicks = static_cast<int32>(GTraversalAnimTicks - AnimTicksAtTickStart);
+#if UE_STATS
+	Frame.Allocations = static_cast<int32>(FMalloc::TotalMallocCalls.Load() - MallocCallsAtTickStart);
+#endif
+
+	if (const UTraversalTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UTraversalTickSubsystem>())
+	{
+		Frame.TraversalMs = static_cast<float>(TickSubsystem->GetLastBatchSeconds() * 1000.0);
+	}
+}
+
+bool UTraversalBenchmarkSubsystem::WriteReport()
+{
+	const FString ReportDir = FPaths::ProfilingDir() / TEXT("Traversal");
+	const FString ReportName = FString::Printf(TEXT("TraversalBenchmark-%s"), *FDateTime::Now().ToString());
+
+	// Per frame CSV
+	FString Csv = TEXT("Frame,FrameMs,WorldTickMs,TraversalMs,Traces,AnimMs,AnimTicks,Allocations\n");
+	for (int32 Index = 0; Index < Frames.Num(); ++Index)
+	{
+		const FTraversalBenchmarkFrame& Frame = Frames[Index];
+		Csv += FString::Printf(TEXT("%d,%.4f,%.4f,%.4f,%d,%.4f,%d,%d\n"), Index, Frame.FrameMs, Frame.WorldTickMs, Frame.TraversalMs, Frame.Traces, Frame.AnimMs, Frame.AnimTicks, Frame.Allocations);
+	}
+	FFileHelper::SaveStringToFile(Csv, *(ReportDir / ReportName + TEXT(".csv")));
+
+	// JSON summary
+	TArray<TPair<FString, TArray<float>>> Metrics;
+	Metrics.Emplace(TEXT("FrameMs"), TArray<float>());
+	Metrics.Emplace(TEXT("WorldTickMs"), TArray<float>());
+	Metrics.Emplace(TEXT("TraversalMs"), TArray<float>());
+	Metrics.Emplace(TEXT("Traces"), TArray<float>());
+	Metrics.Emplace(TEXT("Allocations"), TArray<float>());
+	Metrics.Emplace(TEXT("AnimMs"), TArray<float>());
+	for (const FTraversalBenchmarkFrame& Frame : Frames)
+	{
+		Metrics[0].Value.Add(Frame.FrameMs);
+		Metrics[1].Value.Add(Frame.WorldTickMs);
+		Metrics[2].Value.Add(Frame.TraversalMs);
+		Metrics[3].Value.Add(Frame.Traces);
+		Metrics[4].Value.Add(Frame.Allocations);
+		Metrics[5].Value.Add(Frame.AnimMs);
+	}
+
+	TSharedRef<FJsonObject> SummaryObject = MakeShared<FJsonObject>();
+	for (const TPair<FString, TArray<float>>& Metric : Metrics)
+	{
+		const FMetricSummary Summary = Summarize(Metric.Value);
+		TSharedRef<FJsonObject> MetricObject = MakeShared<FJsonObject>();
+		MetricObject->SetNumberField(TEXT("Mean"), Summary.Mean);
+		MetricObject->SetNumberField(TEXT("P95"), Summary.P95);
+		MetricObject->SetNumberField(TEXT("Max"), Summary.Max);
+		SummaryObject->SetObjectField(Metric.Key, MetricObject);
+	}
+
+	TSharedRef<FJsonObject> ReportObject = MakeShared<FJsonObject>();
+	ReportObject->SetNumberField(TEXT("Characters"), Characters.Num());
+	ReportObject->SetNumberField(TEXT("Frames"), Frames.Num());
+	ReportObject->SetObjectField(TEXT("Summary"), SummaryObject);
+
+	// Compare every metric with the baseline report if there is one
+	bool bPassed = true;
+	if (!Settings.BaselinePath.IsEmpty())
+	{
+		FString BaselineString;
+		TSharedPtr<FJsonObject> BaselineObject;
+		if (!FFileHelper::LoadFileToString(BaselineString, *Settings.BaselinePath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineString), BaselineObject) || !BaselineObject.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Traversal benchmark: could not read baseline %s"), *Settings.BaselinePath);
+			bPassed = false;
+		}
+		else
+		{
+			const TSharedPtr<FJsonObject>* BaselineSummary = nullptr;
+			BaselineObject->TryGetObjectField(TEXT("Summary"), BaselineSummary);
+
+			TArray<TSharedPtr<FJsonValue>> Regressions;
+			for (const TPair<FString, TArray<float>>& Metric : Metrics)
+			{
+				const TSharedPtr<FJsonObject>* BaselineMetric = nullptr;
+				if (BaselineSummary == nullptr || !(*BaselineSummary)->TryGetObjectField(Metric.Key, BaselineMetric)) continue;
+
+				const auto CheckStatistic = [&](const TCHAR* StatisticName, const float Value)
+				{
+					double BaselineValue = 0.0;
+					if (!(*BaselineMetric)->TryGetNumberField(StatisticName, BaselineValue) || BaselineValue <= 0.0) return;
+					if (Value <= BaselineValue * (1.0 + Settings.RegressionThreshold)) return;
+
+					const FString Regression = FString::Printf(TEXT("%s %s: %.3f -> %.3f"), *Metric.Key, StatisticName, BaselineValue, Value);
+					UE_LOG(LogTemp, Error, TEXT("Traversal benchmark regression: %s"), *Regression);
+					Regressions.Add(MakeShared<FJsonValueString>(Regression));
+					bPassed = false;
+				};
+
+				const FMetricSummary Summary = Summarize(Metric.Value);
+				CheckStatistic(TEXT("Mean"), Summary.Mean);
+				CheckStatistic(TEXT("P95"), Summary.P95);
+			}
+			ReportObject->SetStringField(TEXT("Baseline"), Settings.BaselinePath);
+			ReportObject->SetArrayField(TEXT("Regressions"), Regressions);
+		}
+	}
+	ReportObject->SetBoolField(TEXT("Passed"), bPassed);
+
+	FString Json;
+	FJsonSerializer::Serialize(ReportObject, TJsonWriterFactory<>::Create(&Json));
+	const FString JsonPath = ReportDir / ReportName + TEXT(".json");
+	FFileHelper::SaveStringToFile(Json, *JsonPath);
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal benchmark %s, report written to %s"), bPassed ? TEXT("passed") : TEXT("failed"), *JsonPath);
+	return bPassed;
+}
+
+void UTraversalBenchmarkSubsystem::WriteAnimScalingReport()
+{
+	TSharedRef<FJsonObject> ReportObject = MakeShared<FJsonObject>();
+	ReportObject->SetNumberField(TEXT("Frames"), Settings.NumFrames);
+	ReportObject->SetArrayField(TEXT("Runs"), AnimScalingRows);
+
+	FString Json;
+	FJsonSerializer::Serialize(ReportObject, TJsonWriterFactory<>::Create(&Json));
+	const FString JsonPath = FPaths::ProfilingDir() / TEXT("Traversal") / FString::Printf(TEXT("TraversalAnimScaling-%s.json"), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(Json, *JsonPath);
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal animation scaling report written to %s"), *JsonPath);
+}
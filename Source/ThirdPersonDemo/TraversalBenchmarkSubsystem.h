@@ -0,0 +1,144 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TraversalInput.h"
+#include "TraversalBenchmarkSubsystem.generated.h"
+
+class AThirdPersonDemoCharacter;
+class FJsonValue;
+class UStaticMesh;
+
+/** Parameters of a benchmark run, parsed from the Traversal.Benchmark command line **/
+struct FTraversalBenchmarkSettings
+{
+	/** Characters spawned, one course lane each **/
+	int32 NumCharacters = 32;
+
+	/** Frames recorded, after the warmup **/
+	int32 NumFrames = 600;
+
+	/** Frames run before recording starts **/
+	int32 WarmupFrames = 60;
+
+	/** Report of a previous run to compare against. No comparison if empty **/
+	FString BaselinePath;
+
+	/** Relative increase over the baseline reported as a regression **/
+	float RegressionThreshold = 0.1f;
+
+	/** Exit when done, with a non zero exit code on regression **/
+	bool bQuitWhenDone = false;
+
+	/** Character counts to run one after the other, replacing NumCharacters, for the animation scaling report **/
+	TArray<int32> CharacterCounts;
+};
+
+/** Measurements of a single recorded frame **/
+struct FTraversalBenchmarkFrame
+{
+	/** Wall time of the whole frame **/
+	float FrameMs = 0.f;
+
+	/** Game thread time from the start of the world tick to the end of actor ticking **/
+	float WorldTickMs = 0.f;
+
+	/** Game thread time of the traversal batch **/
+	float TraversalMs = 0.f;
+
+	int32 Traces = 0;
+
+	/** Game thread time and number of traversal character mesh ticks **/
+	float AnimMs = 0.f;
+	int32 AnimTicks = 0;
+
+	/** Heap allocations during the world tick. -1 if the build does not track them **/
+	int32 Allocations = -1;
+};
+
+/**
+ * Headless traversal benchmark. Builds a course of ledges, wall run corridors and cover away from the level,
+ * spawns characters driven by scripted input and records per-frame cost to a CSV and a JSON report.
+ *
+ * Run with: -game -nullrhi -ExecCmds="Traversal.Benchmark Characters=64 Frames=600 Baseline=<report.json> Quit"
+ * Animation cost against character count: -ExecCmds="Traversal.Benchmark CharacterCounts=16,64,256 Quit"
+ * As an automation test: -game -nullrhi -ExecCmds="Automation RunTests ThirdPersonDemo.Traversal.Benchmark; Quit" -TraversalBenchmarkBaseline=<report.json>
+ */
+UCLASS()
+class UTraversalBenchmarkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Build the course, spawn the characters and start recording. Returns false if a run is already in progress **/
+	bool StartBenchmark(const FTraversalBenchmarkSettings& InSettings);
+
+	/** Stop the current run, write the report and clean up **/
+	void StopBenchmark();
+
+	bool IsRunning() const { return bRunning; }
+
+	/** False if a run of the last benchmark regressed against its baseline, or the baseline could not be read **/
+	bool HasPassed() const { return bAllRunsPassed; }
+
+private:
+	/** Start a single run with Settings.NumCharacters **/
+	void StartRun();
+
+	/** Spawn the static geometry of every lane **/
+	void BuildCourse();
+
+	/** Spawn one static box of the course. Everything but the floor is traversable, so probes are culled between obstacles **/
+	void SpawnCourseBox(UStaticMesh* CubeMesh, const FVector& Center, const FVector& Size, const bool bTraversable = true);
+
+	void SpawnCharacters();
+
+	/** Destroy everything the run spawned **/
+	void Cleanup();
+
+	/** Scripted input of a character on a frame. Deterministic, characters are offset in time so they don't all act together **/
+	FTraversalInputFrame MakeScriptedInput(const int32 CharacterIndex, const int32 Frame) const;
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Write the per frame CSV and the JSON summary, and compare with the baseline. Returns false on regression **/
+	bool WriteReport();
+
+	/** Write the animation cost of every run of Settings.CharacterCounts **/
+	void WriteAnimScalingReport();
+
+	FTraversalBenchmarkSettings Settings;
+	bool bRunning = false;
+	int32 FrameIndex = 0;
+
+	/** Run of Settings.CharacterCounts in progress, and the animation scaling report rows of the runs before it **/
+	int32 CharacterCountIndex = 0;
+	TArray<TSharedPtr<FJsonValue>> AnimScalingRows;
+
+	/** False once any run of the benchmark regressed **/
+	bool bAllRunsPassed = true;
+
+	UPROPERTY()
+	TArray<AActor*> CourseActors;
+
+	UPROPERTY()
+	TArray<AThirdPersonDemoCharacter*> Characters;
+
+	TArray<FVector> LaneStarts;
+	TArray<FTraversalBenchmarkFrame> Frames;
+
+	double WorldTickStartTime = 0.0;
+	uint32 TraceCountAtTickStart = 0;
+	uint64 AnimCyclesAtTickStart = 0;
+	uint32 AnimTicksAtTickStart = 0;
+	uint64 MallocCallsAtTickStart = 0;
+
+	FDelegateHandle TickStartHandle;
+	FDelegateHandle PostActorTickHandle;
+};
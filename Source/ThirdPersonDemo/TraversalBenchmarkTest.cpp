@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "TraversalBenchmarkSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Fixed so reports of different runs compare **/
+	constexpr int32 TestCharacters = 32;
+	constexpr int32 TestFrames = 300;
+	constexpr int32 TestWarmupFrames = 60;
+
+	/** Wall time after which a run that never finishes fails the test, e.g. when the world does not tick **/
+	constexpr double TestTimeoutSeconds = 300.0;
+
+	UWorld* FindGameWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.World() != nullptr)
+			{
+				return Context.World();
+			}
+		}
+		return nullptr;
+	}
+}
+
+/** Waits for the benchmark to finish recording, then fails the test if it regressed **/
+class FWaitForTraversalBenchmarkCommand : public IAutomationLatentCommand
+{
+public:
+	FWaitForTraversalBenchmarkCommand(FAutomationTestBase* InTest, UTraversalBenchmarkSubsystem* InBenchmarkSubsystem)
+		: Test(InTest)
+		, BenchmarkSubsystem(InBenchmarkSubsystem)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		UTraversalBenchmarkSubsystem* Subsystem = BenchmarkSubsystem.Get();
+		if (Subsystem == nullptr)
+		{
+			Test->AddError(TEXT("The world was torn down before the traversal benchmark finished"));
+			return true;
+		}
+
+		if (Subsystem->IsRunning())
+		{
+			if (GetCurrentRunTime() < TestTimeoutSeconds) return false;
+
+			Test->AddError(FString::Printf(TEXT("The traversal benchmark did not finish within %.0f s"), TestTimeoutSeconds));
+			Subsystem->StopBenchmark();
+			return true;
+		}
+
+		if (!Subsystem->HasPassed())
+		{
+			Test->AddError(TEXT("The traversal benchmark regressed against its baseline, see the report in Saved/Profiling/Traversal"));
+		}
+		return true;
+	}
+
+private:
+	FAutomationTestBase* Test;
+	TWeakObjectPtr<UTraversalBenchmarkSubsystem> BenchmarkSubsystem;
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTraversalBenchmarkTest, "ThirdPersonDemo.Traversal.Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FTraversalBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// The course is built procedurally away from the level, so any game world will do
+	UWorld* World = FindGameWorld();
+	UTraversalBenchmarkSubsystem* BenchmarkSubsystem = World != nullptr ? World->GetSubsystem<UTraversalBenchmarkSubsystem>() : nullptr;
+	if (BenchmarkSubsystem == nullptr)
+	{
+		AddError(TEXT("The traversal benchmark needs a game world, run the test with -game"));
+		return false;
+	}
+
+	FTraversalBenchmarkSettings Settings;
+	Settings.NumCharacters = TestCharacters;
+	Settings.NumFrames = TestFrames;
+	Settings.WarmupFrames = TestWarmupFrames;
+	FParse::Value(FCommandLine::Get(), TEXT("TraversalBenchmarkBaseline="), Settings.BaselinePath);
+	FParse::Value(FCommandLine::Get(), TEXT("TraversalBenchmarkThreshold="), Settings.RegressionThreshold);
+	if (Settings.BaselinePath.IsEmpty())
+	{
+		AddWarning(TEXT("No -TraversalBenchmarkBaseline=<report.json>, the run is recorded but not compared"));
+	}
+
+	if (!BenchmarkSubsystem->StartBenchmark(Settings))
+	{
+		AddError(TEXT("A traversal benchmark is already running"));
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForTraversalBenchmarkCommand(this, BenchmarkSubsystem));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
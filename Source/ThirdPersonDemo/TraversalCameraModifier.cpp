@@ -0,0 +1,147 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalCameraModifier.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "ThirdPersonDemoCharacter.h"
+#include "TraversalStats.h"
+
+namespace
+{
+	/** Critically damped spring towards Target, settling in about SmoothTime. From Game Programming Gems 4, 1.10 **/
+	template<typename ValueType>
+	void SmoothCriticallyDamped(ValueType& Value, ValueType& Velocity, const ValueType& Target, const float SmoothTime, const float DeltaTime)
+	{
+		if (SmoothTime <= 0.f)
+		{
+			Value = Target;
+			Velocity = ValueType(0.f);
+			return;
+		}
+
+		const float Omega = 2.f / SmoothTime;
+		const float X = Omega * DeltaTime;
+		const float Exp = 1.f / (1.f + X + 0.48f * X * X + 0.235f * X * X * X);
+		const ValueType Change = Value - Target;
+		const ValueType Temp = (Velocity + Change * Omega) * DeltaTime;
+		Velocity = (Velocity - Temp * Omega) * Exp;
+		Value = Target + (Change + Temp) * Exp;
+	}
+}
+
+bool UTraversalCameraModifier::ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV)
+{
+	Super::ModifyCamera(DeltaTime, InOutPOV);
+
+	const AThirdPersonDemoCharacter* Character = Cast<AThirdPersonDemoCharacter>(CameraOwner ? CameraOwner->GetViewTarget() : nullptr);
+	if (Character == nullptr) return false;
+
+	SCOPE_CYCLE_COUNTER(STAT_TraversalCameraRig);
+
+	// Start a new view target settled, and forget the sweeps around the previous one
+	if (Character != LastViewTarget.Get())
+	{
+		LastViewTarget = Character;
+		Offset = Character->GetTargetCameraOffset();
+		ArmLength = Character->GetTargetCameraBoomLength();
+		OffsetVelocity = FVector::ZeroVector;
+		ArmLengthVelocity = 0.f;
+		bSettled = true;
+		bHasProbeResult = false;
+		PendingProbeHandle = FTraceHandle();
+	}
+
+	UpdateSprings(*Character, DeltaTime);
+
+	// Same placement as the spring arm, which no longer offsets, resizes or collides itself
+	const USpringArmComponent* CameraBoom = Character->GetCameraBoom();
+	const FVector Pivot = CameraBoom->GetComponentLocation() + CameraBoom->TargetOffset;
+	const FRotationMatrix ViewAxes(InOutPOV.Rotation);
+	const FVector DesiredLocation = Pivot - ViewAxes.GetUnitAxis(EAxis::X) * ArmLength + ViewAxes.TransformVector(Offset);
+
+	InOutPOV.Location = Pivot + (DesiredLocation - Pivot) * ProbeBoom(Character, Pivot, DesiredLocation);
+	return false;
+}
+
+void UTraversalCameraModifier::UpdateSprings(const AThirdPersonDemoCharacter& Character, const float DeltaTime)
+{
+	const FVector TargetOffset = Character.GetTargetCameraOffset();
+	const float TargetArmLength = Character.GetTargetCameraBoomLength();
+
+	// Dormant until the character picks new targets
+	if (bSettled && Offset == TargetOffset && ArmLength == TargetArmLength) return;
+
+	const float SmoothTime = Character.GetCameraSmoothTime();
+	SmoothCriticallyDamped(Offset, OffsetVelocity, TargetOffset, SmoothTime, DeltaTime);
+	SmoothCriticallyDamped(ArmLength, ArmLengthVelocity, TargetArmLength, SmoothTime, DeltaTime);
+
+	bSettled = Offset.Equals(TargetOffset, SettleTolerance) && OffsetVelocity.IsNearlyZero(SettleTolerance)
+		&& FMath::IsNearlyEqual(ArmLength, TargetArmLength, SettleTolerance) && FMath::IsNearlyZero(ArmLengthVelocity, SettleTolerance);
+	if (bSettled)
+	{
+		Offset = TargetOffset;
+		ArmLength = TargetArmLength;
+		OffsetVelocity = FVector::ZeroVector;
+		ArmLengthVelocity = 0.f;
+	}
+}
+
+float UTraversalCameraModifier::ProbeBoom(const AActor* ViewTarget, const FVector& Start, const FVector& End)
+{
+	UWorld* World = ViewTarget->GetWorld();
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalCameraProbe), false, ViewTarget);
+	const FCollisionShape ProbeShape = FCollisionShape::MakeSphere(ProbeSize);
+
+	// Async results come back on the next frame. Forget a sweep that didn't, e.g. across a world change
+	if (PendingProbeHandle.IsValid() && GFrameCounter > PendingProbeFrame + 2)
+	{
+		PendingProbeHandle = FTraceHandle();
+	}
+
+	// Keep using the last sweep while the boom stays close to where it was swept. Otherwise clamp with a sync sweep,
+	// so cuts and teleports never show the camera inside geometry
+	const float MaxStalenessSquared = FMath::Square(MaxProbeStaleness);
+	const bool bProbeResultUsable = bHasProbeResult && FVector::DistSquared(ProbeResultStart, Start) <= MaxStalenessSquared && FVector::DistSquared(ProbeResultEnd, End) <= MaxStalenessSquared;
+	if (!bProbeResultUsable)
+	{
+		INC_DWORD_STAT(STAT_TraversalTraces);
+		INC_DWORD_STAT(STAT_TraversalCameraSyncProbes);
+		++GTraversalTraceCount;
+
+		FHitResult HitResult;
+		const bool bHit = World->SweepSingleByChannel(HitResult, Start, End, FQuat::Identity, ProbeChannel, ProbeShape, QueryParams);
+		bHasProbeResult = true;
+		ProbeResultStart = Start;
+		ProbeResultEnd = End;
+		ProbeResultFraction = bHit ? HitResult.Time : 1.f;
+	}
+
+	// Only sweep again once the boom moved, a settled camera behind a character standing still sweeps nothing
+	const bool bBoomMoved = !ProbeResultStart.Equals(Start, KINDA_SMALL_NUMBER) || !ProbeResultEnd.Equals(End, KINDA_SMALL_NUMBER);
+	if (bBoomMoved && !PendingProbeHandle.IsValid())
+	{
+		if (!BoomProbeDelegate.IsBound())
+		{
+			BoomProbeDelegate.BindUObject(this, &UTraversalCameraModifier::OnBoomProbeDone);
+		}
+
+		INC_DWORD_STAT(STAT_TraversalAsyncTraces);
+		++GTraversalTraceCount;
+		PendingProbeHandle = World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, ProbeChannel, ProbeShape, QueryParams, FCollisionResponseParams::DefaultResponseParam, &BoomProbeDelegate);
+		PendingProbeFrame = GFrameCounter;
+	}
+
+	return ProbeResultFraction;
+}
+
+void UTraversalCameraModifier::OnBoomProbeDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (TraceHandle != PendingProbeHandle) return;
+
+	PendingProbeHandle = FTraceHandle();
+	bHasProbeResult = true;
+	ProbeResultStart = TraceDatum.Start;
+	ProbeResultEnd = TraceDatum.End;
+	ProbeResultFraction = TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit ? TraceDatum.OutHits[0].Time : 1.f;
+}
@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/CameraModifier.h"
+#include "WorldCollision.h"
+#include "TraversalCameraModifier.generated.h"
+
+class AThirdPersonDemoCharacter;
+
+/**
+ * Camera rig of traversal characters. Places the camera the way their spring arm would, with the offset and boom length
+ * following the targets of the character through critically damped springs that go dormant once settled.
+ * Boom collision uses last frame's async sweep, with a sync sweep when the boom moved too far since.
+ */
+UCLASS()
+class UTraversalCameraModifier : public UCameraModifier
+{
+	GENERATED_BODY()
+
+public:
+	/** Radius of the boom collision sweep **/
+	UPROPERTY(EditAnywhere, Category = "Boom Collision")
+	float ProbeSize = 12.f;
+
+	UPROPERTY(EditAnywhere, Category = "Boom Collision")
+	TEnumAsByte<ECollisionChannel> ProbeChannel = ECC_Camera;
+
+	/** Farthest either end of the boom can move away from last frame's sweep before it is swept again synchronously **/
+	UPROPERTY(EditAnywhere, Category = "Boom Collision")
+	float MaxProbeStaleness = 20.f;
+
+	/** Springs go dormant once this close to their target and this slow **/
+	UPROPERTY(EditAnywhere, Category = "Springs")
+	float SettleTolerance = 0.1f;
+
+	virtual bool ModifyCamera(float DeltaTime, struct FMinimalViewInfo& InOutPOV) override;
+
+	/** Returns true while the springs are dormant **/
+	bool IsSettled() const { return bSettled; }
+
+private:
+	/** Move the springs towards the camera targets of the character, unless they are settled on them **/
+	void UpdateSprings(const AThirdPersonDemoCharacter& Character, const float DeltaTime);
+
+	/** Returns the fraction of the boom from Start to End that is free of collision **/
+	float ProbeBoom(const AActor* ViewTarget, const FVector& Start, const FVector& End);
+
+	/** Called by the async trace system when the boom sweep finishes **/
+	void OnBoomProbeDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Spring state: camera offset in view space and boom length **/
+	FVector Offset = FVector::ZeroVector;
+	FVector OffsetVelocity = FVector::ZeroVector;
+	float ArmLength = 0.f;
+	float ArmLengthVelocity = 0.f;
+	bool bSettled = false;
+
+	/** Springs are snapped to the targets of a new view target **/
+	TWeakObjectPtr<const AThirdPersonDemoCharacter> LastViewTarget;
+
+	/** Async sweep in flight **/
+	FTraceDelegate BoomProbeDelegate;
+	FTraceHandle PendingProbeHandle;
+	uint64 PendingProbeFrame = 0;
+
+	/** Most recent sweep result, async or sync **/
+	bool bHasProbeResult = false;
+	FVector ProbeResultStart = FVector::ZeroVector;
+	FVector ProbeResultEnd = FVector::ZeroVector;
+	float ProbeResultFraction = 1.f;
+};
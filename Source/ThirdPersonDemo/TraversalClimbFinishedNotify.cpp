@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalClimbFinishedNotify.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "ThirdPersonDemoCharacter.h"
+
+FString UTraversalClimbFinishedNotify::GetNotifyName_Implementation() const
+{
+	return TEXT("Climb Finished");
+}
+
+void UTraversalClimbFinishedNotify::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	Super::Notify(MeshComp, Animation);
+
+	// Same as the montage blending out: only where traversal is predicted, the server follows the client's moves
+	AThirdPersonDemoCharacter* Character = MeshComp != nullptr ? Cast<AThirdPersonDemoCharacter>(MeshComp->GetOwner()) : nullptr;
+	if (Character == nullptr || !Character->IsTraversalLocallyPredicted()) return;
+
+	Character->OnClimbUpFinished();
+}
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "TraversalClimbFinishedNotify.generated.h"
+
+/**
+ * Place in the climb montage where the character should be moved onto the ledge.
+ * Without it climbing finishes when the montage starts blending out.
+ */
+UCLASS(meta = (DisplayName = "Traversal Climb Finished"))
+class UTraversalClimbFinishedNotify : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	virtual FString GetNotifyName_Implementation() const override;
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
+};
@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalDebug.h"
+
+#if WITH_TRAVERSAL_DEBUG
+
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarTraversalDebugDraw(
+	TEXT("traversal.Debug.Draw"),
+	1,
+	TEXT("Draw recorded traversal probes. 0: off, 1: characters with bDrawDebug set, 2: every character."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarTraversalDebugFrames(
+	TEXT("traversal.Debug.Frames"),
+	30,
+	TEXT("Number of past frames of traversal probes to draw."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarTraversalDebugLog(
+	TEXT("traversal.Debug.Log"),
+	0,
+	TEXT("Log every traversal probe as it is recorded."),
+	ECVF_Cheat);
+
+static FAutoConsoleCommand TraversalDebugDumpCommand(
+	TEXT("Traversal.Debug.Dump"),
+	TEXT("Log the recorded traversal probes. Args: Frames=<traversal.Debug.Frames>"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const FString CommandLine = FString::Join(Args, TEXT(" "));
+		uint32 NumFrames = CVarTraversalDebugFrames.GetValueOnGameThread();
+		FParse::Value(*CommandLine, TEXT("Frames="), NumFrames);
+
+		int32 NumRecords = 0;
+		TraversalDebug::ForEachRecentRecord(NumFrames, [&NumRecords](const FTraversalProbeRecord& Record)
+		{
+			const AActor* Actor = Record.Actor.Get();
+			UE_LOG(LogTemp, Log, TEXT("[%llu] %s %s %s -> %s: %s"), Record.FrameNumber, Actor ? *Actor->GetName() : TEXT("None"), TraversalDebug::GetProbeName(Record.Probe),
+				*Record.TraceStart.ToCompactString(), *Record.TraceEnd.ToCompactString(), Record.bHit ? *Record.ImpactPoint.ToCompactString() : TEXT("no hit"));
+			++NumRecords;
+		});
+		UE_LOG(LogTemp, Log, TEXT("%d traversal probes in the last %u frames"), NumRecords, NumFrames);
+	}));
+
+namespace
+{
+	/** Enough for every probe of a few characters over traversal.Debug.Frames frames **/
+	constexpr int32 MaxProbeRecords = 1024;
+
+	FTraversalProbeRecord ProbeRecords[MaxProbeRecords];
+
+	/** Total records added, the next one goes to ProbeRecords[NumRecorded % MaxProbeRecords] **/
+	uint64 NumRecorded = 0;
+
+	FDelegateHandle DrawHandle;
+
+	void DrawRecentProbes(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		const int32 DrawMode = CVarTraversalDebugDraw.GetValueOnGameThread();
+		if (DrawMode <= 0) return;
+
+		// Drawn for one frame and drawn again next frame, so lines never outlive the frames they belong to
+		TraversalDebug::ForEachRecentRecord(CVarTraversalDebugFrames.GetValueOnGameThread(), [World, DrawMode](const FTraversalProbeRecord& Record)
+		{
+			const AActor* Actor = Record.Actor.Get();
+			if (Actor == nullptr || Actor->GetWorld() != World) return;
+			if (DrawMode < 2 && !Record.bDrawRequested) return;
+
+			// Same colors as the kismet trace debug draw
+			if (Record.bHit)
+			{
+				DrawDebugLine(World, Record.TraceStart, Record.ImpactPoint, FColor::Red);
+				DrawDebugLine(World, Record.ImpactPoint, Record.TraceEnd, FColor::Green);
+				DrawDebugPoint(World, Record.ImpactPoint, 16.f, FColor::Red);
+			}
+			else
+			{
+				DrawDebugLine(World, Record.TraceStart, Record.TraceEnd, FColor::Red);
+			}
+		});
+	}
+}
+
+void TraversalDebug::RecordProbe(const AActor* Actor, const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd, const bool bHit, const FVector& ImpactPoint, const bool bDrawRequested)
+{
+	check(IsInGameThread());
+
+	if (!DrawHandle.IsValid())
+	{
+		DrawHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&DrawRecentProbes);
+	}
+
+	FTraversalProbeRecord& Record = ProbeRecords[NumRecorded++ % MaxProbeRecords];
+	Record.FrameNumber = GFrameCounter;
+	Record.Actor = Actor;
+	Record.TraceStart = TraceStart;
+	Record.TraceEnd = TraceEnd;
+	Record.ImpactPoint = ImpactPoint;
+	Record.Probe = Probe;
+	Record.bHit = bHit;
+	Record.bDrawRequested = bDrawRequested;
+
+	if (CVarTraversalDebugLog.GetValueOnGameThread() > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Traversal probe %s of %s: %s"), GetProbeName(Probe), Actor ? *Actor->GetName() : TEXT("None"), bHit ? *Record.ImpactPoint.ToCompactString() : TEXT("no hit"));
+	}
+}
+
+void TraversalDebug::ForEachRecentRecord(const uint32 NumFrames, TFunctionRef<void(const FTraversalProbeRecord&)> Visitor)
+{
+	const uint64 NumRecords = FMath::Min<uint64>(NumRecorded, MaxProbeRecords);
+	const uint64 OldestFrame = GFrameCounter >= NumFrames ? GFrameCounter - NumFrames + 1 : 0;
+
+	// Records are in frame order, so skip to the first one recent enough
+	uint64 RecordIndex = NumRecorded - NumRecords;
+	while (RecordIndex < NumRecorded && ProbeRecords[RecordIndex % MaxProbeRecords].FrameNumber < OldestFrame)
+	{
+		++RecordIndex;
+	}
+
+	for (; RecordIndex < NumRecorded; ++RecordIndex)
+	{
+		Visitor(ProbeRecords[RecordIndex % MaxProbeRecords]);
+	}
+}
+
+const TCHAR* TraversalDebug::GetProbeName(const ETraversalProbe Probe)
+{
+	switch (Probe)
+	{
+	case ETraversalProbe::LedgeScan: return TEXT("LedgeScan");
+	case ETraversalProbe::WallRunPrediction: return TEXT("WallRunPrediction");
+	case ETraversalProbe::SideWallRunRight: return TEXT("SideWallRunRight");
+	case ETraversalProbe::SideWallRunLeft: return TEXT("SideWallRunLeft");
+	case ETraversalProbe::DownWallRun: return TEXT("DownWallRun");
+	case ETraversalProbe::ForwardCoverTall: return TEXT("ForwardCoverTall");
+	case ETraversalProbe::ForwardCoverShort: return TEXT("ForwardCoverShort");
+	case ETraversalProbe::SideCoverRight: return TEXT("SideCoverRight");
+	case ETraversalProbe::SideCoverLeft: return TEXT("SideCoverLeft");
+	default: return TEXT("Unknown");
+	}
+}
+
+#endif
@@ -0,0 +1,47 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "TraversalProbeCache.h"
+
+/** Traversal probe recording and drawing. Compiled out of Shipping and Test builds **/
+#ifndef WITH_TRAVERSAL_DEBUG
+#define WITH_TRAVERSAL_DEBUG !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#endif
+
+#if WITH_TRAVERSAL_DEBUG
+
+/** A traversal probe as kept by the debug ring buffer **/
+struct FTraversalProbeRecord
+{
+	uint64 FrameNumber = 0;
+	TWeakObjectPtr<const AActor> Actor;
+	FVector TraceStart = FVector::ZeroVector;
+	FVector TraceEnd = FVector::ZeroVector;
+	FVector ImpactPoint = FVector::ZeroVector;
+	ETraversalProbe Probe = ETraversalProbe::Count;
+	bool bHit = false;
+
+	/** The actor asked for its probes to be drawn, see traversal.Debug.Draw **/
+	bool bDrawRequested = false;
+};
+
+/**
+ * Fixed-size ring buffer of the last traversal probes, drawn for the last traversal.Debug.Frames frames only.
+ * Replaces persistent debug lines, which piled up for as long as the character kept probing.
+ */
+namespace TraversalDebug
+{
+	/** Add a probe to the ring buffer, overwriting the oldest record once full **/
+	void RecordProbe(const AActor* Actor, const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd, const bool bHit, const FVector& ImpactPoint, const bool bDrawRequested);
+
+	/** Call Visitor with every record of the last NumFrames frames, oldest first **/
+	void ForEachRecentRecord(const uint32 NumFrames, TFunctionRef<void(const FTraversalProbeRecord&)> Visitor);
+
+	/** Readable name of a probe, for logs **/
+	const TCHAR* GetProbeName(const ETraversalProbe Probe);
+}
+
+#endif
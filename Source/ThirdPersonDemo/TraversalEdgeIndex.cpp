@@ -0,0 +1,570 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalEdgeIndex.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "ThirdPersonDemoCharacter.h"
+#include "TraversalMath.h"
+#include "TraversalStats.h"
+
+namespace
+{
+	/** Maximum number of coplanar faces followed when looking for an exposed cover corner **/
+	constexpr int32 MaxCornerSearchSteps = 8;
+
+	/** Distance under which two face corners are considered to touch **/
+	constexpr float CornerWeldDistance = 1.f;
+
+	/** Intersect a horizontal ray with a segment in the XY plane. Returns the distance along the ray, or a negative value on a miss **/
+	float IntersectRaySegment2D(const FVector& Origin, const FVector& Direction, const float Reach, const FVector& SegmentStart, const FVector& SegmentEnd)
+	{
+		const FVector2D RayDirection = FVector2D(Direction).GetSafeNormal();
+		const FVector2D SegmentVector = FVector2D(SegmentEnd) - FVector2D(SegmentStart);
+		const float Denominator = FVector2D::CrossProduct(RayDirection, SegmentVector);
+		if (FMath::IsNearlyZero(Denominator)) return -1.f;
+
+		const FVector2D Delta = FVector2D(SegmentStart) - FVector2D(Origin);
+		const float RayDistance = FVector2D::CrossProduct(Delta, SegmentVector) / Denominator;
+		const float SegmentAlpha = FVector2D::CrossProduct(Delta, RayDirection) / Denominator;
+		if (RayDistance < 0.f || RayDistance > Reach || SegmentAlpha < 0.f || SegmentAlpha > 1.f) return -1.f;
+
+		return RayDistance;
+	}
+
+	/** Horizontal 2D bounds of a ray, used to gather candidate cells **/
+	FBox2D GetRayBox2D(const FVector& Origin, const FVector& Direction, const float Reach)
+	{
+		const FVector2D Start = FVector2D(Origin);
+		const FVector2D End = Start + FVector2D(Direction).GetSafeNormal() * Reach;
+
+		FBox2D Box(ForceInit);
+		Box += Start;
+		Box += End;
+		return Box;
+	}
+}
+
+template<typename VisitorType>
+void UTraversalEdgeIndex::ForEachEdgeInBox(const FBox2D& Box, VisitorType Visitor) const
+{
+	if (CellStarts.Num() == 0) return;
+
+	const FIntPoint MinCell = GetCellCoord(Box.Min);
+	const FIntPoint MaxCell = GetCellCoord(Box.Max);
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			const int32 Cell = Y * GridSize.X + X;
+			for (int32 Index = CellStarts[Cell]; Index < CellStarts[Cell + 1]; ++Index)
+			{
+				Visitor(CellEdges[Index]);
+			}
+		}
+	}
+}
+
+FIntPoint UTraversalEdgeIndex::GetCellCoord(const FVector2D& Location) const
+{
+	const FVector2D Local = (Location - GridOrigin) / CellSize;
+	return FIntPoint(
+		FMath::Clamp(FMath::FloorToInt(Local.X), 0, GridSize.X - 1),
+		FMath::Clamp(FMath::FloorToInt(Local.Y), 0, GridSize.Y - 1));
+}
+
+bool UTraversalEdgeIndex::Contains(const FVector& Location) const
+{
+	return Bounds.IsValid && Bounds.ExpandBy(CellSize).IsInsideXY(Location);
+}
+
+bool UTraversalEdgeIndex::FindLedge(const FVector& Origin, const FVector& Direction, const float Reach, const float MinZ, const float MaxZ, FTraversalEdgeHit& OutHit) const
+{
+	OutHit = FTraversalEdgeHit();
+	float BestZ = -BIG_NUMBER;
+
+	ForEachEdgeInBox(GetRayBox2D(Origin, Direction, Reach), [&](const int32 EdgeIndex)
+	{
+		const FTraversalEdge& Edge = Edges[EdgeIndex];
+		if (Edge.Type != ETraversalEdgeType::Ledge) return;
+
+		// Only ledges in height range whose wall faces the ray
+		const float LipZ = Edge.Start.Z;
+		if (LipZ < MinZ || LipZ > MaxZ || FVector::DotProduct(Edge.Normal, Direction) >= 0.f) return;
+
+		const float Distance = IntersectRaySegment2D(Origin, Direction, Reach, Edge.Start, Edge.End);
+		if (Distance < 0.f) return;
+
+		// A downward probe returns the highest surface, prefer the nearest one on ties
+		if (LipZ < BestZ || (LipZ == BestZ && Distance >= OutHit.Distance)) return;
+
+		BestZ = LipZ;
+		OutHit.EdgeIndex = EdgeIndex;
+		OutHit.Distance = Distance;
+		OutHit.Normal = Edge.Normal;
+		OutHit.Location = Origin + FVector(FVector2D(Direction).GetSafeNormal(), 0.f) * Distance;
+		OutHit.Location.Z = LipZ;
+	});
+
+	return OutHit.EdgeIndex != INDEX_NONE;
+}
+
+bool UTraversalEdgeIndex::FindCoverFace(const FVector& Origin, const FVector& Direction, const float Reach, FTraversalEdgeHit& OutHit) const
+{
+	OutHit = FTraversalEdgeHit();
+	OutHit.Distance = BIG_NUMBER;
+
+	ForEachEdgeInBox(GetRayBox2D(Origin, Direction, Reach), [&](const int32 EdgeIndex)
+	{
+		const FTraversalEdge& Edge = Edges[EdgeIndex];
+		if (Edge.Type == ETraversalEdgeType::Ledge) return;
+
+		// Only faces spanning the ray height and facing the ray
+		if (Origin.Z < Edge.Start.Z || Origin.Z > Edge.Start.Z + Edge.Height || FVector::DotProduct(Edge.Normal, Direction) >= 0.f) return;
+
+		const float Distance = IntersectRaySegment2D(Origin, Direction, Reach, Edge.Start, Edge.End);
+		if (Distance < 0.f || Distance >= OutHit.Distance) return;
+
+		OutHit.EdgeIndex = EdgeIndex;
+		OutHit.Distance = Distance;
+		OutHit.Normal = Edge.Normal;
+		OutHit.Location = Origin + FVector(FVector2D(Direction).GetSafeNormal(), 0.f) * Distance;
+	});
+
+	return OutHit.EdgeIndex != INDEX_NONE;
+}
+
+bool UTraversalEdgeIndex::FindCoverCorner(const FTraversalEdgeHit& FaceHit, const FVector& SideDirection, const float MaxDistance, FTraversalEdgeHit& OutHit) const
+{
+	OutHit = FTraversalEdgeHit();
+	if (!Edges.IsValidIndex(FaceHit.EdgeIndex)) return false;
+
+	const FVector SideVector = FVector(FVector2D(SideDirection).GetSafeNormal(), 0.f);
+	int32 FaceIndex = FaceHit.EdgeIndex;
+
+	// Follow coplanar faces (walls made of several boxes) until an exposed corner is found
+	for (int32 Step = 0; Step < MaxCornerSearchSteps && FaceIndex != INDEX_NONE; ++Step)
+	{
+		const FTraversalEdge& Face = Edges[FaceIndex];
+		const bool bTowardEnd = FVector::DotProduct(Face.End - Face.Start, SideVector) > 0.f;
+		const FVector Corner = bTowardEnd ? Face.End : Face.Start;
+
+		const float Distance = FVector::DotProduct(Corner - FaceHit.Location, SideVector);
+		if (Distance > MaxDistance) return false;
+
+		if (Face.CornerFlags & (bTowardEnd ? ETraversalCorner::End : ETraversalCorner::Start))
+		{
+			if (Distance < 0.f) return false;
+
+			OutHit.EdgeIndex = FaceIndex;
+			OutHit.Distance = Distance;
+			OutHit.Normal = SideVector;
+			OutHit.Location = FVector(Corner.X, Corner.Y, FaceHit.Location.Z);
+			return true;
+		}
+
+		// Buried corner, continue on the face touching it
+		const int32 CurrentIndex = FaceIndex;
+		FaceIndex = INDEX_NONE;
+		const FBox2D CornerBox(FVector2D(Corner) - CornerWeldDistance, FVector2D(Corner) + CornerWeldDistance);
+		ForEachEdgeInBox(CornerBox, [&](const int32 EdgeIndex)
+		{
+			const FTraversalEdge& Other = Edges[EdgeIndex];
+			if (EdgeIndex == CurrentIndex || Other.Type == ETraversalEdgeType::Ledge) return;
+			if (!Other.Normal.Equals(Face.Normal, KINDA_SMALL_NUMBER * 10.f)) return;
+			if (FMath::Abs(Other.Start.Z - Face.Start.Z) > Face.Height) return;
+
+			// Faces of differently rotated boxes can run either way along the wall
+			const float WeldDistanceSquared = FMath::Square(CornerWeldDistance);
+			if (FVector2D::DistSquared(FVector2D(Other.Start), FVector2D(Corner)) <= WeldDistanceSquared
+				|| FVector2D::DistSquared(FVector2D(Other.End), FVector2D(Corner)) <= WeldDistanceSquared)
+			{
+				FaceIndex = EdgeIndex;
+			}
+		});
+	}
+
+	return false;
+}
+
+int32 UTraversalEdgeIndex::FindCoverPoints(const FTraversalCoverQuery& Query, const int32 MaxResults, TArray<FTraversalCoverQueryResult>& OutResults) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraversalCoverQuery);
+
+	OutResults.Reset();
+	if (MaxResults <= 0 || CoverBucketStarts.Num() == 0) return 0;
+
+	const float MaxDistanceSquared = FMath::Square(Query.MaxDistance);
+	const FIntPoint MinCell = GetCoverCell(Query.Location - FVector(Query.MaxDistance));
+	const FIntPoint MaxCell = GetCoverCell(Query.Location + FVector(Query.MaxDistance));
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			const FIntPoint Cell(X, Y);
+			const int32 Bucket = GetCoverBucket(Cell);
+			for (int32 Index = CoverBucketStarts[Bucket]; Index < CoverBucketStarts[Bucket + 1]; ++Index)
+			{
+				const int32 PointIndex = CoverBucketPoints[Index];
+				const FTraversalCoverPoint& Point = CoverPoints[PointIndex];
+
+				// Buckets are shared by every cell hashing to them
+				if (GetCoverCell(Point.Location) != Cell) continue;
+				if (Query.bTallOnly && Point.Type != ETraversalEdgeType::TallCover) continue;
+
+				const float DistanceSquared = FVector::DistSquared(Point.Location, Query.Location);
+				if (DistanceSquared > MaxDistanceSquared) continue;
+				if (OutResults.Num() == MaxResults && DistanceSquared >= OutResults.Last().DistanceSquared) continue;
+
+				// The face is between the point and the threat when the threat is behind it
+				if (Query.bHasThreat)
+				{
+					const FVector ToThreat = TraversalMath::GetHorizontal(Query.ThreatLocation - Point.Location).GetSafeNormal();
+					if (FVector::DotProduct(-Point.Normal, ToThreat) < Query.MinThreatDot) continue;
+				}
+
+				// Keep the nearest MaxResults, sorted. MaxResults is small, so insert in place
+				int32 InsertIndex = OutResults.Num();
+				while (InsertIndex > 0 && OutResults[InsertIndex - 1].DistanceSquared > DistanceSquared)
+				{
+					--InsertIndex;
+				}
+				OutResults.Insert(FTraversalCoverQueryResult{ PointIndex, DistanceSquared }, InsertIndex);
+				if (OutResults.Num() > MaxResults) OutResults.Pop(false);
+			}
+		}
+	}
+
+	return OutResults.Num();
+}
+
+FIntPoint UTraversalEdgeIndex::GetCoverCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+int32 UTraversalEdgeIndex::GetCoverBucket(const FIntPoint& Cell) const
+{
+	// The bucket count is a power of two
+	const uint32 Hash = (static_cast<uint32>(Cell.X) * 73856093u) ^ (static_cast<uint32>(Cell.Y) * 19349663u);
+	return static_cast<int32>(Hash & static_cast<uint32>(CoverBucketStarts.Num() - 2));
+}
+
+void UTraversalEdgeIndex::BuildCoverHash()
+{
+	CoverBucketStarts.Reset();
+	CoverBucketPoints.Reset();
+	if (CoverPoints.Num() == 0) return;
+
+	// About one point per bucket. Same two pass counting sort as the edge grid
+	const int32 NumBuckets = FMath::RoundUpToPowerOfTwo(CoverPoints.Num());
+	CoverBucketStarts.Init(0, NumBuckets + 1);
+	for (const FTraversalCoverPoint& Point : CoverPoints)
+	{
+		++CoverBucketStarts[GetCoverBucket(GetCoverCell(Point.Location)) + 1];
+	}
+
+	for (int32 Bucket = 1; Bucket < CoverBucketStarts.Num(); ++Bucket)
+	{
+		CoverBucketStarts[Bucket] += CoverBucketStarts[Bucket - 1];
+	}
+
+	CoverBucketPoints.SetNumUninitialized(CoverBucketStarts.Last());
+	TArray<int32> BucketCursors(CoverBucketStarts);
+	for (int32 PointIndex = 0; PointIndex < CoverPoints.Num(); ++PointIndex)
+	{
+		CoverBucketPoints[BucketCursors[GetCoverBucket(GetCoverCell(CoverPoints[PointIndex].Location))]++] = PointIndex;
+	}
+}
+
+void UTraversalEdgeIndex::BuildGrid(const float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.f);
+	CellStarts.Reset();
+	CellEdges.Reset();
+
+	for (const FTraversalEdge& Edge : Edges)
+	{
+		Bounds += Edge.Start;
+		Bounds += Edge.End;
+	}
+
+	if (!Bounds.IsValid)
+	{
+		GridSize = FIntPoint::ZeroValue;
+		return;
+	}
+
+	GridOrigin = FVector2D(Bounds.Min);
+	const FVector2D GridExtent = FVector2D(Bounds.Max) - GridOrigin;
+	GridSize.X = FMath::Max(1, FMath::CeilToInt(GridExtent.X / CellSize));
+	GridSize.Y = FMath::Max(1, FMath::CeilToInt(GridExtent.Y / CellSize));
+
+	// Two pass counting sort so every cell's edges are contiguous in CellEdges
+	CellStarts.Init(0, GridSize.X * GridSize.Y + 1);
+	auto ForEachCell = [this](const FTraversalEdge& Edge, TFunctionRef<void(int32)> CellFunction)
+	{
+		FBox2D EdgeBox(ForceInit);
+		EdgeBox += FVector2D(Edge.Start);
+		EdgeBox += FVector2D(Edge.End);
+
+		const FIntPoint MinCell = GetCellCoord(EdgeBox.Min);
+		const FIntPoint MaxCell = GetCellCoord(EdgeBox.Max);
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				CellFunction(Y * GridSize.X + X);
+			}
+		}
+	};
+
+	for (const FTraversalEdge& Edge : Edges)
+	{
+		ForEachCell(Edge, [this](const int32 Cell) { ++CellStarts[Cell + 1]; });
+	}
+
+	for (int32 Cell = 1; Cell < CellStarts.Num(); ++Cell)
+	{
+		CellStarts[Cell] += CellStarts[Cell - 1];
+	}
+
+	CellEdges.SetNumUninitialized(CellStarts.Last());
+	TArray<int32> CellCursors(CellStarts);
+	for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); ++EdgeIndex)
+	{
+		ForEachCell(Edges[EdgeIndex], [this, &CellCursors, EdgeIndex](const int32 Cell) { CellEdges[CellCursors[Cell]++] = EdgeIndex; });
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Bake
+
+#if WITH_EDITOR
+
+namespace
+{
+	/** Box with one face pointing straight up, described by its center and half extent vectors in world space **/
+	struct FUprightBox
+	{
+		FVector Center;
+		FVector HalfUp;
+		FVector HalfSides[2];
+	};
+
+	bool MakeUprightBox(const FTransform& BoxToWorld, const FVector& HalfExtent, FUprightBox& OutBox)
+	{
+		const FVector HalfAxes[3] =
+		{
+			BoxToWorld.TransformVector(FVector(HalfExtent.X, 0.f, 0.f)),
+			BoxToWorld.TransformVector(FVector(0.f, HalfExtent.Y, 0.f)),
+			BoxToWorld.TransformVector(FVector(0.f, 0.f, HalfExtent.Z))
+		};
+
+		int32 UpAxis = INDEX_NONE;
+		float UpDot = 0.f;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const float Dot = FVector::DotProduct(HalfAxes[Axis].GetSafeNormal(), FVector::UpVector);
+			if (FMath::Abs(Dot) > FMath::Abs(UpDot))
+			{
+				UpDot = Dot;
+				UpAxis = Axis;
+			}
+		}
+
+		// Tilted boxes have no horizontal lip or vertical face
+		if (UpAxis == INDEX_NONE || FMath::Abs(UpDot) < 0.99f) return false;
+
+		OutBox.Center = BoxToWorld.GetLocation();
+		OutBox.HalfUp = HalfAxes[UpAxis] * FMath::Sign(UpDot);
+		OutBox.HalfSides[0] = HalfAxes[(UpAxis + 1) % 3];
+		OutBox.HalfSides[1] = HalfAxes[(UpAxis + 2) % 3];
+		return true;
+	}
+
+	/** Cover points of the baked cover faces, placed by the character the way TryEnterCover places it **/
+	void MakeCoverPoints(const TArray<FTraversalEdge>& Edges, const FTraversalEdgeBakeSettings& Settings, TArray<FTraversalCoverPoint>& OutCoverPoints)
+	{
+		const TSubclassOf<AThirdPersonDemoCharacter> CharacterClass = Settings.CoverCharacterClass ? Settings.CoverCharacterClass : TSubclassOf<AThirdPersonDemoCharacter>(AThirdPersonDemoCharacter::StaticClass());
+		const AThirdPersonDemoCharacter* Character = CharacterClass->GetDefaultObject<AThirdPersonDemoCharacter>();
+
+		// Faces are baked from their bottom, which is taken to be the floor
+		float ShortProbeHeight, TallProbeHeight;
+		Character->GetCoverProbeHeights(ShortProbeHeight, TallProbeHeight);
+
+		for (const FTraversalEdge& Edge : Edges)
+		{
+			if (Edge.Type == ETraversalEdgeType::Ledge || Edge.Height < ShortProbeHeight) continue;
+
+			const FVector AlongVector = Edge.End - Edge.Start;
+
+			// A face the tall probe hits is tall cover, only taken at an exposed corner
+			if (Edge.Height >= TallProbeHeight)
+			{
+				for (const bool bEndCorner : { false, true })
+				{
+					if (!(Edge.CornerFlags & (bEndCorner ? ETraversalCorner::End : ETraversalCorner::Start))) continue;
+
+					const FVector Corner = (bEndCorner ? Edge.End : Edge.Start) + FVector::UpVector * TallProbeHeight;
+					const FVector SideDirection = (bEndCorner ? AlongVector : -AlongVector).GetSafeNormal();
+
+					FTraversalCoverPoint& Point = OutCoverPoints.AddDefaulted_GetRef();
+					Point.Location = Character->MakeCoverLocation(true, Corner, Edge.Normal, Corner, SideDirection);
+					Point.Normal = Edge.Normal;
+					Point.Type = ETraversalEdgeType::TallCover;
+					Point.bIsRightCover = FVector::DotProduct(SideDirection, TraversalMath::RotateAboutZ90(Edge.Normal, true)) <= 0.f;
+				}
+				continue;
+			}
+
+			// Short cover can be taken anywhere along the face
+			const int32 NumPoints = FMath::Max(1, FMath::FloorToInt(AlongVector.Size() / FMath::Max(Settings.CoverPointSpacing, 1.f)));
+			for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+			{
+				const FVector FaceLocation = Edge.Start + AlongVector * ((PointIndex + 0.5f) / NumPoints) + FVector::UpVector * ShortProbeHeight;
+
+				FTraversalCoverPoint& Point = OutCoverPoints.AddDefaulted_GetRef();
+				Point.Location = Character->MakeCoverLocation(false, FaceLocation, Edge.Normal, FVector::ZeroVector, FVector::ZeroVector);
+				Point.Normal = Edge.Normal;
+				Point.Type = ETraversalEdgeType::ShortCover;
+			}
+		}
+	}
+
+	/**
+	 * Collect upright collision boxes of a static mesh component in world space
+	 * @return True if the boxes are all of the collision probes can hit, so live probes can leave the component to the index
+	 */
+	bool GatherUprightBoxes(const UStaticMeshComponent* Component, const bool bUseMeshBoundsFallback, TArray<FUprightBox>& OutBoxes)
+	{
+		const FTransform& ComponentToWorld = Component->GetComponentTransform();
+		const UBodySetup* BodySetup = Component->GetBodySetup();
+		FUprightBox Box;
+
+		if (BodySetup && BodySetup->AggGeom.BoxElems.Num() > 0)
+		{
+			// Probes trace simple collision, unless the mesh uses its triangles instead
+			bool bCoversCollision = BodySetup->CollisionTraceFlag != CTF_UseComplexAsSimple && BodySetup->AggGeom.GetElementCount() == BodySetup->AggGeom.BoxElems.Num();
+			for (const FKBoxElem& BoxElem : BodySetup->AggGeom.BoxElems)
+			{
+				if (MakeUprightBox(BoxElem.GetTransform() * ComponentToWorld, FVector(BoxElem.X, BoxElem.Y, BoxElem.Z) * 0.5f, Box))
+				{
+					OutBoxes.Add(Box);
+				}
+				else
+				{
+					bCoversCollision = false;
+				}
+			}
+			return bCoversCollision;
+		}
+		else if (bUseMeshBoundsFallback && Component->GetStaticMesh())
+		{
+			const FBox LocalBox = Component->GetStaticMesh()->GetBoundingBox();
+			if (MakeUprightBox(FTransform(LocalBox.GetCenter()) * ComponentToWorld, LocalBox.GetExtent(), Box))
+			{
+				OutBoxes.Add(Box);
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+void UTraversalEdgeIndex::Bake(ULevel* Level, const FTraversalEdgeBakeSettings& Settings, TArray<TSoftObjectPtr<UPrimitiveComponent>>& OutBakedComponents)
+{
+	OutBakedComponents.Reset();
+	Edges.Reset();
+	CoverPoints.Reset();
+	Bounds = FBox(ForceInit);
+
+	UWorld* World = Level ? Level->OwningWorld : nullptr;
+	if (World == nullptr) return;
+
+	// Same channel the character probes with, so baked edges match live traces
+	const ECollisionChannel TraceChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery_MAX);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalEdgeBake), false);
+	const FCollisionShape ClearanceProbe = FCollisionShape::MakeSphere(Settings.ClearanceProbeDistance * 0.5f);
+	auto IsBlocked = [&](const FVector& Location)
+	{
+		return World->OverlapBlockingTestByChannel(Location, FQuat::Identity, TraceChannel, ClearanceProbe, QueryParams);
+	};
+
+	TArray<FUprightBox> Boxes;
+	for (const AActor* Actor : Level->Actors)
+	{
+		if (Actor == nullptr) continue;
+
+		TInlineComponentArray<UStaticMeshComponent*> Components(Actor);
+		for (UStaticMeshComponent* Component : Components)
+		{
+			// Movable geometry is left to live traces at runtime
+			if (Component->Mobility != EComponentMobility::Static || !Component->IsQueryCollisionEnabled()) continue;
+			if (Component->GetCollisionResponseToChannel(TraceChannel) != ECR_Block) continue;
+
+			Bounds += Component->Bounds.GetBox();
+			if (GatherUprightBoxes(Component, Settings.bUseMeshBoundsFallback, Boxes))
+			{
+				OutBakedComponents.Add(Component);
+			}
+		}
+	}
+
+	const float Probe = Settings.ClearanceProbeDistance;
+	for (const FUprightBox& Box : Boxes)
+	{
+		const FVector TopCenter = Box.Center + Box.HalfUp;
+		const FVector BottomCenter = Box.Center - Box.HalfUp;
+		const float BoxHeight = Box.HalfUp.Size() * 2.f;
+
+		for (int32 Side = 0; Side < 4; ++Side)
+		{
+			const FVector FaceOffset = (Side % 2 == 0 ? 1.f : -1.f) * Box.HalfSides[Side / 2];
+			const FVector AlongOffset = Box.HalfSides[1 - Side / 2];
+			const FVector AlongDirection = AlongOffset.GetSafeNormal();
+			const FVector Normal = FVector(FVector2D(FaceOffset).GetSafeNormal(), 0.f);
+			if (AlongOffset.Size() * 2.f < Settings.MinEdgeLength) continue;
+
+			// Ledge lip: open above the top face and in front of the wall under it
+			const FVector LipMiddle = TopCenter + FaceOffset;
+			if (BoxHeight >= Settings.MinLedgeDepth
+				&& !IsBlocked(LipMiddle - Normal * Probe + FVector::UpVector * Probe)
+				&& !IsBlocked(LipMiddle + Normal * Probe - FVector::UpVector * Settings.MinLedgeDepth * 0.5f))
+			{
+				FTraversalEdge& Ledge = Edges.AddDefaulted_GetRef();
+				Ledge.Type = ETraversalEdgeType::Ledge;
+				Ledge.Start = LipMiddle - AlongOffset;
+				Ledge.End = LipMiddle + AlongOffset;
+				Ledge.Normal = Normal;
+				Ledge.Height = BoxHeight;
+			}
+
+			// Cover face: open in front at mid height
+			const FVector FaceMiddle = BottomCenter + FaceOffset + FVector::UpVector * BoxHeight * 0.5f;
+			if (BoxHeight >= Settings.MinCoverHeight && !IsBlocked(FaceMiddle + Normal * Probe))
+			{
+				FTraversalEdge& Cover = Edges.AddDefaulted_GetRef();
+				Cover.Type = BoxHeight >= Settings.TallCoverHeight ? ETraversalEdgeType::TallCover : ETraversalEdgeType::ShortCover;
+				Cover.Start = BottomCenter + FaceOffset - AlongOffset;
+				Cover.End = BottomCenter + FaceOffset + AlongOffset;
+				Cover.Normal = Normal;
+				Cover.Height = BoxHeight;
+
+				// A corner is exposed when the space just past it, behind the face, is empty
+				if (!IsBlocked(FaceMiddle - AlongOffset - AlongDirection * Probe - Normal * Probe)) Cover.CornerFlags |= ETraversalCorner::Start;
+				if (!IsBlocked(FaceMiddle + AlongOffset + AlongDirection * Probe - Normal * Probe)) Cover.CornerFlags |= ETraversalCorner::End;
+			}
+		}
+	}
+
+	BuildGrid(Settings.CellSize);
+
+	MakeCoverPoints(Edges, Settings, CoverPoints);
+	BuildCoverHash();
+}
+
+#endif
@@ -0,0 +1,267 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TraversalEdgeIndex.generated.h"
+
+class AThirdPersonDemoCharacter;
+class ULevel;
+class UPrimitiveComponent;
+
+UENUM()
+enum class ETraversalEdgeType : uint8
+{
+	/** Top edge of a wall that can be hung from **/
+	Ledge,
+
+	/** Vertical face tall enough to hide a standing character **/
+	TallCover,
+
+	/** Vertical face only tall enough to hide a crouching character **/
+	ShortCover
+};
+
+/** Corner flags of a cover face. Set when the corner is exposed and can be peeked around **/
+namespace ETraversalCorner
+{
+	enum Type : uint8
+	{
+		None = 0,
+		Start = 1 << 0,
+		End = 1 << 1
+	};
+}
+
+/** A single baked ledge lip or cover face **/
+USTRUCT()
+struct FTraversalEdge
+{
+	GENERATED_BODY()
+
+	/** Segment endpoints. Ledges lie on the lip, cover faces along the bottom of the face **/
+	UPROPERTY()
+	FVector Start = FVector::ZeroVector;
+	UPROPERTY()
+	FVector End = FVector::ZeroVector;
+
+	/** Horizontal outward normal of the wall below the ledge, or of the cover face **/
+	UPROPERTY()
+	FVector Normal = FVector::ForwardVector;
+
+	/** Ledges: depth of the wall below the lip. Cover faces: height of the face **/
+	UPROPERTY()
+	float Height = 0.f;
+
+	UPROPERTY()
+	ETraversalEdgeType Type = ETraversalEdgeType::Ledge;
+
+	/** Cover faces only, see ETraversalCorner **/
+	UPROPERTY()
+	uint8 CornerFlags = ETraversalCorner::None;
+};
+
+/** Where a character can take cover, baked from a cover face the way TryEnterCover would place it **/
+USTRUCT()
+struct FTraversalCoverPoint
+{
+	GENERATED_BODY()
+
+	/** Character location in cover **/
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	/** Horizontal outward normal of the cover face, the character faces along it **/
+	UPROPERTY()
+	FVector Normal = FVector::ForwardVector;
+
+	/** TallCover points are at exposed corners, ShortCover points anywhere along the face **/
+	UPROPERTY()
+	ETraversalEdgeType Type = ETraversalEdgeType::ShortCover;
+
+	/** Tall cover: peeks out on the right side of the character **/
+	UPROPERTY()
+	bool bIsRightCover = false;
+};
+
+/** Nearest cover point query, see UTraversalEdgeIndex::FindCoverPoints **/
+struct FTraversalCoverQuery
+{
+	FVector Location = FVector::ZeroVector;
+	float MaxDistance = 1000.f;
+
+	/** Only keep points whose face stands between them and the threat **/
+	bool bHasThreat = false;
+	FVector ThreatLocation = FVector::ZeroVector;
+
+	/** Smallest cosine between the face's inward normal and the direction to the threat **/
+	float MinThreatDot = 0.5f;
+
+	/** Skip short cover, e.g. for agents that can't crouch **/
+	bool bTallOnly = false;
+};
+
+/** Cover point found by a query, with its squared distance to the query location **/
+struct FTraversalCoverQueryResult
+{
+	int32 PointIndex = INDEX_NONE;
+	float DistanceSquared = 0.f;
+};
+
+/** Result of a query against the baked index, laid out like the trace it replaces **/
+struct FTraversalEdgeHit
+{
+	int32 EdgeIndex = INDEX_NONE;
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+	float Distance = 0.f;
+};
+
+/** Tunables for extracting edges from level geometry **/
+USTRUCT()
+struct FTraversalEdgeBakeSettings
+{
+	GENERATED_BODY()
+
+	/** Size of a grid cell of the index, in cm **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	float CellSize = 500.f;
+
+	/** Edges shorter than this are not baked **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	float MinEdgeLength = 30.f;
+
+	/** Minimum wall depth below a lip for it to count as a ledge. Should cover TraceOffset * 2 **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	float MinLedgeDepth = 20.f;
+
+	/** Faces lower than this are not baked as cover **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	float MinCoverHeight = 60.f;
+
+	/** Faces at least this high are baked as tall cover **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	float TallCoverHeight = 150.f;
+
+	/** Distance probed around ledges and corners to check they are not buried in other geometry **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	float ClearanceProbeDistance = 10.f;
+
+	/** Use the mesh bounds as a box when a static mesh has no simple box collision. Ramps, stairs and arches then bake fake ledges and cover **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	bool bUseMeshBoundsFallback = false;
+
+	/** Character whose cover probe heights and offsets the cover points follow. AThirdPersonDemoCharacter if unset **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	TSubclassOf<AThirdPersonDemoCharacter> CoverCharacterClass;
+
+	/** Distance between cover points along short cover faces **/
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	float CoverPointSpacing = 100.f;
+};
+
+/**
+ * Ledge lips and cover faces extracted from the static geometry of a level, bucketed in a uniform 2D grid.
+ * Lets traversal probes run a nearest-edge query instead of searching the collision scene.
+ */
+UCLASS(BlueprintType)
+class UTraversalEdgeIndex : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns true if the location is inside the area this index was baked for **/
+	bool Contains(const FVector& Location) const;
+
+	/**
+	 * Find the highest ledge crossed by a horizontal ray
+	 * @param Origin	Ray origin
+	 * @param Direction	Horizontal ray direction
+	 * @param Reach		Ray length
+	 * @param MinZ		Lowest accepted lip height
+	 * @param MaxZ		Highest accepted lip height
+	 */
+	bool FindLedge(const FVector& Origin, const FVector& Direction, const float Reach, const float MinZ, const float MaxZ, FTraversalEdgeHit& OutHit) const;
+
+	/** Find the nearest cover face crossed by a horizontal ray at the height of Origin **/
+	bool FindCoverFace(const FVector& Origin, const FVector& Direction, const float Reach, FTraversalEdgeHit& OutHit) const;
+
+	/**
+	 * Find the exposed corner of a cover face on one side of a point on that face
+	 * @param FaceHit		Hit returned by FindCoverFace
+	 * @param SideDirection	Horizontal direction along the face to look for the corner
+	 * @param MaxDistance	Maximum distance from the hit to the corner
+	 */
+	bool FindCoverCorner(const FTraversalEdgeHit& FaceHit, const FVector& SideDirection, const float MaxDistance, FTraversalEdgeHit& OutHit) const;
+
+	/**
+	 * Find the K nearest cover points within the query distance, nearest first. Reads baked data only,
+	 * so it is safe to call from any thread once the index is loaded
+	 * @return Number of points found
+	 */
+	int32 FindCoverPoints(const FTraversalCoverQuery& Query, const int32 MaxResults, TArray<FTraversalCoverQueryResult>& OutResults) const;
+
+	const TArray<FTraversalEdge>& GetEdges() const { return Edges; }
+	const TArray<FTraversalCoverPoint>& GetCoverPoints() const { return CoverPoints; }
+
+#if WITH_EDITOR
+	/**
+	 * Extract edges from the static geometry of the level and rebuild the grid
+	 * @param OutBakedComponents	Components whose collision is entirely described by the baked edges
+	 */
+	void Bake(ULevel* Level, const FTraversalEdgeBakeSettings& Settings, TArray<TSoftObjectPtr<UPrimitiveComponent>>& OutBakedComponents);
+#endif
+
+private:
+	/** Call Visitor with the index of every edge registered in a cell overlapping the box. Edges can be visited more than once **/
+	template<typename VisitorType>
+	void ForEachEdgeInBox(const FBox2D& Box, VisitorType Visitor) const;
+
+	/** Rebuild CellStarts/CellEdges from Edges **/
+	void BuildGrid(const float InCellSize);
+
+	/** Grid cell containing a location, clamped to the grid **/
+	FIntPoint GetCellCoord(const FVector2D& Location) const;
+
+	/** Rebuild CoverBucketStarts/CoverBucketPoints from CoverPoints **/
+	void BuildCoverHash();
+
+	/** Unclamped cell of the cover hash containing a location, and the bucket it hashes to **/
+	FIntPoint GetCoverCell(const FVector& Location) const;
+	int32 GetCoverBucket(const FIntPoint& Cell) const;
+
+	UPROPERTY()
+	TArray<FTraversalEdge> Edges;
+
+	UPROPERTY()
+	FBox Bounds;
+
+	UPROPERTY()
+	FVector2D GridOrigin;
+
+	UPROPERTY()
+	FIntPoint GridSize;
+
+	UPROPERTY()
+	float CellSize = 500.f;
+
+	/** Offset of each cell into CellEdges, with one extra entry at the end **/
+	UPROPERTY()
+	TArray<int32> CellStarts;
+
+	/** Edge indices sorted by cell **/
+	UPROPERTY()
+	TArray<int32> CellEdges;
+
+	UPROPERTY()
+	TArray<FTraversalCoverPoint> CoverPoints;
+
+	/** Spatial hash of CoverPoints over CellSize cells: offset of each bucket into CoverBucketPoints, with one extra entry at the end **/
+	UPROPERTY()
+	TArray<int32> CoverBucketStarts;
+
+	/** Cover point indices sorted by bucket **/
+	UPROPERTY()
+	TArray<int32> CoverBucketPoints;
+};
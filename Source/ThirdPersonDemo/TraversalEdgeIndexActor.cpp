@@ -0,0 +1,137 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalEdgeIndexActor.h"
+#include "TraversalEdgeIndexSubsystem.h"
+#include "TraversalNavLinkTile.h"
+#include "ThirdPersonDemoCharacter.h"
+#include "Engine/World.h"
+
+void ATraversalEdgeIndexActor::BakeEdgeIndex()
+{
+#if WITH_EDITOR
+	if (EdgeIndex == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: assign a Traversal Edge Index asset before baking"), *GetName());
+		return;
+	}
+
+	Modify();
+	EdgeIndex->Bake(GetLevel(), BakeSettings, BakedComponents);
+	EdgeIndex->MarkPackageDirty();
+
+	UE_LOG(LogTemp, Log, TEXT("%s: baked %d traversal edges and %d cover points from %d components into %s"), *GetName(), EdgeIndex->GetEdges().Num(), EdgeIndex->GetCoverPoints().Num(), BakedComponents.Num(), *EdgeIndex->GetPathName());
+#endif
+}
+
+void ATraversalEdgeIndexActor::GenerateNavLinks()
+{
+#if WITH_EDITOR
+	if (EdgeIndex == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: assign and bake a Traversal Edge Index asset before generating nav links"), *GetName());
+		return;
+	}
+
+	const TSubclassOf<AThirdPersonDemoCharacter> CharacterClass = NavLinkSettings.CharacterClass ? NavLinkSettings.CharacterClass : TSubclassOf<AThirdPersonDemoCharacter>(AThirdPersonDemoCharacter::StaticClass());
+	FTraversalRouteRules Rules;
+	CharacterClass->GetDefaultObject<AThirdPersonDemoCharacter>()->GetTraversalRouteRules(GetWorld()->GetGravityZ(), Rules);
+
+	TMap<FIntPoint, ATraversalNavLinkTile*> ExistingTiles;
+	for (AActor* Actor : GetLevel()->Actors)
+	{
+		if (ATraversalNavLinkTile* Tile = Cast<ATraversalNavLinkTile>(Actor))
+		{
+			ExistingTiles.Add(Tile->GetTileCoord(), Tile);
+		}
+	}
+
+	const TArray<FTraversalEdge>& Edges = EdgeIndex->GetEdges();
+	TMap<FIntPoint, TArray<int32>> TileEdges;
+	TraversalNavLinkGenerator::BucketEdges(Edges, NavLinkSettings.TileSize, TileEdges);
+
+	int32 NumGenerated = 0;
+	int32 NumUnchanged = 0;
+	int32 NumLinks = 0;
+	TArray<FNavigationLink> Links;
+	for (const TPair<FIntPoint, TArray<int32>>& Pair : TileEdges)
+	{
+		const uint32 ContentHash = TraversalNavLinkGenerator::HashTile(GetWorld(), Edges, Pair.Value, Rules, NavLinkSettings);
+
+		ATraversalNavLinkTile* Tile = nullptr;
+		ExistingTiles.RemoveAndCopyValue(Pair.Key, Tile);
+		if (Tile != nullptr && Tile->GetContentHash() == ContentHash)
+		{
+			++NumUnchanged;
+			continue;
+		}
+
+		TraversalNavLinkGenerator::GenerateTileLinks(GetWorld(), Edges, Pair.Value, Rules, NavLinkSettings, Links);
+		++NumGenerated;
+		if (Links.Num() == 0)
+		{
+			if (Tile != nullptr) Tile->Destroy();
+			continue;
+		}
+
+		if (Tile == nullptr)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.OverrideLevel = GetLevel();
+			Tile = GetWorld()->SpawnActor<ATraversalNavLinkTile>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		}
+
+		Tile->SetLinks(Pair.Key, ContentHash, Links);
+		NumLinks += Links.Num();
+	}
+
+	// Tiles left have no edges anymore
+	for (const TPair<FIntPoint, ATraversalNavLinkTile*>& Pair : ExistingTiles)
+	{
+		Pair.Value->Destroy();
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s: generated %d nav links in %d tiles, %d tiles unchanged, %d tiles removed"), *GetName(), NumLinks, NumGenerated, NumUnchanged, ExistingTiles.Num());
+#endif
+}
+
+void ATraversalEdgeIndexActor::ClearNavLinks()
+{
+#if WITH_EDITOR
+	// Gathered first, destroying changes the level's actor list
+	TArray<ATraversalNavLinkTile*> Tiles;
+	for (AActor* Actor : GetLevel()->Actors)
+	{
+		if (ATraversalNavLinkTile* Tile = Cast<ATraversalNavLinkTile>(Actor))
+		{
+			Tiles.Add(Tile);
+		}
+	}
+
+	for (ATraversalNavLinkTile* Tile : Tiles)
+	{
+		Tile->Destroy();
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s: removed %d nav link tiles"), *GetName(), Tiles.Num());
+#endif
+}
+
+void ATraversalEdgeIndexActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UTraversalEdgeIndexSubsystem* Subsystem = GetWorld()->GetSubsystem<UTraversalEdgeIndexSubsystem>())
+	{
+		Subsystem->RegisterIndex(EdgeIndex, BakedComponents);
+	}
+}
+
+void ATraversalEdgeIndexActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTraversalEdgeIndexSubsystem* Subsystem = GetWorld()->GetSubsystem<UTraversalEdgeIndexSubsystem>())
+	{
+		Subsystem->UnregisterIndex(EdgeIndex, BakedComponents);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "TraversalEdgeIndex.h"
+#include "TraversalNavLinkGenerator.h"
+#include "TraversalEdgeIndexActor.generated.h"
+
+/**
+ * Place one per level to bake its ledges and cover into a UTraversalEdgeIndex asset.
+ * At runtime it hands the baked index to characters so static geometry is not traced every tick.
+ * The baked edges also drive the generation of the traversal nav links AI paths over.
+ */
+UCLASS()
+class ATraversalEdgeIndexActor : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	/** Asset the edges of this level are baked into **/
+	UPROPERTY(EditAnywhere, Category = "Traversal Index")
+	UTraversalEdgeIndex* EdgeIndex;
+
+	UPROPERTY(EditAnywhere, Category = "Traversal Index")
+	FTraversalEdgeBakeSettings BakeSettings;
+
+	/** Components of this level EdgeIndex fully describes. Live probes skip these, and only these **/
+	UPROPERTY(VisibleAnywhere, Category = "Traversal Index")
+	TArray<TSoftObjectPtr<UPrimitiveComponent>> BakedComponents;
+
+	/** Extract ledges and cover from the static geometry of this level into EdgeIndex **/
+	UFUNCTION(CallInEditor, Category = "Traversal Index")
+	void BakeEdgeIndex();
+
+	UPROPERTY(EditAnywhere, Category = "Traversal Nav Links")
+	FTraversalNavLinkSettings NavLinkSettings;
+
+	/** Generate climb and wall run nav links from EdgeIndex, only in the tiles whose edges or tuning changed since the last run **/
+	UFUNCTION(CallInEditor, Category = "Traversal Nav Links")
+	void GenerateNavLinks();
+
+	/** Remove every generated nav link tile of this level, e.g. to regenerate all of them after changing floors under wall runs **/
+	UFUNCTION(CallInEditor, Category = "Traversal Nav Links")
+	void ClearNavLinks();
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalEdgeIndexSubsystem.h"
+#include "TraversalEdgeIndex.h"
+
+void UTraversalEdgeIndexSubsystem::RegisterIndex(UTraversalEdgeIndex* EdgeIndex, const TArray<TSoftObjectPtr<UPrimitiveComponent>>& InBakedComponents)
+{
+	if (EdgeIndex == nullptr) return;
+
+	EdgeIndices.AddUnique(EdgeIndex);
+
+	// Loaded with the level that owns the index
+	for (const TSoftObjectPtr<UPrimitiveComponent>& Component : InBakedComponents)
+	{
+		if (const UPrimitiveComponent* LoadedComponent = Component.Get())
+		{
+			BakedComponents.Add(FObjectKey(LoadedComponent));
+		}
+	}
+}
+
+void UTraversalEdgeIndexSubsystem::UnregisterIndex(UTraversalEdgeIndex* EdgeIndex, const TArray<TSoftObjectPtr<UPrimitiveComponent>>& InBakedComponents)
+{
+	EdgeIndices.Remove(EdgeIndex);
+
+	for (const TSoftObjectPtr<UPrimitiveComponent>& Component : InBakedComponents)
+	{
+		if (const UPrimitiveComponent* LoadedComponent = Component.Get())
+		{
+			BakedComponents.Remove(FObjectKey(LoadedComponent));
+		}
+	}
+}
+
+const UTraversalEdgeIndex* UTraversalEdgeIndexSubsystem::FindIndex(const FVector& Location) const
+{
+	for (const UTraversalEdgeIndex* EdgeIndex : EdgeIndices)
+	{
+		if (EdgeIndex && EdgeIndex->Contains(Location))
+		{
+			return EdgeIndex;
+		}
+	}
+
+	return nullptr;
+}
+
+const UTraversalEdgeIndex* UTraversalEdgeIndexSubsystem::FindCoverPoints(const FTraversalCoverQuery& Query, const int32 MaxResults, TArray<FTraversalCoverQueryResult>& OutResults) const
+{
+	OutResults.Reset();
+	const UTraversalEdgeIndex* EdgeIndex = FindIndex(Query.Location);
+	if (EdgeIndex == nullptr) return nullptr;
+
+	EdgeIndex->FindCoverPoints(Query, MaxResults, OutResults);
+	return EdgeIndex;
+}
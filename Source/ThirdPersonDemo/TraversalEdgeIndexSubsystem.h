@@ -0,0 +1,42 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "TraversalEdgeIndex.h"
+#include "TraversalEdgeIndexSubsystem.generated.h"
+
+/** Keeps track of the baked traversal edge indices of every loaded level **/
+UCLASS()
+class UTraversalEdgeIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Called by ATraversalEdgeIndexActor when its level starts play **/
+	void RegisterIndex(UTraversalEdgeIndex* EdgeIndex, const TArray<TSoftObjectPtr<UPrimitiveComponent>>& BakedComponents);
+
+	/** Called by ATraversalEdgeIndexActor when its level is removed **/
+	void UnregisterIndex(UTraversalEdgeIndex* EdgeIndex, const TArray<TSoftObjectPtr<UPrimitiveComponent>>& BakedComponents);
+
+	/** Returns true if a loaded index fully describes the component, so live probes can ignore it **/
+	bool IsBaked(const UPrimitiveComponent* Component) const { return BakedComponents.Contains(FObjectKey(Component)); }
+
+	/** Returns the baked index covering the location, nullptr if the area has to be probed with live traces **/
+	const UTraversalEdgeIndex* FindIndex(const FVector& Location) const;
+
+	/**
+	 * Nearest cover points to the query location, from the baked index covering it. No scene queries are run.
+	 * Call on the game thread, or find the index here and query it from other threads
+	 * @return The index OutResults point into, nullptr if no baked index covers the location
+	 */
+	const UTraversalEdgeIndex* FindCoverPoints(const FTraversalCoverQuery& Query, const int32 MaxResults, TArray<FTraversalCoverQueryResult>& OutResults) const;
+
+private:
+	UPROPERTY()
+	TArray<UTraversalEdgeIndex*> EdgeIndices;
+
+	TSet<FObjectKey> BakedComponents;
+};
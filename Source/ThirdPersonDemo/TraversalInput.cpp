@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalInput.h"
+
+void FTraversalInputBuffer::Buffer(const ETraversalInputAction::Type Action, const double Time)
+{
+	if (Time == LastActedTime) return;
+
+	Actions |= Action;
+	PressTimes[FMath::CountTrailingZeros(Action)] = Time;
+}
+
+void FTraversalInputBuffer::OnActed(const double Time)
+{
+	LastActedTime = Time;
+	for (int32 Slot = 0; Slot < UE_ARRAY_COUNT(PressTimes); ++Slot)
+	{
+		if (PressTimes[Slot] == Time) Actions &= ~(1 << Slot);
+	}
+}
+
+void FTraversalInputBuffer::Consume(const ETraversalInputAction::Type Action)
+{
+	Actions &= ~Action;
+}
+
+void FTraversalInputBuffer::ConsumeActed(const ETraversalInputAction::Type Action)
+{
+	OnActed(PressTimes[FMath::CountTrailingZeros(Action)]);
+	Consume(Action);
+}
+
+uint8 FTraversalInputBuffer::GetBufferedActions(const double Time, const float Window)
+{
+	for (int32 Slot = 0; Slot < UE_ARRAY_COUNT(PressTimes); ++Slot)
+	{
+		if (Time - PressTimes[Slot] > Window) Actions &= ~(1 << Slot);
+	}
+	return Actions;
+}
+
+void FTraversalInputBuffer::Reset()
+{
+	Actions = ETraversalInputAction::None;
+	LastActedTime = -1.0;
+}
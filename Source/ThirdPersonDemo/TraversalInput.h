@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Action bindings of the traversal character, as bits of FTraversalInputFrame::Actions **/
+namespace ETraversalInputAction
+{
+	enum Type : uint8
+	{
+		None = 0,
+		Jump = 1 << 0,
+		ClimbUp = 1 << 1,
+		DropDown = 1 << 2,
+		ToggleCover = 1 << 3,
+		Aim = 1 << 4,
+
+		/** Edge-triggered actions that wait in FTraversalInputBuffer when pressed too early **/
+		Buffered = Jump | ClimbUp | DropDown | ToggleCover
+	};
+}
+
+/** Everything the traversal character reads from input on a frame **/
+struct FTraversalInputFrame
+{
+	/** MoveForward/MoveRight axis values **/
+	float MoveForward = 0.f;
+	float MoveRight = 0.f;
+
+	/** Control rotation **/
+	float ControlYaw = 0.f;
+	float ControlPitch = 0.f;
+
+	/** ETraversalInputAction bits of the actions held down this frame **/
+	uint8 Actions = ETraversalInputAction::None;
+};
+
+/**
+ * Presses of traversal actions that could not be acted on yet, e.g. ClimbUp a frame before grabbing the ledge.
+ * Keeps the time of the last press of each action so it can be retried until it is acted on or too old.
+ */
+struct FTraversalInputBuffer
+{
+	/** Remember a press that was not acted on. Ignored if another press at the same time was, e.g. Jump and ClimbUp on one key **/
+	void Buffer(const ETraversalInputAction::Type Action, const double Time);
+
+	/** A press at Time was acted on. Drops the other presses buffered at that time **/
+	void OnActed(const double Time);
+
+	/** Forget a buffered press of the action **/
+	void Consume(const ETraversalInputAction::Type Action);
+
+	/** A buffered press of the action was acted on. Drops it and the presses buffered along with it **/
+	void ConsumeActed(const ETraversalInputAction::Type Action);
+
+	/** Drop presses older than Window and return the ETraversalInputAction bits still buffered **/
+	uint8 GetBufferedActions(const double Time, const float Window);
+
+	void Reset();
+
+private:
+	/** Time of the buffered press, per action bit **/
+	double PressTimes[8] = {};
+
+	/** ETraversalInputAction bits of the buffered presses **/
+	uint8 Actions = ETraversalInputAction::None;
+
+	/** Time of the last press that was acted on **/
+	double LastActedTime = -1.0;
+};
@@ -0,0 +1,241 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalKernel.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "TraversalProfile.h"
+
+static TAutoConsoleVariable<int32> CVarTraversalMinParallelBatch(
+	TEXT("traversal.Kernel.MinParallelBatch"),
+	256,
+	TEXT("Traversal batches smaller than this run their kernels on the calling thread."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTraversalParallelChunkSize(
+	TEXT("traversal.Kernel.ParallelChunkSize"),
+	64,
+	TEXT("Characters each worker task runs a kernel for. The kernels are a few dozen instructions per character, so single characters are not worth a task."),
+	ECVF_Default);
+
+namespace
+{
+	void DecideDefaultMove(FTraversalBatch& Batch, const int32 Index, uint8& Decision)
+	{
+		const uint8 Flags = Batch.Flags[Index];
+		const bool bIsAiming = (Flags & ETraversalBatchFlags::Aiming) != 0;
+		const bool bIsInCover = Batch.States[Index] == ETraversalState::InCover;
+
+		if (bIsInCover && !bIsAiming) return;
+
+		float MoveMagnitude = Batch.ControlMoveMagnitudes[Index];
+		if (MoveMagnitude == 0.0f) return;
+
+		// Clamp movement speed it if player is aiming when walking
+		if (bIsAiming && !(Flags & ETraversalBatchFlags::Falling))
+		{
+			MoveMagnitude = FMath::Min(MoveMagnitude, Batch.Profiles[Index]->MaxAimMoveRate);
+		}
+		Decision |= ETraversalDecision::Move;
+		Batch.MoveDirections[Index] = Batch.ControlMoveVectors[Index];
+		Batch.MoveMagnitudes[Index] = MoveMagnitude;
+
+		if (!bIsAiming) return;
+
+		// Keep character facing front when walking while aiming, and pop out of cover
+		Decision |= ETraversalDecision::FaceControl;
+		if (bIsInCover) Decision |= ETraversalDecision::ExitCover;
+	}
+
+	void DecideWallRunMove(FTraversalBatch& Batch, const int32 Index, uint8& Decision)
+	{
+		const uint8 Flags = Batch.Flags[Index];
+		const bool bIsRightWallRunning = (Flags & ETraversalBatchFlags::RightWall) != 0;
+
+		// If there is no more wall or the character touches the floor, exit wallrun
+		if (!(Flags & ETraversalBatchFlags::SideWallHit) || (Flags & ETraversalBatchFlags::DownHit))
+		{
+			Decision |= ETraversalDecision::ExitWallRun;
+			return;
+		}
+
+		// If there is no input in the wallrun direction, exit wallrun
+		const FVector& ControlMoveVector = Batch.ControlMoveVectors[Index];
+		const float ControlMoveMagnitude = Batch.ControlMoveMagnitudes[Index];
+		FVector WallRunDirection = TraversalMath::RotateAboutZ90(Batch.SideWallNormals[Index], bIsRightWallRunning);
+		if (ControlMoveMagnitude <= 0.1f || FVector::DotProduct(ControlMoveVector, WallRunDirection) <= 0.0f)
+		{
+			Decision |= ETraversalDecision::ExitWallRun;
+			return;
+		}
+
+		// If the character moves too slowly, exit wallrun
+		if (Batch.HorizontalVelocities[Index].Size() < Batch.Profiles[Index]->WallRunMinHorizontalSpeed)
+		{
+			Decision |= ETraversalDecision::ExitWallRun;
+			return;
+		}
+
+		// Steer back to the wall run offset, the only rotation of a character that needs sin/cos in a frame.
+		// The direction is rotated by the batch pass at the end of Decide
+		const float CorrectionAngle = (Batch.SideWallDistances[Index] - Batch.Profiles[Index]->WallRunOffset) / 2;
+		Batch.CorrectionYaws[Index] = TraversalMath::FYaw(bIsRightWallRunning ? CorrectionAngle : -CorrectionAngle);
+
+		Decision |= ETraversalDecision::Move;
+		Batch.MoveDirections[Index] = WallRunDirection;
+		Batch.MoveMagnitudes[Index] = ControlMoveMagnitude;
+	}
+
+	void DecideWallRunEnter(FTraversalBatch& Batch, const int32 Index, uint8& Decision)
+	{
+		const uint8 Flags = Batch.Flags[Index];
+		if (!(Flags & ETraversalBatchFlags::SideWallHit)) return;
+
+		// Only start when the player is controlling the character in the same direction as the wallrun
+		const FVector WallRunDirection = TraversalMath::RotateAboutZ90(Batch.SideWallNormals[Index], (Flags & ETraversalBatchFlags::RightWall) != 0);
+		if (Batch.ControlMoveMagnitudes[Index] <= 0.1f || FVector::DotProduct(Batch.ControlMoveVectors[Index], WallRunDirection) <= 0.0f) return;
+
+		Decision |= ETraversalDecision::EnterWallRun;
+	}
+}
+
+void FTraversalBatch::SetNum(const int32 Num)
+{
+	States.SetNum(Num, false);
+	Checks.SetNum(Num, false);
+	Flags.SetNum(Num, false);
+	Locations.SetNum(Num, false);
+	Forwards.SetNum(Num, false);
+	Velocities.SetNum(Num, false);
+	ControlMoveVectors.SetNum(Num, false);
+	ControlMoveMagnitudes.SetNum(Num, false);
+	CapsuleHalfHeights.SetNum(Num, false);
+	CapsuleHalfHeightsWithoutHemisphere.SetNum(Num, false);
+
+	Profiles.SetNum(Num, false);
+
+	HorizontalVelocities.SetNum(Num, false);
+
+	ProbeRequests.SetNum(Num, false);
+	SideProbeStarts.SetNum(Num, false);
+	SideRightProbeEnds.SetNum(Num, false);
+	SideLeftProbeEnds.SetNum(Num, false);
+	DownProbeEnds.SetNum(Num, false);
+	SideWallLocations.SetNum(Num, false);
+	SideWallNormals.SetNum(Num, false);
+
+	SideWallDistances.SetNum(Num, false);
+	CorrectionYaws.SetNum(Num, false);
+
+	Decisions.SetNum(Num, false);
+	MoveDirections.SetNum(Num, false);
+	MoveMagnitudes.SetNum(Num, false);
+}
+
+SIZE_T FTraversalBatch::GetAllocatedSize() const
+{
+	return States.GetAllocatedSize() + Checks.GetAllocatedSize() + Flags.GetAllocatedSize()
+		+ Locations.GetAllocatedSize() + Forwards.GetAllocatedSize() + Velocities.GetAllocatedSize()
+		+ ControlMoveVectors.GetAllocatedSize() + ControlMoveMagnitudes.GetAllocatedSize()
+		+ CapsuleHalfHeights.GetAllocatedSize() + CapsuleHalfHeightsWithoutHemisphere.GetAllocatedSize()
+		+ Profiles.GetAllocatedSize() + HorizontalVelocities.GetAllocatedSize()
+		+ ProbeRequests.GetAllocatedSize() + SideProbeStarts.GetAllocatedSize() + SideRightProbeEnds.GetAllocatedSize()
+		+ SideLeftProbeEnds.GetAllocatedSize() + DownProbeEnds.GetAllocatedSize()
+		+ SideWallLocations.GetAllocatedSize() + SideWallNormals.GetAllocatedSize()
+		+ SideWallDistances.GetAllocatedSize() + CorrectionYaws.GetAllocatedSize()
+		+ Decisions.GetAllocatedSize() + MoveDirections.GetAllocatedSize() + MoveMagnitudes.GetAllocatedSize();
+}
+
+void TraversalKernel::PlanProbes(FTraversalBatch& Batch, const int32 Begin, const int32 End)
+{
+	// Vector math of the whole range first. The side directions are written where the probe ends go and scaled into ends below,
+	// characters that request no side probe are left with a direction
+	const int32 Num = End - Begin;
+	TraversalMath::GetHorizontal(Batch.Velocities.GetData() + Begin, Batch.HorizontalVelocities.GetData() + Begin, Num);
+	TraversalMath::RotateAboutZ90(Batch.Forwards.GetData() + Begin, true, Batch.SideRightProbeEnds.GetData() + Begin, Num);
+	TraversalMath::RotateAboutZ90(Batch.Forwards.GetData() + Begin, false, Batch.SideLeftProbeEnds.GetData() + Begin, Num);
+
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		const uint8 Checks = Batch.Checks[Index];
+		const uint8 Flags = Batch.Flags[Index];
+
+		uint8 Requests = ETraversalBatchProbe::None;
+		if (Checks & ETraversalCheck::WallRunMove)
+		{
+			// If already wallrunning, keep checking if a wall is available on the current side and if the floor is reached
+			Requests |= (Flags & ETraversalBatchFlags::RightWall) ? ETraversalBatchProbe::SideRight : ETraversalBatchProbe::SideLeft;
+			Requests |= ETraversalBatchProbe::Down;
+		}
+		else if ((Checks & ETraversalCheck::WallRunEnter) && (Flags & ETraversalBatchFlags::Falling) && !(Flags & ETraversalBatchFlags::NoPredictedWall))
+		{
+			// Only look for a wall if the character is not falling too fast and moves fast enough for wallrun
+			if (Batch.HorizontalVelocities[Index].Size() >= Batch.Profiles[Index]->WallRunMinHorizontalSpeed && Batch.Velocities[Index].Z >= Batch.Profiles[Index]->WallRunMinVerticalVelocity)
+			{
+				Requests |= ETraversalBatchProbe::SideRight | ETraversalBatchProbe::SideLeft;
+			}
+		}
+
+		Batch.ProbeRequests[Index] = Requests;
+		if (Requests == ETraversalBatchProbe::None) continue;
+
+		const FVector& Location = Batch.Locations[Index];
+		const float SideDistance = Batch.Profiles[Index]->WallRunSideDistance;
+		const FVector SideTraceStart = Location + FVector::DownVector * Batch.CapsuleHalfHeightsWithoutHemisphere[Index];
+		Batch.SideProbeStarts[Index] = SideTraceStart;
+		Batch.SideRightProbeEnds[Index] = SideTraceStart + Batch.SideRightProbeEnds[Index] * SideDistance;
+		Batch.SideLeftProbeEnds[Index] = SideTraceStart + Batch.SideLeftProbeEnds[Index] * SideDistance;
+		Batch.DownProbeEnds[Index] = Location + FVector::DownVector * (Batch.CapsuleHalfHeights[Index] + 5.f);
+	}
+}
+
+void TraversalKernel::Decide(FTraversalBatch& Batch, const int32 Begin, const int32 End)
+{
+	// Wall distances of the whole range first, only read for characters whose side probe hit
+	const int32 Num = End - Begin;
+	TraversalMath::PointPlaneDist(Batch.Locations.GetData() + Begin, Batch.SideWallLocations.GetData() + Begin, Batch.SideWallNormals.GetData() + Begin, Batch.SideWallDistances.GetData() + Begin, Num);
+
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		uint8 Decision = ETraversalDecision::None;
+		Batch.CorrectionYaws[Index] = TraversalMath::FYaw();
+
+		if (Batch.Flags[Index] & ETraversalBatchFlags::HasController)
+		{
+			const uint8 Checks = Batch.Checks[Index];
+			if (Checks & ETraversalCheck::WallRunMove)
+			{
+				DecideWallRunMove(Batch, Index, Decision);
+			}
+			else if (Checks & ETraversalCheck::DefaultMove)
+			{
+				DecideDefaultMove(Batch, Index, Decision);
+			}
+
+			if ((Checks & ETraversalCheck::WallRunEnter) && (Batch.ProbeRequests[Index] & ETraversalBatchProbe::SideRight))
+			{
+				DecideWallRunEnter(Batch, Index, Decision);
+			}
+		}
+
+		Batch.Decisions[Index] = Decision;
+	}
+
+	// Steer wall runners back to their offset. Every other character has an identity yaw, which leaves its direction as is
+	TraversalMath::RotateAboutZ(Batch.MoveDirections.GetData() + Begin, Batch.CorrectionYaws.GetData() + Begin, Batch.MoveDirections.GetData() + Begin, Num);
+}
+
+void TraversalKernel::ParallelForBatch(FTraversalBatch& Batch, void (*Kernel)(FTraversalBatch&, const int32, const int32))
+{
+	const int32 Num = Batch.Num();
+	if (Num < CVarTraversalMinParallelBatch.GetValueOnGameThread())
+	{
+		Kernel(Batch, 0, Num);
+		return;
+	}
+
+	const int32 ChunkSize = FMath::Max(CVarTraversalParallelChunkSize.GetValueOnGameThread(), 1);
+	ParallelFor(FMath::DivideAndRoundUp(Num, ChunkSize), [&Batch, Kernel, Num, ChunkSize](const int32 ChunkIndex)
+	{
+		Kernel(Batch, ChunkIndex * ChunkSize, FMath::Min((ChunkIndex + 1) * ChunkSize, Num));
+	});
+}
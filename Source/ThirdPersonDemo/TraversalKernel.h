@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TraversalMath.h"
+#include "TraversalState.h"
+
+class UTraversalProfile;
+
+/** Per character flags of a traversal batch **/
+namespace ETraversalBatchFlags
+{
+	enum Type : uint8
+	{
+		None = 0,
+		HasController = 1 << 0,
+		Aiming = 1 << 1,
+		Falling = 1 << 2,
+		RunEntryChecks = 1 << 3,
+
+		/** Wall is (or is looked for first) on the right side. Updated by the probe pass **/
+		RightWall = 1 << 4,
+
+		/** Set by the probe pass **/
+		SideWallHit = 1 << 5,
+		DownHit = 1 << 6,
+
+		/** The jump trajectory passes no wall this frame, so wall run entry needs no side probes **/
+		NoPredictedWall = 1 << 7
+	};
+}
+
+/** Probes requested by TraversalKernel::PlanProbes **/
+namespace ETraversalBatchProbe
+{
+	enum Type : uint8
+	{
+		None = 0,
+
+		/** Side wall probes. When both are requested the left one only runs if the right one misses **/
+		SideRight = 1 << 0,
+		SideLeft = 1 << 1,
+
+		/** Ground probe ending a wall run **/
+		Down = 1 << 2
+	};
+}
+
+/** Decisions written by TraversalKernel::Decide and applied on the game thread **/
+namespace ETraversalDecision
+{
+	enum Type : uint8
+	{
+		None = 0,
+
+		/** AddMovementInput with MoveDirections/MoveMagnitudes **/
+		Move = 1 << 0,
+
+		/** Face the control rotation while aiming **/
+		FaceControl = 1 << 1,
+
+		ExitCover = 1 << 2,
+		ExitWallRun = 1 << 3,
+		EnterWallRun = 1 << 4
+	};
+}
+
+/**
+ * Structure of arrays holding the traversal state, tuning and decisions of a batch of characters.
+ * Filled on the game thread, evaluated by the TraversalKernel functions, then applied back to the characters.
+ */
+struct FTraversalBatch
+{
+	/** Resize every array. Never shrinks the allocations **/
+	void SetNum(const int32 Num);
+
+	int32 Num() const { return States.Num(); }
+
+	/** Heap bytes held by the arrays **/
+	SIZE_T GetAllocatedSize() const;
+
+	// State
+	TArray<ETraversalState> States;
+	TArray<uint8> Checks;
+	TArray<uint8> Flags;
+	TArray<FVector> Locations;
+	TArray<FVector> Forwards;
+	TArray<FVector> Velocities;
+	TArray<FVector> ControlMoveVectors;
+	TArray<float> ControlMoveMagnitudes;
+	TArray<float> CapsuleHalfHeights;
+	TArray<float> CapsuleHalfHeightsWithoutHemisphere;
+
+	// Tuning, shared by every character of a profile
+	TArray<const UTraversalProfile*> Profiles;
+
+	// Horizontal part of Velocities. Set by PlanProbes
+	TArray<FVector> HorizontalVelocities;
+
+	// Probes
+	TArray<uint8> ProbeRequests;
+	TArray<FVector> SideProbeStarts;
+	TArray<FVector> SideRightProbeEnds;
+	TArray<FVector> SideLeftProbeEnds;
+	TArray<FVector> DownProbeEnds;
+	TArray<FVector> SideWallLocations;
+	TArray<FVector> SideWallNormals;
+
+	// Signed distance to the side wall, and the yaw steering back to the wall run offset. Set by Decide
+	TArray<float> SideWallDistances;
+	TArray<TraversalMath::FYaw> CorrectionYaws;
+
+	// Decisions
+	TArray<uint8> Decisions;
+	TArray<FVector> MoveDirections;
+	TArray<float> MoveMagnitudes;
+};
+
+/**
+ * Traversal decision logic over a range [Begin, End) of a FTraversalBatch. Only touches its own range, so safe to run with ParallelFor.
+ * The vector math of a range runs first as one SIMD batch pass over the arrays, then the per character logic reads its results.
+ */
+namespace TraversalKernel
+{
+	/** Work out which probes the characters need this frame and build their segments **/
+	void PlanProbes(FTraversalBatch& Batch, const int32 Begin, const int32 End);
+
+	/** Decide movement and wall run transitions from the state and probe results **/
+	void Decide(FTraversalBatch& Batch, const int32 Begin, const int32 End);
+
+	/** Run a kernel over the whole batch, in chunks across worker threads when the batch is large enough **/
+	void ParallelForBatch(FTraversalBatch& Batch, void (*Kernel)(FTraversalBatch&, const int32, const int32));
+}
@@ -0,0 +1,193 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalLedgeScanner.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "TraversalDebug.h"
+#include "TraversalEdgeIndexSubsystem.h"
+#include "TraversalStats.h"
+
+namespace
+{
+	/** Surfaces flatter than this can be stood on, steeper than WallMaxNormalZ are walls **/
+	constexpr float WalkableMinNormalZ = 0.7f;
+	constexpr float WallMaxNormalZ = 0.3f;
+
+	/** Largest height difference between two hits on the same top surface **/
+	constexpr float SurfaceStepTolerance = 10.f;
+
+	/** Components to test the ray fan against, from one overlap of the scanned volume **/
+	typedef TArray<UPrimitiveComponent*, TInlineAllocator<8>> FLedgeCandidates;
+
+	struct FLedgeRayCaster
+	{
+		const AActor* Actor;
+		const FLedgeCandidates& Candidates;
+		const FCollisionQueryParams& QueryParams;
+		bool bDrawDebug;
+
+		/** Closest hit of a ray against the candidates. Narrow phase only, the scene is not queried **/
+		bool Cast(const FVector& Start, const FVector& End, FHitResult& OutHit) const
+		{
+			INC_DWORD_STAT(STAT_TraversalLedgeScanRays);
+
+			bool bHit = false;
+			FHitResult Hit;
+			for (UPrimitiveComponent* Component : Candidates)
+			{
+				if (Component->LineTraceComponent(Hit, Start, End, QueryParams) && (!bHit || Hit.Time < OutHit.Time))
+				{
+					OutHit = Hit;
+					bHit = true;
+				}
+			}
+
+#if WITH_TRAVERSAL_DEBUG
+			TraversalDebug::RecordProbe(Actor, ETraversalProbe::LedgeScan, Start, End, bHit, OutHit.ImpactPoint, bDrawDebug);
+#endif
+			return bHit;
+		}
+	};
+
+	bool FindCandidates(const AActor* Actor, const FTraversalLedgeScanSettings& Settings, const ECollisionChannel Channel, const TArray<FOverlapResult>& Overlaps, FLedgeCandidates& OutCandidates)
+	{
+		// Geometry already covered by the baked edge index is left to it
+		const UTraversalEdgeIndexSubsystem* EdgeIndexSubsystem = Settings.bSkipBaked ? Actor->GetWorld()->GetSubsystem<UTraversalEdgeIndexSubsystem>() : nullptr;
+
+		// Overlaps also report triggers and other overlap only components, the line traces only stopped on blocking ones
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			UPrimitiveComponent* Component = Overlap.GetComponent();
+			if (Component == nullptr || Component->GetCollisionResponseToChannel(Channel) != ECR_Block) continue;
+			if (EdgeIndexSubsystem != nullptr && EdgeIndexSubsystem->IsBaked(Component)) continue;
+			OutCandidates.AddUnique(Component);
+		}
+		return OutCandidates.Num() > 0;
+	}
+}
+
+FTraversalLedgeScanQuery TraversalLedgeScanner::MakeQuery(const AActor* Actor, const FTraversalLedgeScanSettings& Settings)
+{
+	// Box around the whole fan: from the character to the end of the depth reach, from below the lowest lip to the clearance reach
+	const float Length = Settings.ForwardDistance + Settings.DepthReach;
+	const float Bottom = Settings.MinHeight - Settings.LipInset;
+	const float Top = Settings.MaxHeight + Settings.ClearanceReach;
+
+	FTraversalLedgeScanQuery Query;
+	Query.Center = Settings.Origin + Settings.Forward * (Length * 0.5f) + FVector::UpVector * ((Bottom + Top) * 0.5f);
+	Query.Rotation = FRotationMatrix::MakeFromX(Settings.Forward).ToQuat();
+	Query.Shape = FCollisionShape::MakeBox(FVector(Length * 0.5f, Settings.LipInset, (Top - Bottom) * 0.5f));
+
+	// Same query setup as the line traces the scan replaces
+	Query.Channel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery_MAX);
+	Query.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(TraversalLedgeScan), false, Actor);
+	return Query;
+}
+
+bool TraversalLedgeScanner::Scan(const AActor* Actor, const FTraversalLedgeScanSettings& Settings, FTraversalLedgeProfile& OutProfile)
+{
+	const FTraversalLedgeScanQuery Query = MakeQuery(Actor, Settings);
+
+	INC_DWORD_STAT(STAT_TraversalTraces);
+	++GTraversalTraceCount;
+
+	TArray<FOverlapResult> Overlaps;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TraversalLedgeScan);
+		Actor->GetWorld()->OverlapMultiByChannel(Overlaps, Query.Center, Query.Rotation, Query.Channel, Query.Shape, Query.QueryParams);
+	}
+	return ScanOverlaps(Actor, Settings, Overlaps, OutProfile);
+}
+
+bool TraversalLedgeScanner::ScanOverlaps(const AActor* Actor, const FTraversalLedgeScanSettings& Settings, const TArray<FOverlapResult>& Overlaps, FTraversalLedgeProfile& OutProfile)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraversalLedgeScan);
+
+	const ECollisionChannel Channel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery_MAX);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalLedgeScan), false, Actor);
+
+	FLedgeCandidates Candidates;
+	if (!FindCandidates(Actor, Settings, Channel, Overlaps, Candidates)) return false;
+
+	const FLedgeRayCaster Caster{ Actor, Candidates, QueryParams, Settings.bDrawDebug };
+	const FVector& Origin = Settings.Origin;
+	const FVector& Forward = Settings.Forward;
+	const float ScanLength = Settings.ForwardDistance + Settings.DepthReach;
+	const int32 NumVerticalRays = FMath::Max(Settings.NumVerticalRays, 2);
+	const int32 NumHorizontalRays = FMath::Max(Settings.NumHorizontalRays, 2);
+
+	// Downward fan. The first walkable hit in the height range within reach is the lip,
+	// following hits at the same height measure how deep the top surface goes
+	int32 LipRay = INDEX_NONE;
+	float LipZ = 0.f;
+	float LastSurfaceDistance = 0.f;
+	for (int32 Ray = 0; Ray < NumVerticalRays; ++Ray)
+	{
+		const float Distance = ScanLength * (Ray + 1) / NumVerticalRays;
+		if (LipRay == INDEX_NONE && Distance > Settings.ForwardDistance) break;
+
+		const FVector Top = Origin + Forward * Distance + FVector::UpVector * Settings.MaxHeight;
+		const FVector Bottom = Origin + Forward * Distance + FVector::UpVector * Settings.MinHeight;
+		FHitResult Hit;
+		const bool bSurfaceHit = Caster.Cast(Top, Bottom, Hit) && !Hit.bStartPenetrating && Hit.ImpactNormal.Z >= WalkableMinNormalZ;
+
+		if (LipRay == INDEX_NONE)
+		{
+			if (!bSurfaceHit) continue;
+			LipRay = Ray;
+			LipZ = Hit.ImpactPoint.Z;
+			LastSurfaceDistance = Distance;
+		}
+		else
+		{
+			if (!bSurfaceHit || FMath::Abs(Hit.ImpactPoint.Z - LipZ) > SurfaceStepTolerance) break;
+			LastSurfaceDistance = Distance;
+		}
+	}
+	if (LipRay == INDEX_NONE) return false;
+
+	// Forward fan over the height range. The highest wall hit below the lip is kept in case the wall ray below misses,
+	// e.g. on a bevelled lip
+	FHitResult WallHit;
+	bool bWallHit = false;
+	const float FanBottom = Settings.MinHeight - Settings.LipInset;
+	for (int32 Ray = 0; Ray < NumHorizontalRays; ++Ray)
+	{
+		const float Height = FanBottom + (Settings.MaxHeight - FanBottom) * Ray / (NumHorizontalRays - 1);
+		if (Origin.Z + Height >= LipZ) break;
+
+		const FVector Start = Origin + FVector::UpVector * Height;
+		FHitResult Hit;
+		if (Caster.Cast(Start, Start + Forward * Settings.ForwardDistance, Hit) && FMath::Abs(Hit.ImpactNormal.Z) <= WallMaxNormalZ)
+		{
+			WallHit = Hit;
+			bWallHit = true;
+		}
+	}
+
+	// Wall just below the lip, where hands go
+	const FVector WallRayStart = FVector(Origin.X, Origin.Y, LipZ - Settings.LipInset);
+	FHitResult LipWallHit;
+	if (Caster.Cast(WallRayStart, WallRayStart + Forward * ScanLength, LipWallHit) && FMath::Abs(LipWallHit.ImpactNormal.Z) <= WallMaxNormalZ)
+	{
+		WallHit = LipWallHit;
+		bWallHit = true;
+	}
+	if (!bWallHit) return false;
+
+	const FVector WallNormal = FVector(WallHit.ImpactNormal.X, WallHit.ImpactNormal.Y, 0.f).GetSafeNormal();
+	OutProfile.WallNormal = WallNormal;
+	OutProfile.WallLocation = FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, LipZ - Settings.LipInset);
+	OutProfile.LipLocation = FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, LipZ);
+
+	const float WallDistance = FVector::DotProduct(WallHit.ImpactPoint - Origin, Forward);
+	OutProfile.Depth = FMath::Max(0.f, LastSurfaceDistance - WallDistance);
+
+	// Free space above the lip, just inside the wall
+	const FVector ClearanceStart = OutProfile.LipLocation - WallNormal * Settings.LipInset + FVector::UpVector;
+	FHitResult ClearanceHit;
+	OutProfile.Clearance = Caster.Cast(ClearanceStart, ClearanceStart + FVector::UpVector * Settings.ClearanceReach, ClearanceHit) ? ClearanceHit.Distance : Settings.ClearanceReach;
+
+	return true;
+}
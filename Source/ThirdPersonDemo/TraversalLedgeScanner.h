@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "Engine/EngineTypes.h"
+
+/** Shape of a ledge in front of a character, as measured by TraversalLedgeScanner::Scan **/
+struct FTraversalLedgeProfile
+{
+	/** Point on top of the lip, straight above the wall **/
+	FVector LipLocation = FVector::ZeroVector;
+
+	/** Point on the wall just below the lip, and its horizontal outward normal **/
+	FVector WallLocation = FVector::ZeroVector;
+	FVector WallNormal = FVector::ForwardVector;
+
+	/** How far the top surface extends back from the wall, up to the depth reach of the scan **/
+	float Depth = 0.f;
+
+	/** Free height above the lip, up to the clearance reach of the scan **/
+	float Clearance = 0.f;
+};
+
+/** Where and how densely to scan for a ledge **/
+struct FTraversalLedgeScanSettings
+{
+	/** Character location and horizontal facing **/
+	FVector Origin = FVector::ZeroVector;
+	FVector Forward = FVector::ForwardVector;
+
+	/** Horizontal reach of the scan **/
+	float ForwardDistance = 50.f;
+
+	/** Lip height range, relative to Origin **/
+	float MinHeight = 30.f;
+	float MaxHeight = 100.f;
+
+	/** Distance below the lip the wall is measured at **/
+	float LipInset = 20.f;
+
+	/** How far past ForwardDistance the top surface is scanned for Depth, and how high above the lip for Clearance **/
+	float DepthReach = 40.f;
+	float ClearanceReach = 100.f;
+
+	/** Number of downward rays spread over ForwardDistance + DepthReach, and of forward rays spread over the height range **/
+	int32 NumVerticalRays = 6;
+	int32 NumHorizontalRays = 5;
+
+	/** Ignore components baked into the edge index of the level, their ledges come from the index **/
+	bool bSkipBaked = false;
+
+	/** Record the rays in the traversal debug visualizer as drawable **/
+	bool bDrawDebug = false;
+};
+
+/** Overlap of the scanned volume that finds the components the ray fan is tested against **/
+struct FTraversalLedgeScanQuery
+{
+	FVector Center = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FCollisionShape Shape;
+	ECollisionChannel Channel = ECC_Visibility;
+	FCollisionQueryParams QueryParams;
+};
+
+/**
+ * Ledge detection from a fixed fan of downward and forward rays. The fan is tested against the components found by a
+ * single overlap of the scanned volume, so the physics scene is only queried once however many rays are cast.
+ * Replaces the serial down-then-forward trace pair, whose forward trace depended on the height of the down trace.
+ */
+namespace TraversalLedgeScanner
+{
+	/** @return True if a ledge was found within the settings, with its profile in OutProfile **/
+	bool Scan(const AActor* Actor, const FTraversalLedgeScanSettings& Settings, FTraversalLedgeProfile& OutProfile);
+
+	/** The overlap Scan starts with, for callers that issue it themselves, e.g. asynchronously **/
+	FTraversalLedgeScanQuery MakeQuery(const AActor* Actor, const FTraversalLedgeScanSettings& Settings);
+
+	/** Scan without querying the scene, testing the ray fan against the results of the overlap from MakeQuery **/
+	bool ScanOverlaps(const AActor* Actor, const FTraversalLedgeScanSettings& Settings, const TArray<FOverlapResult>& Overlaps, FTraversalLedgeProfile& OutProfile);
+}
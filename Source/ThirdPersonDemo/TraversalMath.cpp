@@ -0,0 +1,259 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalMath.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+void TraversalMath::RotateAboutZ(const FVector* Vectors, const FYaw* Yaws, FVector* OutVectors, const int32 Num)
+{
+	// (X, Y, Z) * (C, C, 1) + (Y, X, Z) * (-S, S, 0)
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const VectorRegister Vector = VectorLoadFloat3_W0(&Vectors[Index]);
+		const VectorRegister Swapped = VectorSwizzle(Vector, 1, 0, 2, 3);
+		const VectorRegister CosScale = MakeVectorRegister(Yaws[Index].Cos, Yaws[Index].Cos, 1.f, 0.f);
+		const VectorRegister SinScale = MakeVectorRegister(-Yaws[Index].Sin, Yaws[Index].Sin, 0.f, 0.f);
+		VectorStoreFloat3(VectorMultiplyAdd(Swapped, SinScale, VectorMultiply(Vector, CosScale)), &OutVectors[Index]);
+	}
+}
+
+void TraversalMath::RotateAboutZ90(const FVector* Vectors, const bool bClockWise, FVector* OutVectors, const int32 Num)
+{
+	// (Y, X, Z) * (-1, 1, 1) clockwise, (Y, X, Z) * (1, -1, 1) otherwise
+	const VectorRegister Signs = bClockWise ? MakeVectorRegister(-1.f, 1.f, 1.f, 0.f) : MakeVectorRegister(1.f, -1.f, 1.f, 0.f);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const VectorRegister Vector = VectorLoadFloat3_W0(&Vectors[Index]);
+		VectorStoreFloat3(VectorMultiply(VectorSwizzle(Vector, 1, 0, 2, 3), Signs), &OutVectors[Index]);
+	}
+}
+
+void TraversalMath::GetHorizontal(const FVector* Vectors, FVector* OutVectors, const int32 Num)
+{
+	const VectorRegister HorizontalMask = MakeVectorRegister(1.f, 1.f, 0.f, 0.f);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		VectorStoreFloat3(VectorMultiply(VectorLoadFloat3_W0(&Vectors[Index]), HorizontalMask), &OutVectors[Index]);
+	}
+}
+
+void TraversalMath::PointPlaneDist(const FVector* Points, const FVector* PlaneOrigins, const FVector* PlaneNormals, float* OutDistances, const int32 Num)
+{
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const VectorRegister Offset = VectorSubtract(VectorLoadFloat3_W0(&Points[Index]), VectorLoadFloat3_W0(&PlaneOrigins[Index]));
+		VectorStoreFloat1(VectorDot3(Offset, VectorLoadFloat3_W0(&PlaneNormals[Index])), &OutDistances[Index]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Microbenchmarks
+
+namespace
+{
+	/** Best time over the iterations, in nanoseconds per element **/
+	template<typename FunctionType>
+	double TimeNanosecondsPerElement(const int32 Iterations, const int32 Num, FunctionType Function)
+	{
+		double BestSeconds = TNumericLimits<double>::Max();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Function();
+			BestSeconds = FMath::Min(BestSeconds, FPlatformTime::Seconds() - StartTime);
+		}
+		return BestSeconds * 1e9 / Num;
+	}
+
+	float MaxError(const TArray<FVector>& Expected, const TArray<FVector>& Actual)
+	{
+		float Error = 0.f;
+		for (int32 Index = 0; Index < Expected.Num(); ++Index)
+		{
+			Error = FMath::Max(Error, (Expected[Index] - Actual[Index]).GetAbsMax());
+		}
+		return Error;
+	}
+
+	float MaxError(const TArray<float>& Expected, const TArray<float>& Actual)
+	{
+		float Error = 0.f;
+		for (int32 Index = 0; Index < Expected.Num(); ++Index)
+		{
+			Error = FMath::Max(Error, FMath::Abs(Expected[Index] - Actual[Index]));
+		}
+		return Error;
+	}
+
+	/** Compare the scalar and SIMD batch traversal math helpers with the ones they replace, on random data **/
+	bool RunMathBenchmark(const int32 Num, const int32 Iterations, const float Tolerance)
+	{
+		FRandomStream Random(0x7261);
+		TArray<FVector> Vectors, Origins, Normals;
+		TArray<float> YawDegrees;
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Vectors.Add(Random.GetUnitVector() * Random.FRandRange(1.f, 1000.f));
+			Origins.Add(Random.GetUnitVector() * Random.FRandRange(1.f, 1000.f));
+			Normals.Add(Random.GetUnitVector());
+			YawDegrees.Add(Random.FRandRange(-180.f, 180.f));
+		}
+
+		TArray<FVector> Expected, Scalar, Batch;
+		TArray<float> ExpectedDistances, BatchDistances;
+		Expected.SetNumUninitialized(Num);
+		Scalar.SetNumUninitialized(Num);
+		Batch.SetNumUninitialized(Num);
+		ExpectedDistances.SetNumUninitialized(Num);
+		BatchDistances.SetNumUninitialized(Num);
+		TArray<TraversalMath::FYaw> Yaws;
+		Yaws.SetNumUninitialized(Num);
+
+		TSharedRef<FJsonObject> ResultsObject = MakeShared<FJsonObject>();
+		bool bPassed = true;
+		auto AddResult = [&ResultsObject, &bPassed, Tolerance](const TCHAR* Name, const double BaselineNs, const double ScalarNs, const double BatchNs, const float Error)
+		{
+			TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+			ResultObject->SetNumberField(TEXT("BaselineNs"), BaselineNs);
+			ResultObject->SetNumberField(TEXT("ScalarNs"), ScalarNs);
+			ResultObject->SetNumberField(TEXT("BatchNs"), BatchNs);
+			ResultObject->SetNumberField(TEXT("ScalarSpeedup"), BaselineNs / FMath::Max(ScalarNs, 1e-6));
+			ResultObject->SetNumberField(TEXT("BatchSpeedup"), BaselineNs / FMath::Max(BatchNs, 1e-6));
+			ResultObject->SetNumberField(TEXT("MaxError"), Error);
+			ResultsObject->SetObjectField(Name, ResultObject);
+			bPassed &= Error <= Tolerance;
+			UE_LOG(LogTemp, Log, TEXT("%-20s baseline %7.2f ns, scalar %7.2f ns (x%.2f), batch %7.2f ns (x%.2f), max error %g"), Name,
+				BaselineNs, ScalarNs, BaselineNs / FMath::Max(ScalarNs, 1e-6), BatchNs, BaselineNs / FMath::Max(BatchNs, 1e-6), Error);
+		};
+
+		// Rotation by a different yaw per character, the traversal versions include computing each yaw
+		{
+			const double BaselineNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) Expected[Index] = UKismetMathLibrary::RotateAngleAxis(Vectors[Index], YawDegrees[Index], FVector::UpVector);
+			});
+			const double ScalarNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) Scalar[Index] = TraversalMath::RotateAboutZ(Vectors[Index], TraversalMath::FYaw(YawDegrees[Index]));
+			});
+			const double BatchNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) Yaws[Index] = TraversalMath::FYaw(YawDegrees[Index]);
+				TraversalMath::RotateAboutZ(Vectors.GetData(), Yaws.GetData(), Batch.GetData(), Num);
+			});
+			AddResult(TEXT("RotateAboutZ"), BaselineNs, ScalarNs, BatchNs, FMath::Max(MaxError(Expected, Scalar), MaxError(Expected, Batch)));
+		}
+
+		// Several rotations by the same yaw, as done with the control or actor yaw in a frame
+		{
+			const float Yaw = YawDegrees[0];
+			const double BaselineNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) Expected[Index] = UKismetMathLibrary::RotateAngleAxis(Vectors[Index], Yaw, FVector::UpVector);
+			});
+			const double ScalarNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				const TraversalMath::FYaw SharedYaw(Yaw);
+				for (int32 Index = 0; Index < Num; ++Index) Scalar[Index] = TraversalMath::RotateAboutZ(Vectors[Index], SharedYaw);
+			});
+			const double BatchNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				const TraversalMath::FYaw SharedYaw(Yaw);
+				for (int32 Index = 0; Index < Num; ++Index) Yaws[Index] = SharedYaw;
+				TraversalMath::RotateAboutZ(Vectors.GetData(), Yaws.GetData(), Batch.GetData(), Num);
+			});
+			AddResult(TEXT("RotateAboutZShared"), BaselineNs, ScalarNs, BatchNs, FMath::Max(MaxError(Expected, Scalar), MaxError(Expected, Batch)));
+		}
+
+		{
+			const double BaselineNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) Expected[Index] = UKismetMathLibrary::RotateAngleAxis(Vectors[Index], 90.f, FVector::UpVector);
+			});
+			const double ScalarNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) Scalar[Index] = TraversalMath::RotateAboutZ90(Vectors[Index], true);
+			});
+			const double BatchNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				TraversalMath::RotateAboutZ90(Vectors.GetData(), true, Batch.GetData(), Num);
+			});
+			AddResult(TEXT("RotateAboutZ90"), BaselineNs, ScalarNs, BatchNs, FMath::Max(MaxError(Expected, Scalar), MaxError(Expected, Batch)));
+		}
+
+		{
+			const double BaselineNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					FVector Horizontal = Vectors[Index];
+					Horizontal.Z = 0;
+					Expected[Index] = Horizontal;
+				}
+			});
+			const double ScalarNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) Scalar[Index] = TraversalMath::GetHorizontal(Vectors[Index]);
+			});
+			const double BatchNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				TraversalMath::GetHorizontal(Vectors.GetData(), Batch.GetData(), Num);
+			});
+			AddResult(TEXT("GetHorizontal"), BaselineNs, ScalarNs, BatchNs, FMath::Max(MaxError(Expected, Scalar), MaxError(Expected, Batch)));
+		}
+
+		// The engine helper is already the scalar version
+		{
+			const double BaselineNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				for (int32 Index = 0; Index < Num; ++Index) ExpectedDistances[Index] = FVector::PointPlaneDist(Vectors[Index], Origins[Index], Normals[Index]);
+			});
+			const double BatchNs = TimeNanosecondsPerElement(Iterations, Num, [&]()
+			{
+				TraversalMath::PointPlaneDist(Vectors.GetData(), Origins.GetData(), Normals.GetData(), BatchDistances.GetData(), Num);
+			});
+			AddResult(TEXT("PointPlaneDist"), BaselineNs, BaselineNs, BatchNs, MaxError(ExpectedDistances, BatchDistances));
+		}
+
+		TSharedRef<FJsonObject> ReportObject = MakeShared<FJsonObject>();
+		ReportObject->SetNumberField(TEXT("Count"), Num);
+		ReportObject->SetNumberField(TEXT("Iterations"), Iterations);
+		ReportObject->SetNumberField(TEXT("Tolerance"), Tolerance);
+		ReportObject->SetObjectField(TEXT("Results"), ResultsObject);
+		ReportObject->SetBoolField(TEXT("Passed"), bPassed);
+
+		FString Json;
+		FJsonSerializer::Serialize(ReportObject, TJsonWriterFactory<>::Create(&Json));
+		const FString JsonPath = FPaths::ProfilingDir() / TEXT("Traversal") / FString::Printf(TEXT("TraversalMath-%s.json"), *FDateTime::Now().ToString());
+		FFileHelper::SaveStringToFile(Json, *JsonPath);
+
+		UE_LOG(LogTemp, Log, TEXT("Traversal math benchmark %s, report written to %s"), bPassed ? TEXT("passed") : TEXT("failed"), *JsonPath);
+		return bPassed;
+	}
+}
+
+static FAutoConsoleCommand TraversalMathBenchmarkCommand(
+	TEXT("Traversal.Math.Benchmark"),
+	TEXT("Time the scalar and SIMD batch traversal math helpers against the engine helpers they replace. Args: Count=4096 Iterations=50 Tolerance=0.001 Quit"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const FString CommandLine = FString::Join(Args, TEXT(" "));
+		int32 Count = 4096;
+		int32 Iterations = 50;
+		float Tolerance = 0.001f;
+		FParse::Value(*CommandLine, TEXT("Count="), Count);
+		FParse::Value(*CommandLine, TEXT("Iterations="), Iterations);
+		FParse::Value(*CommandLine, TEXT("Tolerance="), Tolerance);
+
+		const bool bPassed = RunMathBenchmark(FMath::Max(1, Count), FMath::Max(1, Iterations), Tolerance);
+		if (Args.Contains(TEXT("Quit")))
+		{
+			FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+		}
+	}));
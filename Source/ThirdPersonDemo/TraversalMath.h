@@ -0,0 +1,55 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Traversal vector helpers. Rotations about Z take a precomputed FYaw so a frame pays for one sin/cos per yaw,
+ * and right angles need none. Batch versions process one character per SIMD register.
+ */
+namespace TraversalMath
+{
+	/** Sine and cosine of a yaw, computed once and reused by every rotation about Z by that yaw **/
+	struct FYaw
+	{
+		FYaw() = default;
+		explicit FYaw(const float Degrees)
+		{
+			FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(Degrees));
+		}
+
+		float Sin = 0.f;
+		float Cos = 1.f;
+	};
+
+	/** Rotate about Z by a yaw. Same convention as FVector::RotateAngleAxis about FVector::UpVector **/
+	FORCEINLINE FVector RotateAboutZ(const FVector& InVector, const FYaw& Yaw)
+	{
+		return FVector(InVector.X * Yaw.Cos - InVector.Y * Yaw.Sin, InVector.X * Yaw.Sin + InVector.Y * Yaw.Cos, InVector.Z);
+	}
+
+	/** Rotate by a right angle about Z, without trig **/
+	FORCEINLINE FVector RotateAboutZ90(const FVector& InVector, const bool bClockWise)
+	{
+		return bClockWise ? FVector(-InVector.Y, InVector.X, InVector.Z) : FVector(InVector.Y, -InVector.X, InVector.Z);
+	}
+
+	/** Project on the horizontal plane **/
+	FORCEINLINE FVector GetHorizontal(const FVector& InVector)
+	{
+		return FVector(InVector.X, InVector.Y, 0.f);
+	}
+
+	/** Batch RotateAboutZ, OutVectors may alias Vectors **/
+	void RotateAboutZ(const FVector* Vectors, const FYaw* Yaws, FVector* OutVectors, const int32 Num);
+
+	/** Batch RotateAboutZ90, OutVectors may alias Vectors **/
+	void RotateAboutZ90(const FVector* Vectors, const bool bClockWise, FVector* OutVectors, const int32 Num);
+
+	/** Batch GetHorizontal, OutVectors may alias Vectors **/
+	void GetHorizontal(const FVector* Vectors, FVector* OutVectors, const int32 Num);
+
+	/** Batch FVector::PointPlaneDist **/
+	void PointPlaneDist(const FVector* Points, const FVector* PlaneOrigins, const FVector* PlaneNormals, float* OutDistances, const int32 Num);
+}
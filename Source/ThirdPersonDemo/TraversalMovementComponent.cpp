@@ -0,0 +1,465 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "ThirdPersonDemoCharacter.h"
+
+namespace
+{
+	/** Same rounding as FVector_NetQuantize10, so the server moves the capsule to exactly the same target **/
+	FVector QuantizeAnchorLocation(const FVector& Location)
+	{
+		return FVector(FMath::RoundToInt(Location.X * 10.f), FMath::RoundToInt(Location.Y * 10.f), FMath::RoundToInt(Location.Z * 10.f)) / 10.f;
+	}
+
+	/** Same rounding as FRotator::SerializeCompressedShort **/
+	FRotator QuantizeAnchorRotation(const FRotator& Rotation)
+	{
+		return FRotator(
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Pitch)),
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Yaw)),
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Roll)));
+	}
+
+	/** Packed movement RPCs always serialize through a bit writer or reader **/
+	int64 GetBitPosition(const FArchive& Ar)
+	{
+		return Ar.IsSaving() ? static_cast<const FBitWriter&>(Ar).GetNumBits() : static_cast<const FBitReader&>(Ar).GetPosBits();
+	}
+
+	/** Counts of the character a packed movement RPC is being serialized for, in the direction of the archive **/
+	FTraversalNetBitCounts& GetNetBitCounts(UCharacterMovementComponent& CharacterMovement, const FArchive& Ar)
+	{
+		return static_cast<UTraversalMovementComponent&>(CharacterMovement).GetNetBitCounts(Ar.IsSaving());
+	}
+
+	/** Traversal state byte and anchor shared by moves and corrections **/
+	void SerializeTraversalState(FArchive& Ar, UPackageMap* PackageMap, uint8& PackedTraversalState, FVector_NetQuantize10& AnchorLocation, FRotator& AnchorRotation)
+	{
+		Ar << PackedTraversalState;
+		if (PackedTraversalState & ETraversalPackedState::HasAnchor)
+		{
+			bool bAnchorSuccess = true;
+			AnchorLocation.NetSerialize(Ar, PackageMap, bAnchorSuccess);
+			AnchorRotation.SerializeCompressedShort(Ar);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FTraversalNetworkMoveData
+
+void FTraversalNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	FCharacterNetworkMoveData::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	const FSavedMove_Traversal& TraversalMove = static_cast<const FSavedMove_Traversal&>(ClientMove);
+	PackedTraversalState = TraversalMove.PackedTraversalState;
+	AnchorLocation = TraversalMove.AnchorLocation;
+	AnchorRotation = TraversalMove.AnchorRotation;
+}
+
+bool FTraversalNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	const bool bSuccess = FCharacterNetworkMoveData::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// Moves in the default state cost nothing on top of the compressed flags
+	const int64 StartBits = GetBitPosition(Ar);
+	if (CompressedMoveFlags & FSavedMove_Traversal::FLAG_TraversalState)
+	{
+		SerializeTraversalState(Ar, PackageMap, PackedTraversalState, AnchorLocation, AnchorRotation);
+	}
+	else
+	{
+		PackedTraversalState = ETraversalPackedState::None;
+	}
+	GetNetBitCounts(CharacterMovement, Ar).TraversalMoveBits += GetBitPosition(Ar) - StartBits;
+
+	return bSuccess && !Ar.IsError();
+}
+
+FTraversalNetworkMoveDataContainer::FTraversalNetworkMoveDataContainer()
+{
+	NewMoveData = &TraversalMoveData[0];
+	PendingMoveData = &TraversalMoveData[1];
+	OldMoveData = &TraversalMoveData[2];
+}
+
+bool FTraversalNetworkMoveDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	const int64 StartBits = GetBitPosition(Ar);
+	const bool bSuccess = FCharacterNetworkMoveDataContainer::Serialize(CharacterMovement, Ar, PackageMap);
+	GetNetBitCounts(CharacterMovement, Ar).MoveBits += GetBitPosition(Ar) - StartBits;
+
+	return bSuccess;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FTraversalMoveResponseDataContainer
+
+void FTraversalMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+	FCharacterMoveResponseDataContainer::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	const UTraversalMovementComponent& TraversalMovement = static_cast<const UTraversalMovementComponent&>(CharacterMovement);
+	const AThirdPersonDemoCharacter* TraversalCharacter = Cast<AThirdPersonDemoCharacter>(TraversalMovement.GetCharacterOwner());
+	PackedTraversalState = TraversalCharacter ? TraversalCharacter->GetPackedTraversalState() : ETraversalPackedState::None;
+	if (TraversalMovement.HasTraversalAnchor())
+	{
+		PackedTraversalState |= ETraversalPackedState::HasAnchor;
+		AnchorLocation = TraversalMovement.GetAnchorLocation();
+		AnchorRotation = TraversalMovement.GetAnchorRotation();
+	}
+}
+
+bool FTraversalMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	const int64 StartBits = GetBitPosition(Ar);
+	const bool bSuccess = FCharacterMoveResponseDataContainer::Serialize(CharacterMovement, Ar, PackageMap);
+
+	// Acknowledged moves don't need the state, the client already predicted it
+	if (IsCorrection())
+	{
+		const int64 TraversalStartBits = GetBitPosition(Ar);
+		SerializeTraversalState(Ar, PackageMap, PackedTraversalState, AnchorLocation, AnchorRotation);
+		GetNetBitCounts(CharacterMovement, Ar).TraversalCorrectionBits += GetBitPosition(Ar) - TraversalStartBits;
+	}
+	GetNetBitCounts(CharacterMovement, Ar).ResponseBits += GetBitPosition(Ar) - StartBits;
+
+	return bSuccess && !Ar.IsError();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FSavedMove_Traversal
+
+void FSavedMove_Traversal::Clear()
+{
+	Super::Clear();
+
+	bWantsToAim = false;
+	PackedTraversalState = ETraversalPackedState::None;
+	bSendAnchor = false;
+	AnchorLocation = FVector::ZeroVector;
+	AnchorRotation = FRotator::ZeroRotator;
+
+	bStartInterpolating = false;
+	bStartWalkWhenInterpolated = false;
+	StartInterpElapsed = 0.f;
+	StartInterpStartLocation = FVector::ZeroVector;
+	StartInterpStartRotation = FQuat::Identity;
+	StartInterpTargetLocation = FVector::ZeroVector;
+	StartInterpTargetRotation = FRotator::ZeroRotator;
+}
+
+uint8 FSavedMove_Traversal::GetCompressedFlags() const
+{
+	uint8 Flags = Super::GetCompressedFlags();
+	if (bWantsToAim) Flags |= FLAG_Aiming;
+	if (PackedTraversalState != ETraversalPackedState::None) Flags |= FLAG_TraversalState;
+	return Flags;
+}
+
+bool FSavedMove_Traversal::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_Traversal* NewTraversalMove = static_cast<const FSavedMove_Traversal*>(NewMove.Get());
+
+	// A move that changes the anchor has to reach the server as is
+	if (bSendAnchor || NewTraversalMove->bSendAnchor) return false;
+	if (bWantsToAim != NewTraversalMove->bWantsToAim || PackedTraversalState != NewTraversalMove->PackedTraversalState) return false;
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Traversal::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	// The traversal batch runs before the movement component, so this is the state the move is simulated in
+	const AThirdPersonDemoCharacter* TraversalCharacter = Cast<AThirdPersonDemoCharacter>(C);
+	UTraversalMovementComponent* TraversalMovement = Cast<UTraversalMovementComponent>(C->GetCharacterMovement());
+	if (TraversalCharacter == nullptr || TraversalMovement == nullptr) return;
+
+	bWantsToAim = TraversalCharacter->IsAiming();
+	PackedTraversalState = TraversalCharacter->GetPackedTraversalState();
+	bSendAnchor = TraversalMovement->ConsumeAnchorChanged();
+	if (bSendAnchor)
+	{
+		PackedTraversalState |= ETraversalPackedState::HasAnchor;
+		AnchorLocation = TraversalMovement->GetAnchorLocation();
+		AnchorRotation = TraversalMovement->GetAnchorRotation();
+	}
+}
+
+void FSavedMove_Traversal::SetInitialPosition(ACharacter* C)
+{
+	Super::SetInitialPosition(C);
+
+	const UTraversalMovementComponent* TraversalMovement = Cast<UTraversalMovementComponent>(C->GetCharacterMovement());
+	if (TraversalMovement == nullptr) return;
+
+	bStartInterpolating = TraversalMovement->bInterpolating;
+	bStartWalkWhenInterpolated = TraversalMovement->bWalkWhenInterpolated;
+	StartInterpElapsed = TraversalMovement->InterpElapsed;
+	StartInterpStartLocation = TraversalMovement->InterpStartLocation;
+	StartInterpStartRotation = TraversalMovement->InterpStartRotation;
+	StartInterpTargetLocation = TraversalMovement->InterpTargetLocation;
+	StartInterpTargetRotation = TraversalMovement->InterpTargetRotation;
+}
+
+void FSavedMove_Traversal::CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation)
+{
+	Super::CombineWith(OldMove, InCharacter, PC, OldStartLocation);
+
+	// The combined move is simulated again from where the old one started, SetInitialPosition then saves it
+	static_cast<const FSavedMove_Traversal*>(OldMove)->RestoreInterpolation(InCharacter);
+}
+
+void FSavedMove_Traversal::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	RestoreInterpolation(C);
+}
+
+void FSavedMove_Traversal::RestoreInterpolation(ACharacter* C) const
+{
+	UTraversalMovementComponent* TraversalMovement = Cast<UTraversalMovementComponent>(C->GetCharacterMovement());
+	if (TraversalMovement == nullptr) return;
+
+	TraversalMovement->bInterpolating = bStartInterpolating;
+	TraversalMovement->bWalkWhenInterpolated = bStartWalkWhenInterpolated;
+	TraversalMovement->InterpElapsed = StartInterpElapsed;
+	TraversalMovement->InterpStartLocation = StartInterpStartLocation;
+	TraversalMovement->InterpStartRotation = StartInterpStartRotation;
+	TraversalMovement->InterpTargetLocation = StartInterpTargetLocation;
+	TraversalMovement->InterpTargetRotation = StartInterpTargetRotation;
+}
+
+bool FSavedMove_Traversal::IsImportantMove(const FSavedMovePtr& LastAckedMove) const
+{
+	// State changes and anchors are resent until acknowledged, the server can't follow the client without them
+	const FSavedMove_Traversal* LastAckedTraversalMove = static_cast<const FSavedMove_Traversal*>(LastAckedMove.Get());
+	const uint8 StateMask = static_cast<uint8>(~ETraversalPackedState::HasAnchor);
+	if (bSendAnchor || (PackedTraversalState & StateMask) != (LastAckedTraversalMove->PackedTraversalState & StateMask)) return true;
+
+	return Super::IsImportantMove(LastAckedMove);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FNetworkPredictionData_Client_Traversal
+
+FNetworkPredictionData_Client_Traversal::FNetworkPredictionData_Client_Traversal(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Traversal::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Traversal());
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UTraversalMovementComponent
+
+UTraversalMovementComponent::UTraversalMovementComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetNetworkMoveDataContainer(TraversalMoveDataContainer);
+	SetMoveResponseDataContainer(TraversalMoveResponseDataContainer);
+}
+
+void UTraversalMovementComponent::EnterTraversalMode(const ETraversalMovementMode Mode, const FVector& TargetLocation, const FRotator& TargetRotation)
+{
+	StopMovementImmediately();
+	SetMovementMode(MOVE_Custom, static_cast<uint8>(Mode));
+	InterpolateTo(TargetLocation, TargetRotation);
+}
+
+void UTraversalMovementComponent::InterpolateTo(const FVector& TargetLocation, const FRotator& TargetRotation)
+{
+	if (UpdatedComponent == nullptr) return;
+
+	bInterpolating = true;
+	bWalkWhenInterpolated = false;
+	InterpElapsed = 0.f;
+	InterpStartLocation = UpdatedComponent->GetComponentLocation();
+	InterpStartRotation = UpdatedComponent->GetComponentQuat();
+
+	// Quantized the way it is sent, so client and server end up in the same place
+	InterpTargetLocation = QuantizeAnchorLocation(TargetLocation);
+	InterpTargetRotation = QuantizeAnchorRotation(TargetRotation);
+	bAnchorChanged = true;
+}
+
+void UTraversalMovementComponent::StartWallRun(const float InWallRunGravityScale)
+{
+	WallRunGravityScale = InWallRunGravityScale;
+	bInterpolating = false;
+	SetMovementMode(MOVE_Custom, static_cast<uint8>(ETraversalMovementMode::WallRun));
+}
+
+void UTraversalMovementComponent::FinishClimbUp(const FVector& TargetLocation, const FRotator& TargetRotation)
+{
+	if (!IsInTraversalMode(ETraversalMovementMode::ClimbUp))
+	{
+		SetMovementMode(MOVE_Custom, static_cast<uint8>(ETraversalMovementMode::ClimbUp));
+	}
+	InterpolateTo(TargetLocation, TargetRotation);
+	bWalkWhenInterpolated = true;
+}
+
+bool UTraversalMovementComponent::IsInTraversalMode(const ETraversalMovementMode Mode) const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == static_cast<uint8>(Mode);
+}
+
+bool UTraversalMovementComponent::HasTraversalAnchor() const
+{
+	return IsInTraversalMode(ETraversalMovementMode::Hang) || IsInTraversalMode(ETraversalMovementMode::Cover);
+}
+
+bool UTraversalMovementComponent::ConsumeAnchorChanged()
+{
+	const bool bChanged = bAnchorChanged && HasTraversalAnchor();
+	bAnchorChanged = false;
+	return bChanged;
+}
+
+float UTraversalMovementComponent::GetGravityZ() const
+{
+	const float GravityZ = Super::GetGravityZ();
+	return IsInTraversalMode(ETraversalMovementMode::WallRun) ? GravityZ * WallRunGravityScale : GravityZ;
+}
+
+float UTraversalMovementComponent::GetMaxSpeed() const
+{
+	// Wall running uses the falling physics, so it gets the same speed limit as falling
+	return IsInTraversalMode(ETraversalMovementMode::WallRun) ? MaxWalkSpeed : Super::GetMaxSpeed();
+}
+
+bool UTraversalMovementComponent::IsFalling() const
+{
+	// Wall running is falling along a wall, so jumping, air control and landing all behave as they do in the air
+	return Super::IsFalling() || IsInTraversalMode(ETraversalMovementMode::WallRun);
+}
+
+bool UTraversalMovementComponent::DoJump(bool bReplayingMoves)
+{
+	// Jump off the wall at an angle. Done here rather than in the character so the server and replayed moves jump the same way
+	if (IsInTraversalMode(ETraversalMovementMode::WallRun))
+	{
+		if (const AThirdPersonDemoCharacter* TraversalCharacter = Cast<AThirdPersonDemoCharacter>(CharacterOwner))
+		{
+			Velocity = TraversalCharacter->GetWallRunJumpOffVelocity();
+		}
+	}
+
+	return Super::DoJump(bReplayingMoves);
+}
+
+FNetworkPredictionData_Client* UTraversalMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UTraversalMovementComponent* MutableThis = const_cast<UTraversalMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Traversal(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UTraversalMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	// Only the server follows the state sent with a move. Moves replayed on the client start from the corrected state instead
+	if (CharacterOwner == nullptr || CharacterOwner->GetLocalRole() != ROLE_Authority) return;
+
+	const FTraversalNetworkMoveData* MoveData = static_cast<const FTraversalNetworkMoveData*>(GetCurrentNetworkMoveData());
+	AThirdPersonDemoCharacter* TraversalCharacter = Cast<AThirdPersonDemoCharacter>(CharacterOwner);
+	if (MoveData == nullptr || TraversalCharacter == nullptr) return;
+
+	// Aim first, popping out of cover moves the anchor the state may carry
+	TraversalCharacter->ApplyPredictedAim((Flags & FSavedMove_Traversal::FLAG_Aiming) != 0);
+	if (!TraversalCharacter->ApplyPredictedTraversalState(MoveData->PackedTraversalState, MoveData->AnchorLocation, MoveData->AnchorRotation))
+	{
+		// Our state stays. Correct the client even if its position still matches ours, e.g. on the move it entered
+		if (FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character())
+		{
+			ServerData->bForceClientUpdate = true;
+		}
+		UE_LOG(LogTemp, Verbose, TEXT("%s: Rejected predicted traversal state %d"), *TraversalCharacter->GetName(), MoveData->PackedTraversalState);
+	}
+}
+
+void UTraversalMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	Super::ClientHandleMoveResponse(MoveResponse);
+
+	if (!MoveResponse.IsCorrection()) return;
+
+	// The position and movement mode are corrected by now, take the traversal state that goes with them
+	const FTraversalMoveResponseDataContainer& TraversalResponse = static_cast<const FTraversalMoveResponseDataContainer&>(MoveResponse);
+	if (AThirdPersonDemoCharacter* TraversalCharacter = Cast<AThirdPersonDemoCharacter>(CharacterOwner))
+	{
+		TraversalCharacter->ApplyCorrectedTraversalState(TraversalResponse.PackedTraversalState, TraversalResponse.AnchorLocation, TraversalResponse.AnchorRotation);
+	}
+}
+
+void UTraversalMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME) return;
+
+	switch (static_cast<ETraversalMovementMode>(CustomMovementMode))
+	{
+	case ETraversalMovementMode::WallRun:
+		PhysFalling(DeltaTime, Iterations);
+		break;
+
+	case ETraversalMovementMode::Hang:
+	case ETraversalMovementMode::Cover:
+		PhysInterpolate(DeltaTime);
+		break;
+
+	case ETraversalMovementMode::ClimbUp:
+		if (bInterpolating)
+		{
+			if (PhysInterpolate(DeltaTime) && bWalkWhenInterpolated)
+			{
+				bWalkWhenInterpolated = false;
+				SetMovementMode(MOVE_Walking);
+			}
+		}
+		else if (HasAnimRootMotion())
+		{
+			// The climb montage drives the capsule while it plays
+			FHitResult Hit;
+			SafeMoveUpdatedComponent(Velocity * DeltaTime, UpdatedComponent->GetComponentQuat(), true, Hit);
+		}
+		break;
+
+	default:
+		Super::PhysCustom(DeltaTime, Iterations);
+		break;
+	}
+}
+
+bool UTraversalMovementComponent::PhysInterpolate(const float DeltaTime)
+{
+	// The capsule is placed, not simulated, in interpolated modes
+	Velocity = FVector::ZeroVector;
+	if (!bInterpolating) return true;
+
+	InterpElapsed += DeltaTime;
+	const float Alpha = TraversalInterpTime > 0.f ? FMath::Min(InterpElapsed / TraversalInterpTime, 1.f) : 1.f;
+	const float EasedAlpha = FMath::InterpEaseInOut(0.f, 1.f, Alpha, 2.f);
+
+	const FVector NewLocation = FMath::Lerp(InterpStartLocation, InterpTargetLocation, EasedAlpha);
+	const FQuat NewRotation = FQuat::Slerp(InterpStartRotation, InterpTargetRotation.Quaternion(), EasedAlpha);
+
+	// Targets come from traces against the geometry the capsule is moving next to, so don't sweep
+	MoveUpdatedComponent(NewLocation - UpdatedComponent->GetComponentLocation(), NewRotation, false);
+
+	bInterpolating = Alpha < 1.f;
+	return !bInterpolating;
+}
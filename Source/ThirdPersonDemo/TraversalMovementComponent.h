@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "TraversalMovementComponent.generated.h"
+
+/** Custom movement modes of UTraversalMovementComponent, stored in CustomMovementMode **/
+UENUM(BlueprintType)
+enum class ETraversalMovementMode : uint8
+{
+	None,
+
+	/** Hold on to a ledge **/
+	Hang,
+
+	/** Fall along a wall with reduced gravity **/
+	WallRun,
+
+	/** Stand against cover, or peek out of it while aiming **/
+	Cover,
+
+	/** Play the climb up animation, then move onto the ledge and walk **/
+	ClimbUp
+};
+
+/** Traversal state of a saved move, sent with packed move RPCs. The anchor is only sent on moves that changed it **/
+struct FTraversalNetworkMoveData : public FCharacterNetworkMoveData
+{
+	/** ETraversalPackedState bits. Only sent when the move has FLAG_TraversalState set **/
+	uint8 PackedTraversalState = 0;
+
+	/** Hang or cover target, quantized like the capsule target it drives **/
+	FVector_NetQuantize10 AnchorLocation;
+	FRotator AnchorRotation = FRotator::ZeroRotator;
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+struct FTraversalNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	FTraversalNetworkMoveDataContainer();
+
+	FTraversalNetworkMoveData TraversalMoveData[3];
+
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+};
+
+/** Server corrections also carry the traversal state and anchor, so the client replays from the server's state **/
+struct FTraversalMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+	uint8 PackedTraversalState = 0;
+	FVector_NetQuantize10 AnchorLocation;
+	FRotator AnchorRotation = FRotator::ZeroRotator;
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+};
+
+/** Bits of packed movement RPCs serialized for one character, in one direction **/
+struct FTraversalNetBitCounts
+{
+	/** Whole move and move response payloads, stock fields included **/
+	uint64 MoveBits = 0;
+	uint64 ResponseBits = 0;
+
+	/** Part of the payloads traversal added **/
+	uint64 TraversalMoveBits = 0;
+	uint64 TraversalCorrectionBits = 0;
+};
+
+/** Saved move with the aim input and the traversal state the move was predicted in **/
+class FSavedMove_Traversal : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	/** Compressed flag bits used by traversal **/
+	enum ECompressedFlags
+	{
+		/** Aim input held **/
+		FLAG_Aiming = FLAG_Custom_0,
+
+		/** PackedTraversalState is not zero and is sent with the move **/
+		FLAG_TraversalState = FLAG_Custom_1
+	};
+
+	bool bWantsToAim = false;
+	uint8 PackedTraversalState = 0;
+
+	/** Set when the anchor changed since the last saved move, AnchorLocation and AnchorRotation are sent then **/
+	bool bSendAnchor = false;
+	FVector AnchorLocation = FVector::ZeroVector;
+	FRotator AnchorRotation = FRotator::ZeroRotator;
+
+	/** Capsule interpolation of the movement component at the start of the move, restored before the move is replayed **/
+	bool bStartInterpolating = false;
+	bool bStartWalkWhenInterpolated = false;
+	float StartInterpElapsed = 0.f;
+	FVector StartInterpStartLocation = FVector::ZeroVector;
+	FQuat StartInterpStartRotation = FQuat::Identity;
+	FVector StartInterpTargetLocation = FVector::ZeroVector;
+	FRotator StartInterpTargetRotation = FRotator::ZeroRotator;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void SetInitialPosition(ACharacter* C) override;
+	virtual void CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+	virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override;
+
+private:
+	/** Put the movement component back to the interpolation this move started with **/
+	void RestoreInterpolation(ACharacter* C) const;
+};
+
+class FNetworkPredictionData_Client_Traversal : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Traversal(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
+/**
+ * Character movement with real movement modes for traversal. Hang, Cover and ClimbUp move the capsule to a target
+ * transform inside PhysCustom, WallRun runs the falling physics with its own gravity scale.
+ * The traversal state is predicted by the owning client and sent with its saved moves, the server follows it and corrects it.
+ */
+UCLASS()
+class UTraversalMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+	/** Saved moves save and restore the interpolation for replays **/
+	friend class FSavedMove_Traversal;
+
+public:
+	UTraversalMovementComponent(const FObjectInitializer& ObjectInitializer);
+
+	/** Time taken to move the capsule to the target of a traversal mode **/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Traversal", meta = (ClampMin = "0"))
+	float TraversalInterpTime = 0.2f;
+
+	/** Switch to a traversal mode and move the capsule to the target transform **/
+	void EnterTraversalMode(const ETraversalMovementMode Mode, const FVector& TargetLocation, const FRotator& TargetRotation);
+
+	/** Move the capsule to a new target transform without changing mode **/
+	void InterpolateTo(const FVector& TargetLocation, const FRotator& TargetRotation);
+
+	/** Start wall running from the current velocity **/
+	void StartWallRun(const float InWallRunGravityScale);
+
+	/** Move from the climb up pose onto the ledge, then switch to walking **/
+	void FinishClimbUp(const FVector& TargetLocation, const FRotator& TargetRotation);
+
+	bool IsInTraversalMode(const ETraversalMovementMode Mode) const;
+
+	/** Returns true if the current mode moves the capsule to a target transform, which is then the traversal anchor **/
+	bool HasTraversalAnchor() const;
+
+	/** Target transform of the current interpolated mode **/
+	FVector GetAnchorLocation() const { return InterpTargetLocation; }
+	FRotator GetAnchorRotation() const { return InterpTargetRotation; }
+
+	/** Returns true once after every anchor change, for the next saved move to send it **/
+	bool ConsumeAnchorChanged();
+
+	/** Packed movement RPC bits this character sent or received since it spawned, counted on the copy that serialized them **/
+	FTraversalNetBitCounts& GetNetBitCounts(const bool bSent) { return bSent ? NetBitsSent : NetBitsReceived; }
+	const FTraversalNetBitCounts& GetNetBitCounts(const bool bSent) const { return bSent ? NetBitsSent : NetBitsReceived; }
+
+	// UCharacterMovementComponent interface
+	virtual float GetGravityZ() const override;
+	virtual float GetMaxSpeed() const override;
+	virtual bool IsFalling() const override;
+	virtual bool DoJump(bool bReplayingMoves) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+	// End of UCharacterMovementComponent interface
+
+protected:
+	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
+
+	/** Move along the current interpolation. Returns true once the target is reached **/
+	bool PhysInterpolate(const float DeltaTime);
+
+	/** Gravity scale applied on top of GravityScale while wall running **/
+	float WallRunGravityScale = 1.f;
+
+	bool bInterpolating = false;
+	float InterpElapsed = 0.f;
+	FVector InterpStartLocation = FVector::ZeroVector;
+	FQuat InterpStartRotation = FQuat::Identity;
+	FVector InterpTargetLocation = FVector::ZeroVector;
+	FRotator InterpTargetRotation = FRotator::ZeroRotator;
+
+	/** Set by FinishClimbUp to walk once the interpolation is done **/
+	bool bWalkWhenInterpolated = false;
+
+	/** Set by InterpolateTo, cleared by ConsumeAnchorChanged **/
+	bool bAnchorChanged = false;
+
+	FTraversalNetworkMoveDataContainer TraversalMoveDataContainer;
+	FTraversalMoveResponseDataContainer TraversalMoveResponseDataContainer;
+
+	FTraversalNetBitCounts NetBitsSent;
+	FTraversalNetBitCounts NetBitsReceived;
+};
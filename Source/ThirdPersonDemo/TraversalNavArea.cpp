@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalNavArea.h"
+
+ETraversalNavLinkType UTraversalNavArea::GetLinkType(const UClass* AreaClass)
+{
+	const UTraversalNavArea* AreaCDO = AreaClass != nullptr ? Cast<UTraversalNavArea>(AreaClass->GetDefaultObject()) : nullptr;
+	return AreaCDO != nullptr ? AreaCDO->LinkType : ETraversalNavLinkType::None;
+}
+
+UTraversalNavArea_Climb::UTraversalNavArea_Climb(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	LinkType = ETraversalNavLinkType::Climb;
+	DefaultCost = 3.f;
+	DrawColor = FColor::Orange;
+}
+
+UTraversalNavArea_WallRun::UTraversalNavArea_WallRun(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	LinkType = ETraversalNavLinkType::WallRun;
+	DefaultCost = 1.5f;
+	DrawColor = FColor::Cyan;
+}
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavAreas/NavArea.h"
+#include "TraversalNavArea.generated.h"
+
+/** Traversal move a nav link stands for, so path following knows how to drive the character through it **/
+UENUM()
+enum class ETraversalNavLinkType : uint8
+{
+	None,
+
+	/** Jump at the wall, hang from the lip and climb up **/
+	Climb,
+
+	/** Jump along the wall and run on it to the far end of the span **/
+	WallRun
+};
+
+/** Area of the nav links generated for traversal routes, see TraversalNavLinkGenerator **/
+UCLASS(Abstract)
+class UTraversalNavArea : public UNavArea
+{
+	GENERATED_BODY()
+
+public:
+	/** Link type of an area class, None if it isn't a traversal area **/
+	static ETraversalNavLinkType GetLinkType(const UClass* AreaClass);
+
+protected:
+	ETraversalNavLinkType LinkType = ETraversalNavLinkType::None;
+};
+
+/** Ledge climb links. Costs more than walking so agents only climb when it actually shortens the path **/
+UCLASS()
+class UTraversalNavArea_Climb : public UTraversalNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UTraversalNavArea_Climb(const FObjectInitializer& ObjectInitializer);
+};
+
+/** Wall run links over gaps **/
+UCLASS()
+class UTraversalNavArea_WallRun : public UTraversalNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UTraversalNavArea_WallRun(const FObjectInitializer& ObjectInitializer);
+};
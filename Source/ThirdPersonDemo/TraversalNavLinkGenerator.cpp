@@ -0,0 +1,177 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalNavLinkGenerator.h"
+#include "Engine/World.h"
+#include "TraversalEdgeIndex.h"
+#include "TraversalNavArea.h"
+
+namespace
+{
+	template<typename ValueType>
+	uint32 HashValue(const ValueType& Value, const uint32 Crc)
+	{
+		return FCrc::MemCrc32(&Value, sizeof(ValueType), Crc);
+	}
+
+	FNavigationLink MakeLink(const FVector& Left, const FVector& Right, const ENavLinkDirection::Type Direction, const TSubclassOf<UNavArea> AreaClass)
+	{
+		FNavigationLink Link(Left, Right);
+		Link.Direction = Direction;
+		Link.SetAreaClass(AreaClass);
+		return Link;
+	}
+
+	/** Links from the floor in front of a ledge to the top of it, spread along the lip **/
+	void MakeClimbLinks(const FTraversalEdge& Edge, const FTraversalRouteRules& Rules, const FTraversalNavLinkSettings& Settings, TArray<FNavigationLink>& OutLinks)
+	{
+		// Ledges are baked with the depth of the wall below them, taken to be the height above the floor
+		if (Edge.Height < Rules.MinLipHeight || Edge.Height > Rules.MaxLipHeight) return;
+
+		// Keep a capsule radius from the ends so the character hangs fully on the ledge
+		const FVector AlongVector = Edge.End - Edge.Start;
+		const float Length = AlongVector.Size();
+		const float UsableLength = Length - Rules.CapsuleRadius * 2.f;
+		if (UsableLength < 0.f) return;
+
+		const FVector AlongDirection = AlongVector / Length;
+		const int32 NumLinks = FMath::FloorToInt(UsableLength / FMath::Max(Settings.ClimbLinkSpacing, 1.f)) + 1;
+		const float FirstOffset = Rules.CapsuleRadius + (UsableLength - (NumLinks - 1) * Settings.ClimbLinkSpacing) * 0.5f;
+		for (int32 LinkIndex = 0; LinkIndex < NumLinks; ++LinkIndex)
+		{
+			const FVector Lip = Edge.Start + AlongDirection * (FirstOffset + LinkIndex * Settings.ClimbLinkSpacing);
+			const FVector Start = Lip + Edge.Normal * Settings.ClimbStartDistance + FVector::DownVector * Edge.Height;
+			const FVector End = Lip - Edge.Normal * Settings.ClimbEndDistance;
+			OutLinks.Add(MakeLink(Start, End, ENavLinkDirection::LeftToRight, UTraversalNavArea_Climb::StaticClass()));
+		}
+	}
+
+	/** Run along a tall face a wall run link can follow, if there is a gap below it **/
+	struct FWallRunSpan
+	{
+		FVector Start;
+		FVector End;
+		ENavLinkDirection::Type Direction;
+	};
+
+	typedef TArray<FWallRunSpan, TInlineAllocator<2>> FWallRunSpans;
+
+	/** One span both ways along a tall face, or one each way from its ends when the face is longer than a single run **/
+	void GetWallRunSpans(const FTraversalEdge& Edge, const FTraversalRouteRules& Rules, const FTraversalNavLinkSettings& Settings, FWallRunSpans& OutSpans)
+	{
+		// The character has to fit along the whole height of the face it runs on
+		if (!Rules.bCanWallRun || Edge.Type != ETraversalEdgeType::TallCover || Edge.Height < Rules.CapsuleHalfHeight * 2.f) return;
+
+		const FVector Offset = Edge.Normal * Rules.WallRunOffset;
+		const FVector AlongVector = Edge.End - Edge.Start;
+		const float Length = AlongVector.Size() - Rules.CapsuleRadius * 2.f;
+		const float RunLength = FMath::Min(Length, Rules.MaxWallRunLength);
+		if (RunLength < Settings.MinWallRunLength) return;
+
+		const FVector AlongDirection = AlongVector.GetSafeNormal();
+		const FVector FirstStart = Edge.Start + AlongDirection * Rules.CapsuleRadius + Offset;
+		const FVector LastEnd = Edge.End - AlongDirection * Rules.CapsuleRadius + Offset;
+
+		if (Length <= Rules.MaxWallRunLength)
+		{
+			OutSpans.Add({ FirstStart, LastEnd, ENavLinkDirection::BothWays });
+			return;
+		}
+
+		OutSpans.Add({ FirstStart, FirstStart + AlongDirection * RunLength, ENavLinkDirection::LeftToRight });
+		OutSpans.Add({ LastEnd, LastEnd - AlongDirection * RunLength, ENavLinkDirection::LeftToRight });
+	}
+
+	/** Whether the floor below the middle of a span is missing or deep enough. Only gaps are linked, walking along a wall is the navmesh's job **/
+	bool HasGap(const UWorld* World, const FWallRunSpan& Span, const FTraversalRouteRules& Rules, const FTraversalNavLinkSettings& Settings)
+	{
+		// Same channel the character probes with
+		const ECollisionChannel TraceChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery_MAX);
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalNavLinkGap), false);
+		const FVector Middle = (Span.Start + Span.End) * 0.5f;
+		return !World->LineTraceTestByChannel(Middle + FVector::UpVector * Rules.CapsuleHalfHeight, Middle + FVector::DownVector * Settings.MinWallRunGapDepth, TraceChannel, QueryParams);
+	}
+
+	/** A link along each span of a tall face that crosses a gap **/
+	void MakeWallRunLinks(const UWorld* World, const FTraversalEdge& Edge, const FTraversalRouteRules& Rules, const FTraversalNavLinkSettings& Settings, TArray<FNavigationLink>& OutLinks)
+	{
+		FWallRunSpans Spans;
+		GetWallRunSpans(Edge, Rules, Settings, Spans);
+		for (const FWallRunSpan& Span : Spans)
+		{
+			if (HasGap(World, Span, Rules, Settings)) OutLinks.Add(MakeLink(Span.Start, Span.End, Span.Direction, UTraversalNavArea_WallRun::StaticClass()));
+		}
+	}
+}
+
+void TraversalNavLinkGenerator::BucketEdges(const TArray<FTraversalEdge>& Edges, const float TileSize, TMap<FIntPoint, TArray<int32>>& OutTileEdges)
+{
+	OutTileEdges.Reset();
+
+	const float SafeTileSize = FMath::Max(TileSize, 100.f);
+	for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); ++EdgeIndex)
+	{
+		const FVector Middle = (Edges[EdgeIndex].Start + Edges[EdgeIndex].End) * 0.5f;
+		const FIntPoint Tile(FMath::FloorToInt(Middle.X / SafeTileSize), FMath::FloorToInt(Middle.Y / SafeTileSize));
+		OutTileEdges.FindOrAdd(Tile).Add(EdgeIndex);
+	}
+}
+
+uint32 TraversalNavLinkGenerator::HashTile(const UWorld* World, const TArray<FTraversalEdge>& Edges, const TArray<int32>& TileEdges, const FTraversalRouteRules& Rules, const FTraversalNavLinkSettings& Settings)
+{
+	// Field by field, struct padding is not guaranteed to be zeroed
+	uint32 Crc = 0;
+	for (const int32 EdgeIndex : TileEdges)
+	{
+		const FTraversalEdge& Edge = Edges[EdgeIndex];
+		Crc = HashValue(Edge.Start, Crc);
+		Crc = HashValue(Edge.End, Crc);
+		Crc = HashValue(Edge.Normal, Crc);
+		Crc = HashValue(Edge.Height, Crc);
+		Crc = HashValue(Edge.Type, Crc);
+
+		// Wall run links also depend on the floor below the face, which is not part of the edge.
+		// A few line traces per face, cheaper than respawning the tile and rebuilding the navmesh around its links
+		if (World == nullptr) continue;
+
+		FWallRunSpans Spans;
+		GetWallRunSpans(Edge, Rules, Settings, Spans);
+		for (const FWallRunSpan& Span : Spans)
+		{
+			Crc = HashValue(HasGap(World, Span, Rules, Settings), Crc);
+		}
+	}
+
+	Crc = HashValue(Rules.CapsuleRadius, Crc);
+	Crc = HashValue(Rules.CapsuleHalfHeight, Crc);
+	Crc = HashValue(Rules.MinLipHeight, Crc);
+	Crc = HashValue(Rules.MaxLipHeight, Crc);
+	Crc = HashValue(Rules.bCanWallRun, Crc);
+	Crc = HashValue(Rules.WallRunOffset, Crc);
+	Crc = HashValue(Rules.MaxWallRunLength, Crc);
+
+	Crc = HashValue(Settings.ClimbLinkSpacing, Crc);
+	Crc = HashValue(Settings.ClimbStartDistance, Crc);
+	Crc = HashValue(Settings.ClimbEndDistance, Crc);
+	Crc = HashValue(Settings.MinWallRunLength, Crc);
+	Crc = HashValue(Settings.MinWallRunGapDepth, Crc);
+	return Crc;
+}
+
+void TraversalNavLinkGenerator::GenerateTileLinks(const UWorld* World, const TArray<FTraversalEdge>& Edges, const TArray<int32>& TileEdges, const FTraversalRouteRules& Rules,
+	const FTraversalNavLinkSettings& Settings, TArray<FNavigationLink>& OutLinks)
+{
+	OutLinks.Reset();
+
+	for (const int32 EdgeIndex : TileEdges)
+	{
+		const FTraversalEdge& Edge = Edges[EdgeIndex];
+		if (Edge.Type == ETraversalEdgeType::Ledge)
+		{
+			MakeClimbLinks(Edge, Rules, Settings, OutLinks);
+		}
+		else if (World != nullptr)
+		{
+			MakeWallRunLinks(World, Edge, Rules, Settings, OutLinks);
+		}
+	}
+}
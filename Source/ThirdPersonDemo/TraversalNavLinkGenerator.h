@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/Navigation/NavLinkDefinition.h"
+#include "TraversalNavLinkGenerator.generated.h"
+
+class AThirdPersonDemoCharacter;
+class UWorld;
+struct FTraversalEdge;
+
+/** Tunables for generating traversal nav links from a baked edge index **/
+USTRUCT()
+struct FTraversalNavLinkSettings
+{
+	GENERATED_BODY()
+
+	/** Character whose traversal tuning decides which ledges and walls get links. AThirdPersonDemoCharacter if unset **/
+	UPROPERTY(EditAnywhere, Category = "Nav Links")
+	TSubclassOf<AThirdPersonDemoCharacter> CharacterClass;
+
+	/** Size of a generation tile, in cm. Edges are assigned to the tile containing their midpoint **/
+	UPROPERTY(EditAnywhere, Category = "Nav Links")
+	float TileSize = 4000.f;
+
+	/** Distance between climb links along a ledge **/
+	UPROPERTY(EditAnywhere, Category = "Nav Links")
+	float ClimbLinkSpacing = 200.f;
+
+	/** How far in front of the wall climb links start, where the character jumps from **/
+	UPROPERTY(EditAnywhere, Category = "Nav Links")
+	float ClimbStartDistance = 60.f;
+
+	/** How far behind the lip climb links end **/
+	UPROPERTY(EditAnywhere, Category = "Nav Links")
+	float ClimbEndDistance = 50.f;
+
+	/** Wall run spans shorter than this are not worth a link **/
+	UPROPERTY(EditAnywhere, Category = "Nav Links")
+	float MinWallRunLength = 300.f;
+
+	/** Wall runs are only linked over gaps at least this deep, walls along walkable floor are left to the navmesh **/
+	UPROPERTY(EditAnywhere, Category = "Nav Links")
+	float MinWallRunGapDepth = 200.f;
+};
+
+/** The traversal tuning of a character, turned into the limits links are generated with **/
+struct FTraversalRouteRules
+{
+	float CapsuleRadius = 42.f;
+	float CapsuleHalfHeight = 96.f;
+
+	/** Lip heights above the floor the character can jump to and hang from **/
+	float MinLipHeight = 0.f;
+	float MaxLipHeight = 0.f;
+
+	/** Whether the character can run fast enough on the ground to start a wall run at all **/
+	bool bCanWallRun = false;
+
+	/** Distance from the wall the character runs at, and the longest run before it drops back to its start height **/
+	float WallRunOffset = 45.f;
+	float MaxWallRunLength = 0.f;
+};
+
+/**
+ * Turns baked ledges and tall faces into nav links following the hang, climb and wall run rules of a character,
+ * so AI can path over them. Work is split in tiles of FTraversalNavLinkSettings::TileSize, each hashed from its edges,
+ * the gaps below its wall runs and the rules, so only the tiles whose input changed have to be generated again.
+ */
+namespace TraversalNavLinkGenerator
+{
+	/** Edge indices by the tile containing their midpoint **/
+	void BucketEdges(const TArray<FTraversalEdge>& Edges, const float TileSize, TMap<FIntPoint, TArray<int32>>& OutTileEdges);
+
+	/** Hash of everything the links of a tile are generated from. Traces the world for the gaps below wall runs, like GenerateTileLinks **/
+	uint32 HashTile(const UWorld* World, const TArray<FTraversalEdge>& Edges, const TArray<int32>& TileEdges, const FTraversalRouteRules& Rules, const FTraversalNavLinkSettings& Settings);
+
+	/** Generate the links of one tile. Wall runs trace the world for the gap they cross **/
+	void GenerateTileLinks(const UWorld* World, const TArray<FTraversalEdge>& Edges, const TArray<int32>& TileEdges, const FTraversalRouteRules& Rules,
+		const FTraversalNavLinkSettings& Settings, TArray<FNavigationLink>& OutLinks);
+}
@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalNavLinkTile.h"
+#include "NavLinkComponent.h"
+#include "NavigationSystem.h"
+
+ATraversalNavLinkTile::ATraversalNavLinkTile()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	NavLinks = CreateDefaultSubobject<UNavLinkComponent>(TEXT("NavLinks"));
+	NavLinks->Links.Reset();
+	NavLinks->SetMobility(EComponentMobility::Static);
+	RootComponent = NavLinks;
+}
+
+void ATraversalNavLinkTile::SetLinks(const FIntPoint& InTileCoord, const uint32 InContentHash, const TArray<FNavigationLink>& InLinks)
+{
+	TileCoord = InTileCoord;
+	ContentHash = InContentHash;
+	NavLinks->Links = InLinks;
+
+	// Dirties the navmesh around the old and new links only
+	FNavigationSystem::UpdateComponentData(*NavLinks);
+	MarkPackageDirty();
+}
@@ -0,0 +1,41 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "AI/Navigation/NavLinkDefinition.h"
+#include "TraversalNavLinkTile.generated.h"
+
+class UNavLinkComponent;
+
+/**
+ * Generated traversal nav links of one tile of a level, see ATraversalEdgeIndexActor::GenerateNavLinks.
+ * Links are in world space, the actor stays at the origin. Only tiles whose input changed are regenerated,
+ * so only the navmesh around them is rebuilt.
+ */
+UCLASS(NotPlaceable)
+class ATraversalNavLinkTile : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATraversalNavLinkTile();
+
+	/** Replace the links of the tile and update the navigation octree **/
+	void SetLinks(const FIntPoint& InTileCoord, const uint32 InContentHash, const TArray<FNavigationLink>& InLinks);
+
+	const FIntPoint& GetTileCoord() const { return TileCoord; }
+	uint32 GetContentHash() const { return ContentHash; }
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = "Traversal Nav Links")
+	UNavLinkComponent* NavLinks;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal Nav Links")
+	FIntPoint TileCoord = FIntPoint::ZeroValue;
+
+	/** Hash of the edges and tuning the links were generated from **/
+	UPROPERTY()
+	uint32 ContentHash = 0;
+};
@@ -0,0 +1,207 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalNetReportSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+static FAutoConsoleCommandWithWorldAndArgs TraversalNetReportCommand(
+	TEXT("Traversal.Net.Report"),
+	TEXT("Measure traversal movement bandwidth on a server or client. Args: Seconds=10 Budget=<stock bytes/s> Slack=64 Quit"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UTraversalNetReportSubsystem* NetReportSubsystem = World ? World->GetSubsystem<UTraversalNetReportSubsystem>() : nullptr;
+		if (NetReportSubsystem == nullptr) return;
+
+		const FString CommandLine = FString::Join(Args, TEXT(" "));
+		FTraversalNetReportSettings Settings;
+		FParse::Value(*CommandLine, TEXT("Seconds="), Settings.Seconds);
+		FParse::Value(*CommandLine, TEXT("Budget="), Settings.BudgetBytesPerSecond);
+		FParse::Value(*CommandLine, TEXT("Slack="), Settings.SlackBytesPerSecond);
+		Settings.bQuitWhenDone = Args.Contains(TEXT("Quit"));
+
+		if (!NetReportSubsystem->StartReport(Settings))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Traversal net report already running, or the world has no net driver"));
+		}
+	}));
+
+void UTraversalNetReportSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	bRunning = false;
+
+	Super::Deinitialize();
+}
+
+bool UTraversalNetReportSubsystem::StartReport(const FTraversalNetReportSettings& InSettings)
+{
+	if (bRunning || GetWorld()->GetNetDriver() == nullptr) return false;
+
+	Settings = InSettings;
+	Settings.Seconds = FMath::Max(1.f, Settings.Seconds);
+
+	bRunning = true;
+	StartTime = FPlatformTime::Seconds();
+	ConnectionSamples.Reset();
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UTraversalNetReportSubsystem::OnWorldPostActorTick);
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal net report started for %.0f seconds"), Settings.Seconds);
+	return true;
+}
+
+void UTraversalNetReportSubsystem::StopReport()
+{
+	if (!bRunning) return;
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	bRunning = false;
+
+	const bool bPassed = WriteReport();
+	if (Settings.bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+	}
+}
+
+void UTraversalNetReportSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld()) return;
+
+	if (FPlatformTime::Seconds() - StartTime >= Settings.Seconds)
+	{
+		StopReport();
+		return;
+	}
+
+	const UNetDriver* NetDriver = World->GetNetDriver();
+	if (NetDriver == nullptr) return;
+
+	// Moves are received by a server and sent by a client, move responses the other way around
+	const bool bIsServer = NetDriver->IsServer();
+
+	// Connections update their rates once per stat period, averaging every frame weights each period by its length
+	const auto SampleConnection = [this, bIsServer](const UNetConnection* Connection)
+	{
+		if (Connection == nullptr) return;
+
+		FTraversalNetConnectionSamples& Samples = ConnectionSamples.FindOrAdd(Connection->LowLevelGetRemoteAddress(true));
+		if (!Samples.Movement.IsValid())
+		{
+			const APlayerController* PlayerController = Connection->PlayerController;
+			const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+			Samples.Name = Pawn ? Pawn->GetName() : Connection->LowLevelGetRemoteAddress(true);
+
+			// Counted from the first frame the character is seen, it may be spawned after the report started
+			const UTraversalMovementComponent* Movement = Pawn ? Cast<UTraversalMovementComponent>(Pawn->GetMovementComponent()) : nullptr;
+			if (Movement != nullptr)
+			{
+				Samples.Movement = Movement;
+				Samples.MoveBitsAtStart = Movement->GetNetBitCounts(!bIsServer);
+				Samples.ResponseBitsAtStart = Movement->GetNetBitCounts(bIsServer);
+				Samples.MovementStartTime = FPlatformTime::Seconds();
+			}
+		}
+		Samples.InBytesPerSecond += Connection->InBytesPerSecond;
+		Samples.OutBytesPerSecond += Connection->OutBytesPerSecond;
+		++Samples.NumSamples;
+	};
+
+	SampleConnection(NetDriver->ServerConnection);
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		SampleConnection(Connection);
+	}
+}
+
+bool UTraversalNetReportSubsystem::WriteReport()
+{
+	const double Elapsed = FMath::Max(FPlatformTime::Seconds() - StartTime, 0.001);
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const bool bIsServer = NetDriver == nullptr || NetDriver->IsServer();
+
+	TArray<TSharedPtr<FJsonValue>> ConnectionValues;
+	double TotalMoveBytesPerSecond = 0.0;
+	double TotalTraversalBytesPerSecond = 0.0;
+	double TotalResponseBytesPerSecond = 0.0;
+	double TotalCorrectionBytesPerSecond = 0.0;
+	int32 NumCharacters = 0;
+	const double Now = FPlatformTime::Seconds();
+	for (const TPair<FString, FTraversalNetConnectionSamples>& Pair : ConnectionSamples)
+	{
+		const FTraversalNetConnectionSamples& Samples = Pair.Value;
+		const double InBytesPerSecond = Samples.InBytesPerSecond / FMath::Max(1, Samples.NumSamples);
+		const double OutBytesPerSecond = Samples.OutBytesPerSecond / FMath::Max(1, Samples.NumSamples);
+
+		TSharedRef<FJsonObject> ConnectionObject = MakeShared<FJsonObject>();
+		ConnectionObject->SetStringField(TEXT("Name"), Samples.Name);
+		ConnectionObject->SetNumberField(TEXT("InBytesPerSecond"), InBytesPerSecond);
+		ConnectionObject->SetNumberField(TEXT("OutBytesPerSecond"), OutBytesPerSecond);
+
+		// Connections without a traversal character only show their totals
+		const UTraversalMovementComponent* Movement = Samples.Movement.Get();
+		if (Movement != nullptr)
+		{
+			const double MovementSeconds = FMath::Max(Now - Samples.MovementStartTime, 0.001);
+			const FTraversalNetBitCounts& MoveBits = Movement->GetNetBitCounts(!bIsServer);
+			const FTraversalNetBitCounts& ResponseBits = Movement->GetNetBitCounts(bIsServer);
+			const double MoveBytesPerSecond = (MoveBits.MoveBits - Samples.MoveBitsAtStart.MoveBits) / 8.0 / MovementSeconds;
+			const double TraversalBytesPerSecond = (MoveBits.TraversalMoveBits - Samples.MoveBitsAtStart.TraversalMoveBits) / 8.0 / MovementSeconds;
+			const double ResponseBytesPerSecond = (ResponseBits.ResponseBits - Samples.ResponseBitsAtStart.ResponseBits) / 8.0 / MovementSeconds;
+			const double CorrectionBytesPerSecond = (ResponseBits.TraversalCorrectionBits - Samples.ResponseBitsAtStart.TraversalCorrectionBits) / 8.0 / MovementSeconds;
+
+			TotalMoveBytesPerSecond += MoveBytesPerSecond;
+			TotalTraversalBytesPerSecond += TraversalBytesPerSecond;
+			TotalResponseBytesPerSecond += ResponseBytesPerSecond;
+			TotalCorrectionBytesPerSecond += CorrectionBytesPerSecond;
+			++NumCharacters;
+
+			ConnectionObject->SetNumberField(TEXT("MoveBytesPerSecond"), MoveBytesPerSecond);
+			ConnectionObject->SetNumberField(TEXT("TraversalMoveBytesPerSecond"), TraversalBytesPerSecond);
+			ConnectionObject->SetNumberField(TEXT("MoveResponseBytesPerSecond"), ResponseBytesPerSecond);
+			ConnectionObject->SetNumberField(TEXT("TraversalCorrectionBytesPerSecond"), CorrectionBytesPerSecond);
+		}
+		ConnectionValues.Add(MakeShared<FJsonValueObject>(ConnectionObject));
+	}
+
+	// One moving character per client connection on a server, the local one on a client
+	const int32 CharacterDivisor = FMath::Max(1, NumCharacters);
+	const double MoveBytesPerSecond = TotalMoveBytesPerSecond / CharacterDivisor;
+	const double TraversalBytesPerSecond = TotalTraversalBytesPerSecond / CharacterDivisor;
+	const double ResponseBytesPerSecond = TotalResponseBytesPerSecond / CharacterDivisor;
+	const double CorrectionBytesPerSecond = TotalCorrectionBytesPerSecond / CharacterDivisor;
+
+	const bool bPassed = Settings.BudgetBytesPerSecond <= 0.f || MoveBytesPerSecond <= Settings.BudgetBytesPerSecond + Settings.SlackBytesPerSecond;
+
+	TSharedRef<FJsonObject> ReportObject = MakeShared<FJsonObject>();
+	ReportObject->SetStringField(TEXT("Role"), bIsServer ? TEXT("Server") : TEXT("Client"));
+	ReportObject->SetNumberField(TEXT("Seconds"), Elapsed);
+	ReportObject->SetNumberField(TEXT("Characters"), NumCharacters);
+	ReportObject->SetNumberField(TEXT("MoveBytesPerSecondPerCharacter"), MoveBytesPerSecond);
+	ReportObject->SetNumberField(TEXT("TraversalMoveBytesPerSecondPerCharacter"), TraversalBytesPerSecond);
+	ReportObject->SetNumberField(TEXT("MoveResponseBytesPerSecondPerCharacter"), ResponseBytesPerSecond);
+	ReportObject->SetNumberField(TEXT("TraversalCorrectionBytesPerSecondPerCharacter"), CorrectionBytesPerSecond);
+	ReportObject->SetNumberField(TEXT("StockMoveBytesPerSecondPerCharacter"), MoveBytesPerSecond - TraversalBytesPerSecond);
+	ReportObject->SetNumberField(TEXT("Budget"), Settings.BudgetBytesPerSecond);
+	ReportObject->SetNumberField(TEXT("Slack"), Settings.SlackBytesPerSecond);
+	ReportObject->SetArrayField(TEXT("Connections"), ConnectionValues);
+	ReportObject->SetBoolField(TEXT("Passed"), bPassed);
+
+	FString Json;
+	FJsonSerializer::Serialize(ReportObject, TJsonWriterFactory<>::Create(&Json));
+	const FString JsonPath = FPaths::ProfilingDir() / TEXT("Traversal") / FString::Printf(TEXT("TraversalNetReport-%s.json"), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(Json, *JsonPath);
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal net report: %.1f move bytes/s per character, %.1f of them traversal, %.1f correction bytes/s. %s, written to %s"),
+		MoveBytesPerSecond, TraversalBytesPerSecond, CorrectionBytesPerSecond, bPassed ? TEXT("Within budget") : TEXT("Over budget"), *JsonPath);
+	return bPassed;
+}
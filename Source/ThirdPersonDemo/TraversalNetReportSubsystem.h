@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TraversalMovementComponent.h"
+#include "TraversalNetReportSubsystem.generated.h"
+
+/** Parameters of a bandwidth report, parsed from the Traversal.Net.Report command line **/
+struct FTraversalNetReportSettings
+{
+	/** Length of the sampling window **/
+	float Seconds = 10.f;
+
+	/** Packed move payload bytes per second of the stock character to compare against. No comparison if zero **/
+	float BudgetBytesPerSecond = 0.f;
+
+	/** Bytes per second per character traversal may add on top of the budget **/
+	float SlackBytesPerSecond = 64.f;
+
+	/** Exit when done, with a non zero exit code when over budget **/
+	bool bQuitWhenDone = false;
+};
+
+/** Bandwidth of one net connection averaged over the sampling window, and the movement RPCs of its character **/
+struct FTraversalNetConnectionSamples
+{
+	FString Name;
+	double InBytesPerSecond = 0.0;
+	double OutBytesPerSecond = 0.0;
+	int32 NumSamples = 0;
+
+	/** Movement of the character the connection moves, and its bit counts when it was first seen **/
+	TWeakObjectPtr<const UTraversalMovementComponent> Movement;
+	FTraversalNetBitCounts MoveBitsAtStart;
+	FTraversalNetBitCounts ResponseBitsAtStart;
+	double MovementStartTime = 0.0;
+};
+
+/**
+ * Measures the movement bandwidth of traversal characters. On a server each client connection carries the moves of
+ * one character, on a client the server connection carries the moves of the local one. The move payload is counted by
+ * the movement component of each character, so a PIE session running server and clients in one process reports each
+ * world on its own. Connection totals are reported next to it for context. Writes a JSON report.
+ *
+ * Run on the listen server or on a client with: Traversal.Net.Report Seconds=30 Budget=<stock bytes/s> Quit
+ */
+UCLASS()
+class UTraversalNetReportSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Start sampling. Returns false if a report is already in progress or the world is not networked **/
+	bool StartReport(const FTraversalNetReportSettings& InSettings);
+
+	/** Stop sampling and write the report **/
+	void StopReport();
+
+	bool IsRunning() const { return bRunning; }
+
+private:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Write the JSON report. Returns false when over budget **/
+	bool WriteReport();
+
+	FTraversalNetReportSettings Settings;
+	bool bRunning = false;
+
+	double StartTime = 0.0;
+
+	/** Samples per connection, keyed by remote address **/
+	TMap<FString, FTraversalNetConnectionSamples> ConnectionSamples;
+
+	FDelegateHandle PostActorTickHandle;
+};
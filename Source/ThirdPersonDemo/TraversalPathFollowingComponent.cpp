@@ -0,0 +1,161 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalPathFollowingComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "ThirdPersonDemoCharacter.h"
+#include "TraversalMath.h"
+
+void UTraversalPathFollowingComponent::SetMoveSegment(int32 SegmentStartIndex)
+{
+	FinishTraversalLink();
+	Super::SetMoveSegment(SegmentStartIndex);
+
+	if (!Path.IsValid() || !Path->GetPathPoints().IsValidIndex(SegmentStartIndex + 1) || GetTraversalCharacter() == nullptr) return;
+
+	// Off-mesh connections are flagged on the path point they start at, with the area of the link
+	const FNavPathPoint& SegmentStart = Path->GetPathPoints()[SegmentStartIndex];
+	const FNavMeshNodeFlags NodeFlags(SegmentStart.Flags);
+	const ANavigationData* NavData = Path->GetNavigationDataUsed();
+	if (!NodeFlags.IsNavLink() || NavData == nullptr) return;
+
+	const ETraversalNavLinkType SegmentLinkType = UTraversalNavArea::GetLinkType(NavData->GetAreaClass(NodeFlags.Area));
+	if (SegmentLinkType != ETraversalNavLinkType::None)
+	{
+		StartTraversalLink(SegmentLinkType, SegmentStart.Location, Path->GetPathPoints()[SegmentStartIndex + 1].Location);
+	}
+}
+
+void UTraversalPathFollowingComponent::FollowPathSegment(float DeltaTime)
+{
+	AThirdPersonDemoCharacter* Character = GetTraversalCharacter();
+	if (!IsOnTraversalLink() || Character == nullptr)
+	{
+		Super::FollowPathSegment(DeltaTime);
+		return;
+	}
+
+	LinkTime += DeltaTime;
+	if (LinkTime > LinkTimeout)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("%s: timed out on a traversal link, aborting the move"), *Character->GetName());
+		AbortMove(*this, FPathFollowingResultFlags::Blocked);
+		return;
+	}
+
+	FTraversalInputFrame Input;
+	const bool bStillOnLink = UpdateTraversalLink(*Character, Input);
+
+	// The move may have been aborted meanwhile
+	if (!IsOnTraversalLink()) return;
+
+	if (!bStillOnLink)
+	{
+		// Back on the ground past the obstacle, the rest of the segment is a regular move
+		FinishTraversalLink();
+		Super::FollowPathSegment(DeltaTime);
+		return;
+	}
+
+	Character->SetScriptedInput(Input);
+}
+
+void UTraversalPathFollowingComponent::OnPathFinished(const FPathFollowingResult& Result)
+{
+	FinishTraversalLink();
+	Super::OnPathFinished(Result);
+}
+
+AThirdPersonDemoCharacter* UTraversalPathFollowingComponent::GetTraversalCharacter() const
+{
+	return MovementComp != nullptr ? Cast<AThirdPersonDemoCharacter>(MovementComp->GetOwner()) : nullptr;
+}
+
+void UTraversalPathFollowingComponent::StartTraversalLink(const ETraversalNavLinkType InLinkType, const FVector& Start, const FVector& End)
+{
+	LinkType = InLinkType;
+	LinkPhase = ELinkPhase::Approach;
+	LinkStart = Start;
+	LinkEnd = End;
+	LinkTime = 0.f;
+
+	bBlockDetectionBeforeLink = IsBlockDetectionActive();
+	SetBlockDetectionState(false);
+
+	if (LinkType == ETraversalNavLinkType::WallRun)
+	{
+		// Links run along the wall at the wall run offset, look for it on the right once when the link starts
+		const FVector Direction = TraversalMath::GetHorizontal(End - Start).GetSafeNormal();
+		const FVector TraceStart = Start + FVector::UpVector * GetTraversalCharacter()->GetDefaultHalfHeight();
+		const FVector TraceEnd = TraceStart + TraversalMath::RotateAboutZ90(Direction, true) * GetTraversalCharacter()->GetDefaultHalfHeight();
+		const ECollisionChannel TraceChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery_MAX);
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalNavLinkWallSide), false, GetTraversalCharacter());
+		WallSide = GetWorld()->LineTraceTestByChannel(TraceStart, TraceEnd, TraceChannel, QueryParams) ? 1.f : -1.f;
+	}
+}
+
+void UTraversalPathFollowingComponent::FinishTraversalLink()
+{
+	if (!IsOnTraversalLink()) return;
+
+	LinkType = ETraversalNavLinkType::None;
+	SetBlockDetectionState(bBlockDetectionBeforeLink);
+
+	if (AThirdPersonDemoCharacter* Character = GetTraversalCharacter())
+	{
+		Character->ClearScriptedInput();
+	}
+}
+
+bool UTraversalPathFollowingComponent::UpdateTraversalLink(AThirdPersonDemoCharacter& Character, FTraversalInputFrame& OutInput)
+{
+	const ETraversalState State = Character.GetTraversalState();
+	const UCharacterMovementComponent* Movement = Character.GetCharacterMovement();
+	const FVector Direction = TraversalMath::GetHorizontal(LinkEnd - LinkStart).GetSafeNormal();
+
+	OutInput.ControlYaw = Direction.Rotation().Yaw;
+	OutInput.MoveForward = 1.f;
+
+	switch (LinkPhase)
+	{
+	case ELinkPhase::Approach:
+		// Climbs jump right away at the wall. Wall runs first run along it until fast enough to stick to it
+		if (Movement->IsFalling())
+		{
+			LinkPhase = ELinkPhase::Airborne;
+		}
+		else if (LinkType == ETraversalNavLinkType::Climb || TraversalMath::GetHorizontal(Movement->Velocity).Size() >= Character.GetTraversalProfile().WallRunMinHorizontalSpeed)
+		{
+			OutInput.Actions |= ETraversalInputAction::Jump;
+		}
+		return true;
+
+	case ELinkPhase::Airborne:
+		if (State == ETraversalState::Hanging || State == ETraversalState::WallRunning)
+		{
+			LinkPhase = ELinkPhase::Traversing;
+			return UpdateTraversalLink(Character, OutInput);
+		}
+
+		// Missed the ledge or the wall. Let the path be found again from wherever the character landed
+		if (!Movement->IsFalling())
+		{
+			AbortMove(*this, FPathFollowingResultFlags::Blocked);
+			return true;
+		}
+
+		if (LinkType == ETraversalNavLinkType::WallRun) OutInput.MoveRight = WallSide * WallRunSteering;
+		return true;
+
+	case ELinkPhase::Traversing:
+	default:
+		if (LinkType == ETraversalNavLinkType::Climb)
+		{
+			if (State == ETraversalState::Hanging) OutInput.Actions |= ETraversalInputAction::ClimbUp;
+			return State == ETraversalState::Hanging || State == ETraversalState::Climbing;
+		}
+
+		return State == ETraversalState::WallRunning;
+	}
+}
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "TraversalInput.h"
+#include "TraversalNavArea.h"
+#include "TraversalPathFollowingComponent.generated.h"
+
+class AThirdPersonDemoCharacter;
+
+/**
+ * Path following that takes traversal nav links the way a player would: it drives AThirdPersonDemoCharacter with
+ * scripted input, jumping to hang and climbing up ledges, or jumping onto walls and running along them.
+ * Segments that are not traversal links are followed as usual.
+ */
+UCLASS()
+class UTraversalPathFollowingComponent : public UPathFollowingComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** True while the character is driven through a traversal link rather than moved along the path **/
+	bool IsOnTraversalLink() const { return LinkType != ETraversalNavLinkType::None; }
+
+	/** Give up on a traversal link, and the move, after this long **/
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	float LinkTimeout = 6.f;
+
+	/** Sideways input towards the wall between jumping and starting a wall run **/
+	UPROPERTY(EditAnywhere, Category = "Traversal")
+	float WallRunSteering = 0.5f;
+
+protected:
+	virtual void SetMoveSegment(int32 SegmentStartIndex) override;
+	virtual void FollowPathSegment(float DeltaTime) override;
+	virtual void OnPathFinished(const FPathFollowingResult& Result) override;
+
+private:
+	/** Progress through a traversal link **/
+	enum class ELinkPhase : uint8
+	{
+		/** On the ground before the link, getting ready to jump **/
+		Approach,
+
+		/** Jumped, waiting to grab the ledge or the wall **/
+		Airborne,
+
+		/** Hanging and climbing, or running on the wall **/
+		Traversing
+	};
+
+	AThirdPersonDemoCharacter* GetTraversalCharacter() const;
+
+	/** Start driving the character through the link starting at a path point **/
+	void StartTraversalLink(const ETraversalNavLinkType InLinkType, const FVector& Start, const FVector& End);
+
+	/** Hand the character back to its input and the rest of the segment back to regular path following **/
+	void FinishTraversalLink();
+
+	/** Scripted input of this frame on the link. Returns false once the link is done **/
+	bool UpdateTraversalLink(AThirdPersonDemoCharacter& Character, FTraversalInputFrame& OutInput);
+
+	ETraversalNavLinkType LinkType = ETraversalNavLinkType::None;
+	ELinkPhase LinkPhase = ELinkPhase::Approach;
+	FVector LinkStart = FVector::ZeroVector;
+	FVector LinkEnd = FVector::ZeroVector;
+	float LinkTime = 0.f;
+
+	/** Wall runs: +1 if the wall is to the right of the run, -1 if to the left **/
+	float WallSide = 1.f;
+
+	/** Block detection is off on links, the character stands still while hanging **/
+	bool bBlockDetectionBeforeLink = false;
+};
@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalProbeCache.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "TraversalStats.h"
+
+static TAutoConsoleVariable<float> CVarTraversalCoherenceEpsilon(
+	TEXT("traversal.ProbeCache.CoherenceEpsilon"),
+	1.f,
+	TEXT("Distance in cm the start and end of a probe may move while still reusing an earlier hit on static geometry. 0 disables reuse across frames."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTraversalCoherenceMaxFrames(
+	TEXT("traversal.ProbeCache.CoherenceMaxFrames"),
+	10,
+	TEXT("Frames an earlier hit on static geometry may be reused for before tracing again, bounding how long a movable actor passing in front can go unseen."),
+	ECVF_Default);
+
+namespace
+{
+	/** Bumped whenever a level is added to or removed from a world, which drops every coherent entry **/
+	uint32 StreamingGeneration = 0;
+
+	/** Coherent lookups since startup or the last Traversal.ProbeCache.Stats Reset **/
+	uint64 NumCoherentHits = 0;
+	uint64 NumCoherentMisses = 0;
+	uint64 NumCoherentLedgeScanHits = 0;
+	uint64 NumCoherentLedgeScanMisses = 0;
+
+	void BumpStreamingGeneration(ULevel* Level, UWorld* World)
+	{
+		++StreamingGeneration;
+	}
+
+	bool IsRecent(const uint64 TraceFrameNumber, const uint32 EntryStreamingGeneration)
+	{
+		if (TraceFrameNumber == MAX_uint64) return false;
+		if (GFrameCounter - TraceFrameNumber > static_cast<uint64>(FMath::Max(CVarTraversalCoherenceMaxFrames.GetValueOnGameThread(), 0))) return false;
+		return EntryStreamingGeneration == StreamingGeneration;
+	}
+
+	/** Only static components are trusted to stay put, and even those are checked in case the editor moved them **/
+	bool IsStaticAndUnmoved(const UPrimitiveComponent* Component, const FTransform& Transform)
+	{
+		return Component != nullptr && Component->Mobility == EComponentMobility::Static && Component->GetComponentTransform().Equals(Transform, 0.f);
+	}
+
+	bool IsCoherent(const FTraversalProbeEntry& Entry, const FVector& TraceStart, const FVector& TraceEnd, const float Epsilon)
+	{
+		// Misses are never reused, something may have streamed in or moved into the segment
+		if (!Entry.bHit || !IsRecent(Entry.TraceFrameNumber, Entry.StreamingGeneration)) return false;
+		if (FVector::DistSquared(Entry.TraceStart, TraceStart) > FMath::Square(Epsilon) || FVector::DistSquared(Entry.TraceEnd, TraceEnd) > FMath::Square(Epsilon)) return false;
+
+		return IsStaticAndUnmoved(Entry.Hit.Component.Get(), Entry.HitComponentTransform);
+	}
+
+	FVector GetLedgeScanReachEnd(const FTraversalLedgeScanSettings& Settings)
+	{
+		return Settings.Origin + Settings.Forward * (Settings.ForwardDistance + Settings.DepthReach);
+	}
+
+	bool IsCoherent(const FTraversalLedgeScanEntry& Entry, const FTraversalLedgeScanSettings& Settings, const float Epsilon)
+	{
+		// Unlike a single probe, the overlap saw every component in the scanned volume, so a scan that found no ledge
+		// is reused as well. A movable actor entering the volume goes unseen for CoherenceMaxFrames at most
+		if (!IsRecent(Entry.TraceFrameNumber, Entry.StreamingGeneration)) return false;
+		if (FVector::DistSquared(Entry.Origin, Settings.Origin) > FMath::Square(Epsilon) || FVector::DistSquared(Entry.ReachEnd, GetLedgeScanReachEnd(Settings)) > FMath::Square(Epsilon)) return false;
+
+		for (int32 Index = 0; Index < Entry.Components.Num(); ++Index)
+		{
+			if (!IsStaticAndUnmoved(Entry.Components[Index].Get(), Entry.ComponentTransforms[Index])) return false;
+		}
+		return true;
+	}
+
+	void RegisterStreamingDelegates()
+	{
+		static bool bRegistered = false;
+		if (bRegistered) return;
+
+		FWorldDelegates::LevelAddedToWorld.AddStatic(&BumpStreamingGeneration);
+		FWorldDelegates::LevelRemovedFromWorld.AddStatic(&BumpStreamingGeneration);
+		bRegistered = true;
+	}
+}
+
+static FAutoConsoleCommand TraversalProbeCacheStatsCommand(
+	TEXT("Traversal.ProbeCache.Stats"),
+	TEXT("Log the hit rate of reusing probes across frames. Args: Reset"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const uint64 NumLookups = NumCoherentHits + NumCoherentMisses;
+		UE_LOG(LogTemp, Log, TEXT("Traversal probe coherence: %llu hits out of %llu lookups (%.1f%%), epsilon %.2f"), NumCoherentHits, NumLookups,
+			NumLookups > 0 ? 100.0 * NumCoherentHits / NumLookups : 0.0, CVarTraversalCoherenceEpsilon.GetValueOnGameThread());
+
+		const uint64 NumLedgeScanLookups = NumCoherentLedgeScanHits + NumCoherentLedgeScanMisses;
+		UE_LOG(LogTemp, Log, TEXT("Traversal ledge scan coherence: %llu hits out of %llu lookups (%.1f%%)"), NumCoherentLedgeScanHits, NumLedgeScanLookups,
+			NumLedgeScanLookups > 0 ? 100.0 * NumCoherentLedgeScanHits / NumLedgeScanLookups : 0.0);
+
+		if (FString::Join(Args, TEXT(" ")).Contains(TEXT("Reset")))
+		{
+			NumCoherentHits = 0;
+			NumCoherentMisses = 0;
+			NumCoherentLedgeScanHits = 0;
+			NumCoherentLedgeScanMisses = 0;
+		}
+	}));
+
+const FTraversalProbeEntry* FTraversalProbeCache::Find(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd) const
+{
+	const FTraversalProbeEntry& Entry = Entries[static_cast<uint8>(Probe)];
+
+	// Only reuse results from this frame that traced exactly the same segment
+	if (Entry.FrameNumber != GFrameCounter) return nullptr;
+	if (!Entry.ProbeStart.Equals(TraceStart, 0.f) || !Entry.ProbeEnd.Equals(TraceEnd, 0.f)) return nullptr;
+
+	return &Entry;
+}
+
+const FTraversalProbeEntry* FTraversalProbeCache::FindCoherent(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd) const
+{
+	const float Epsilon = CVarTraversalCoherenceEpsilon.GetValueOnGameThread();
+	if (Epsilon <= 0.f) return nullptr;
+
+	const FTraversalProbeEntry& Entry = Entries[static_cast<uint8>(Probe)];
+	if (IsCoherent(Entry, TraceStart, TraceEnd, Epsilon))
+	{
+		INC_DWORD_STAT(STAT_TraversalCoherentProbeHits);
+		++NumCoherentHits;
+		return &Entry;
+	}
+
+	INC_DWORD_STAT(STAT_TraversalCoherentProbeMisses);
+	++NumCoherentMisses;
+	return nullptr;
+}
+
+void FTraversalProbeCache::Store(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd, const bool bHit, const FTraversalProbeHit& Hit)
+{
+	RegisterStreamingDelegates();
+
+	FTraversalProbeEntry& Entry = Entries[static_cast<uint8>(Probe)];
+	Entry.FrameNumber = GFrameCounter;
+	Entry.ProbeStart = TraceStart;
+	Entry.ProbeEnd = TraceEnd;
+	Entry.bHit = bHit;
+	Entry.Hit = Hit;
+
+	Entry.TraceFrameNumber = GFrameCounter;
+	Entry.TraceStart = TraceStart;
+	Entry.TraceEnd = TraceEnd;
+	Entry.StreamingGeneration = StreamingGeneration;
+
+	const UPrimitiveComponent* HitComponent = bHit ? Hit.Component.Get() : nullptr;
+	if (HitComponent != nullptr) Entry.HitComponentTransform = HitComponent->GetComponentTransform();
+}
+
+void FTraversalProbeCache::Refresh(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd)
+{
+	FTraversalProbeEntry& Entry = Entries[static_cast<uint8>(Probe)];
+	Entry.FrameNumber = GFrameCounter;
+	Entry.ProbeStart = TraceStart;
+	Entry.ProbeEnd = TraceEnd;
+}
+
+const FTraversalLedgeScanEntry* FTraversalProbeCache::FindCoherentLedgeScan(const FTraversalLedgeScanSettings& Settings) const
+{
+	const float Epsilon = CVarTraversalCoherenceEpsilon.GetValueOnGameThread();
+	if (Epsilon <= 0.f) return nullptr;
+
+	if (IsCoherent(LedgeScanEntry, Settings, Epsilon))
+	{
+		INC_DWORD_STAT(STAT_TraversalCoherentLedgeScanHits);
+		++NumCoherentLedgeScanHits;
+		return &LedgeScanEntry;
+	}
+
+	INC_DWORD_STAT(STAT_TraversalCoherentLedgeScanMisses);
+	++NumCoherentLedgeScanMisses;
+	return nullptr;
+}
+
+void FTraversalProbeCache::StoreLedgeScan(const FTraversalLedgeScanSettings& Settings, const TArray<FOverlapResult>& Overlaps, const bool bFound, const FTraversalLedgeProfile& Profile)
+{
+	RegisterStreamingDelegates();
+
+	LedgeScanEntry.TraceFrameNumber = GFrameCounter;
+	LedgeScanEntry.Origin = Settings.Origin;
+	LedgeScanEntry.ReachEnd = GetLedgeScanReachEnd(Settings);
+	LedgeScanEntry.bFound = bFound;
+	LedgeScanEntry.Profile = Profile;
+	LedgeScanEntry.StreamingGeneration = StreamingGeneration;
+
+	LedgeScanEntry.Components.Reset();
+	LedgeScanEntry.ComponentTransforms.Reset();
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (Component == nullptr || LedgeScanEntry.Components.Contains(Component)) continue;
+
+		LedgeScanEntry.Components.Add(Component);
+		LedgeScanEntry.ComponentTransforms.Add(Component->GetComponentTransform());
+	}
+}
+
+void FTraversalProbeCache::Invalidate()
+{
+	for (FTraversalProbeEntry& Entry : Entries)
+	{
+		Entry.FrameNumber = MAX_uint64;
+		Entry.TraceFrameNumber = MAX_uint64;
+	}
+	LedgeScanEntry.TraceFrameNumber = MAX_uint64;
+}
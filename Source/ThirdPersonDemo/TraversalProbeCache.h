@@ -0,0 +1,130 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "TraversalLedgeScanner.h"
+
+/** Every distinct line trace the traversal system can issue in a frame **/
+enum class ETraversalProbe : uint8
+{
+	/** Rays of the ledge scan. Never cached one by one, the whole scan is, see FTraversalLedgeScanEntry **/
+	LedgeScan,
+	/** Side rays along a predicted jump trajectory. Never cached **/
+	WallRunPrediction,
+	SideWallRunRight,
+	SideWallRunLeft,
+	DownWallRun,
+	ForwardCoverTall,
+	ForwardCoverShort,
+	SideCoverRight,
+	SideCoverLeft,
+
+	Count
+};
+
+/** What traversal keeps of a probe hit. A fraction of an FHitResult, which characters would otherwise hold several of **/
+struct FTraversalProbeHit
+{
+	FTraversalProbeHit() = default;
+
+	FTraversalProbeHit(const FVector& InLocation, const FVector& InNormal)
+		: Location(InLocation)
+		, Normal(InNormal)
+	{
+	}
+
+	explicit FTraversalProbeHit(const FHitResult& HitResult)
+		: Location(HitResult.Location)
+		, Normal(HitResult.Normal)
+		, Component(HitResult.GetComponent())
+	{
+	}
+
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+
+	/** Component hit. Unset for hits answered by the baked edge index **/
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+};
+
+/** Memoized result of a single traversal probe **/
+struct FTraversalProbeEntry
+{
+	/** Frame the probe was run on. Entries from other frames are stale **/
+	uint64 FrameNumber = MAX_uint64;
+
+	/** Segment the probe was asked for on FrameNumber. Probes built from an earlier hit change segment within a frame **/
+	FVector ProbeStart = FVector::ZeroVector;
+	FVector ProbeEnd = FVector::ZeroVector;
+
+	bool bHit = false;
+	FTraversalProbeHit Hit;
+
+	/** Frame the trace actually ran on, and its segment. Coherent reuse keeps these from the original trace **/
+	uint64 TraceFrameNumber = MAX_uint64;
+	FVector TraceStart = FVector::ZeroVector;
+	FVector TraceEnd = FVector::ZeroVector;
+
+	/** Where the component that was hit was, and the level streaming generation at the time **/
+	FTransform HitComponentTransform;
+	uint32 StreamingGeneration = 0;
+};
+
+/** Result of a ledge scan, with every component its overlap found and where they were **/
+struct FTraversalLedgeScanEntry
+{
+	/** Frame the overlap ran on **/
+	uint64 TraceFrameNumber = MAX_uint64;
+
+	/** Origin of the scan and the far end of its reach, compared like the segment of a probe **/
+	FVector Origin = FVector::ZeroVector;
+	FVector ReachEnd = FVector::ZeroVector;
+
+	bool bFound = false;
+	FTraversalLedgeProfile Profile;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>, TInlineAllocator<8>> Components;
+	TArray<FTransform, TInlineAllocator<8>> ComponentTransforms;
+	uint32 StreamingGeneration = 0;
+};
+
+/**
+ * Per-frame cache of traversal probe results, keyed by probe type and segment.
+ * Lets every consumer in a tick share one scene query per probe instead of re-tracing.
+ * Across frames, hits on static geometry are reused while the probe segment barely moves, e.g. in cover or hanging.
+ */
+struct FTraversalProbeCache
+{
+	/** Returns the memoized entry if the probe already ran this frame along the same segment, nullptr otherwise **/
+	const FTraversalProbeEntry* Find(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd) const;
+
+	/**
+	 * Returns the entry of an earlier frame if it hit a static component that has not moved or streamed out since,
+	 * and its segment is within traversal.ProbeCache.CoherenceEpsilon of this one. nullptr otherwise
+	 */
+	const FTraversalProbeEntry* FindCoherent(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd) const;
+
+	/** Store the result of a probe run this frame **/
+	void Store(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd, const bool bHit, const FTraversalProbeHit& Hit);
+
+	/** Serve a coherent entry for this frame too, so Find shares it with the other consumers **/
+	void Refresh(const ETraversalProbe Probe, const FVector& TraceStart, const FVector& TraceEnd);
+
+	/**
+	 * Returns the last ledge scan if everything its overlap found is static and has not moved or streamed out since,
+	 * and the scan origin and reach are within traversal.ProbeCache.CoherenceEpsilon of these settings. nullptr otherwise
+	 */
+	const FTraversalLedgeScanEntry* FindCoherentLedgeScan(const FTraversalLedgeScanSettings& Settings) const;
+
+	/** Store the result of a ledge scan and the overlap it was run against **/
+	void StoreLedgeScan(const FTraversalLedgeScanSettings& Settings, const TArray<FOverlapResult>& Overlaps, const bool bFound, const FTraversalLedgeProfile& Profile);
+
+	/** Drop every entry, e.g. when the traversal state changes and earlier hits no longer describe the surroundings **/
+	void Invalidate();
+
+private:
+	FTraversalProbeEntry Entries[static_cast<uint8>(ETraversalProbe::Count)];
+	FTraversalLedgeScanEntry LedgeScanEntry;
+};
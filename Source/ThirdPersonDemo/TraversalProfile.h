@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TraversalProfile.generated.h"
+
+/**
+ * Traversal tuning of a kind of character. Characters reference one shared asset instead of each carrying
+ * their own copy of every value. Characters without a profile use the class defaults below.
+ */
+UCLASS(BlueprintType)
+class UTraversalProfile : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** How long a press that could not be acted on is retried, e.g. ClimbUp pressed just before grabbing a ledge **/
+	UPROPERTY(EditAnywhere, Category = "Input")
+	float InputBufferTime = 0.15f;
+
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float MaxAimMoveRate = 0.4f;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float ClimbForwardDistance = 50;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float ClimbUpMaxDistance = 100;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float ClimbUpMinDistance = 30;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunSideDistance = 30;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunMinHorizontalSpeed = 500;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunMinVerticalVelocity = -100;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunMinJumpOffSpeed = 800.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunMinGravityScale = 0.15f;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunVerticalSpeedMultiplier = 0.5f;
+	/** How far ahead a jump is swept for walls to run on **/
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunPredictionTime = 1.f;
+	/** Velocity drift from the predicted jump, in cm/s, after which it is swept again **/
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float WallRunPredictionTolerance = 50.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	int32 LedgeScanVerticalRays = 6;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	int32 LedgeScanHorizontalRays = 5;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float LedgeScanDepthReach = 40.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float LedgeScanClearanceReach = 100.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float CoverForwardDistance = 100;
+	UPROPERTY(EditAnywhere, Category = "Traversal Properties")
+	float CoverSideDistance = 100;
+
+	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
+	float HangHorizontalOffset = 50.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
+	float HangVerticalOffset = 50.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
+	float WallRunOffset = 45.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
+	float CoverForwardOffset = 50.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
+	float CoverSideOffset = 50.f;
+	UPROPERTY(EditAnywhere, Category = "Traversal tweaks")
+	float CoverAimYOffset = 50.f;
+
+	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
+	float CameraCoverYOffset = 50.f;
+	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
+	float CameraAimYOffset = 30.f;
+	/** Time the camera rig takes to settle on a new offset and boom length **/
+	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
+	float CameraSmoothTime = 0.1f;
+	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
+	float CameraBoomAimLength = 150.f;
+	UPROPERTY(EditAnywhere, Category = "Camera Control tweaks")
+	float TraceOffset = 10.f;
+};
@@ -0,0 +1,42 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalProximitySubsystem.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "TraversableComponent.h"
+
+static TAutoConsoleVariable<int32> CVarTraversalProximityCulling(
+	TEXT("traversal.Proximity.Culling"),
+	1,
+	TEXT("Only run ledge and cover probes while a traversable actor is in range. Has no effect in worlds without traversable actors."),
+	ECVF_Default);
+
+void UTraversalProximitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Tagged actors have no component to register them. Only the ones loaded with the world are picked up,
+	// streamed levels should use UTraversableComponent
+	for (TActorIterator<AActor> ActorIterator(&InWorld); ActorIterator; ++ActorIterator)
+	{
+		if (!ActorIterator->ActorHasTag(UTraversableComponent::ActorTag)) continue;
+
+		UTraversableComponent::EnableProximityOverlaps(*ActorIterator);
+		++NumTraversables;
+	}
+}
+
+void UTraversalProximitySubsystem::RegisterTraversable()
+{
+	++NumTraversables;
+}
+
+void UTraversalProximitySubsystem::UnregisterTraversable()
+{
+	NumTraversables = FMath::Max(0, NumTraversables - 1);
+}
+
+bool UTraversalProximitySubsystem::IsProximityCullingActive() const
+{
+	return NumTraversables > 0 && CVarTraversalProximityCulling.GetValueOnGameThread() != 0;
+}
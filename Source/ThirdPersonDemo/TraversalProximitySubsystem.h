@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TraversalProximitySubsystem.generated.h"
+
+/**
+ * Keeps track of the traversable actors of a world. Characters only cull their probes by proximity once the world has
+ * any, so levels that were never marked up keep probing everywhere.
+ */
+UCLASS()
+class UTraversalProximitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Called by UTraversableComponent when it starts play **/
+	void RegisterTraversable();
+
+	/** Called by UTraversableComponent when it ends play **/
+	void UnregisterTraversable();
+
+	/** Returns true if probes should only run near traversable actors **/
+	bool IsProximityCullingActive() const;
+
+private:
+	/** Traversable components playing, plus actors tagged when the world began play **/
+	int32 NumTraversables = 0;
+};
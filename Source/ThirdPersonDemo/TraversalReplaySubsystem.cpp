@@ -0,0 +1,367 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalReplaySubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "ThirdPersonDemoCharacter.h"
+
+namespace
+{
+	const uint32 ReplayMagic = 0x52565254;
+	const uint32 ReplayVersion = 1;
+
+	/** Frames only store the input fields that changed since the previous frame **/
+	namespace EReplayFrameField
+	{
+		enum Type : uint8
+		{
+			MoveForward = 1 << 0,
+			MoveRight = 1 << 1,
+			ControlYaw = 1 << 2,
+			ControlPitch = 1 << 3,
+			Actions = 1 << 4
+		};
+	}
+
+	template<typename ValueType>
+	void SerializeChangedField(FArchive& Ar, const uint8 ChangedFields, const uint8 Field, ValueType& Value)
+	{
+		if (ChangedFields & Field) Ar << Value;
+	}
+
+	void SerializeFrames(FArchive& Ar, TArray<FTraversalReplayFrame>& Frames)
+	{
+		int32 NumFrames = Frames.Num();
+		Ar << NumFrames;
+		if (Ar.IsLoading())
+		{
+			if (NumFrames < 0 || NumFrames > Ar.TotalSize())
+			{
+				Ar.SetError();
+				return;
+			}
+			Frames.SetNum(NumFrames);
+		}
+
+		FTraversalInputFrame PreviousInput;
+		for (FTraversalReplayFrame& Frame : Frames)
+		{
+			FTraversalInputFrame& Input = Frame.Input;
+
+			uint8 ChangedFields = 0;
+			if (Ar.IsSaving())
+			{
+				if (Input.MoveForward != PreviousInput.MoveForward) ChangedFields |= EReplayFrameField::MoveForward;
+				if (Input.MoveRight != PreviousInput.MoveRight) ChangedFields |= EReplayFrameField::MoveRight;
+				if (Input.ControlYaw != PreviousInput.ControlYaw) ChangedFields |= EReplayFrameField::ControlYaw;
+				if (Input.ControlPitch != PreviousInput.ControlPitch) ChangedFields |= EReplayFrameField::ControlPitch;
+				if (Input.Actions != PreviousInput.Actions) ChangedFields |= EReplayFrameField::Actions;
+			}
+			Ar << ChangedFields;
+
+			// Unchanged fields carry over from the previous frame
+			if (Ar.IsLoading()) Input = PreviousInput;
+			SerializeChangedField(Ar, ChangedFields, EReplayFrameField::MoveForward, Input.MoveForward);
+			SerializeChangedField(Ar, ChangedFields, EReplayFrameField::MoveRight, Input.MoveRight);
+			SerializeChangedField(Ar, ChangedFields, EReplayFrameField::ControlYaw, Input.ControlYaw);
+			SerializeChangedField(Ar, ChangedFields, EReplayFrameField::ControlPitch, Input.ControlPitch);
+			SerializeChangedField(Ar, ChangedFields, EReplayFrameField::Actions, Input.Actions);
+
+			Ar << Frame.Checksum;
+			PreviousInput = Input;
+		}
+	}
+
+	AThirdPersonDemoCharacter* GetLocalCharacter(UWorld* World)
+	{
+		APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		return PlayerController ? Cast<AThirdPersonDemoCharacter>(PlayerController->GetPawn()) : nullptr;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TraversalRecordStartCommand(
+	TEXT("Traversal.Record.Start"),
+	TEXT("Record the input of the local traversal character at a fixed timestep. Args: Step=<seconds>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UTraversalReplaySubsystem* ReplaySubsystem = World ? World->GetSubsystem<UTraversalReplaySubsystem>() : nullptr;
+		if (ReplaySubsystem == nullptr) return;
+
+		float FixedDeltaSeconds = 1.f / 60.f;
+		FParse::Value(*FString::Join(Args, TEXT(" ")), TEXT("Step="), FixedDeltaSeconds);
+		ReplaySubsystem->StartRecording(GetLocalCharacter(World), FixedDeltaSeconds);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs TraversalRecordStopCommand(
+	TEXT("Traversal.Record.Stop"),
+	TEXT("Stop recording and save. Args: File=<path>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UTraversalReplaySubsystem* ReplaySubsystem = World ? World->GetSubsystem<UTraversalReplaySubsystem>() : nullptr;
+		if (ReplaySubsystem == nullptr) return;
+
+		FString Path = UTraversalReplaySubsystem::GetDefaultReplayPath();
+		FParse::Value(*FString::Join(Args, TEXT(" ")), TEXT("File="), Path);
+		ReplaySubsystem->StopRecording(Path);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs TraversalReplayCommand(
+	TEXT("Traversal.Replay"),
+	TEXT("Replay a recording on the local traversal character and check it against the recorded state. Args: File=<path> Quit"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UTraversalReplaySubsystem* ReplaySubsystem = World ? World->GetSubsystem<UTraversalReplaySubsystem>() : nullptr;
+		if (ReplaySubsystem == nullptr) return;
+
+		FString Path = UTraversalReplaySubsystem::GetDefaultReplayPath();
+		FParse::Value(*FString::Join(Args, TEXT(" ")), TEXT("File="), Path);
+		ReplaySubsystem->StartReplay(GetLocalCharacter(World), Path, Args.Contains(TEXT("Quit")));
+	}));
+
+FArchive& operator<<(FArchive& Ar, FTraversalReplayHeader& Header)
+{
+	Ar << Header.FixedDeltaSeconds;
+	Ar << Header.StartLocation;
+	Ar << Header.StartRotation;
+	Ar << Header.StartVelocity;
+	return Ar;
+}
+
+void UTraversalReplaySubsystem::Deinitialize()
+{
+	if (Mode != EMode::Idle) Stop();
+
+	Super::Deinitialize();
+}
+
+FString UTraversalReplaySubsystem::GetDefaultReplayPath()
+{
+	return FPaths::ProfilingDir() / TEXT("Traversal") / TEXT("TraversalReplay.trvreplay");
+}
+
+bool UTraversalReplaySubsystem::StartRecording(AThirdPersonDemoCharacter* InCharacter, const float FixedDeltaSeconds)
+{
+	if (Mode != EMode::Idle || InCharacter == nullptr) return false;
+
+	// Replays start from the default state, everything else would need the whole traversal state saved
+	if (InCharacter->GetTraversalState() != ETraversalState::Default)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Traversal recording has to start in the default traversal state"));
+		return false;
+	}
+
+	Header = FTraversalReplayHeader();
+	Header.FixedDeltaSeconds = FMath::Max(FixedDeltaSeconds, KINDA_SMALL_NUMBER);
+	Frames.Reset();
+	Start(EMode::Recording, InCharacter);
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal recording started"));
+	return true;
+}
+
+bool UTraversalReplaySubsystem::StopRecording(const FString& Path)
+{
+	if (Mode != EMode::Recording) return false;
+
+	Stop();
+
+	if (!SaveReplay(Path, Header, Frames))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not write traversal recording %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal recording of %d frames written to %s"), Frames.Num(), *Path);
+	return true;
+}
+
+bool UTraversalReplaySubsystem::StartReplay(AThirdPersonDemoCharacter* InCharacter, const FString& Path, const bool bInQuitWhenDone)
+{
+	if (Mode != EMode::Idle || InCharacter == nullptr) return false;
+
+	if (!LoadReplay(Path, Header, Frames))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not read traversal recording %s"), *Path);
+		return false;
+	}
+
+	NumMismatches = 0;
+	FirstMismatchFrame = INDEX_NONE;
+	ReplayChecksum = 0;
+	bQuitWhenDone = bInQuitWhenDone;
+	Start(EMode::Replaying, InCharacter);
+
+	// Live input would fight the replayed one
+	if (APlayerController* PlayerController = Cast<APlayerController>(Character->Controller))
+	{
+		Character->DisableInput(PlayerController);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Traversal replay of %d frames started"), Frames.Num());
+	return true;
+}
+
+void UTraversalReplaySubsystem::StopReplay()
+{
+	if (Mode != EMode::Replaying) return;
+
+	if (IsValid(Character))
+	{
+		Character->ClearScriptedInput();
+		if (APlayerController* PlayerController = Cast<APlayerController>(Character->Controller))
+		{
+			Character->EnableInput(PlayerController);
+		}
+	}
+	Stop();
+
+	const bool bMatched = NumMismatches == 0 && FrameIndex == Frames.Num();
+	if (bMatched)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Traversal replay matched all %d frames, checksum %08x"), FrameIndex, ReplayChecksum);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Traversal replay diverged at frame %d, %d of %d frames mismatched, checksum %08x"), FirstMismatchFrame, NumMismatches, FrameIndex, ReplayChecksum);
+	}
+
+	if (bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bMatched ? 0 : 1);
+	}
+}
+
+void UTraversalReplaySubsystem::Start(const EMode NewMode, AThirdPersonDemoCharacter* InCharacter)
+{
+	Mode = NewMode;
+	Character = InCharacter;
+	bPendingStart = true;
+	FrameIndex = 0;
+
+	// Both recording and replay tick at the same fixed timestep so they simulate the same frames
+	bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+	SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(Header.FixedDeltaSeconds);
+
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UTraversalReplaySubsystem::OnWorldTickStart);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UTraversalReplaySubsystem::OnWorldPostActorTick);
+}
+
+void UTraversalReplaySubsystem::Stop()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+
+	Mode = EMode::Idle;
+	Character = nullptr;
+}
+
+void UTraversalReplaySubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld()) return;
+
+	if (!IsValid(Character))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Traversal character destroyed, stopping"));
+		if (Mode == EMode::Replaying)
+		{
+			StopReplay();
+		}
+		else
+		{
+			Stop();
+		}
+		return;
+	}
+
+	if (bPendingStart)
+	{
+		bPendingStart = false;
+		UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+		if (Mode == EMode::Recording)
+		{
+			Header.StartLocation = Character->GetActorLocation();
+			Header.StartRotation = Character->GetActorRotation();
+			Header.StartVelocity = MovementComponent->Velocity;
+		}
+		else
+		{
+			Character->SetActorLocationAndRotation(Header.StartLocation, Header.StartRotation, false, nullptr, ETeleportType::TeleportPhysics);
+			MovementComponent->Velocity = Header.StartVelocity;
+		}
+	}
+
+	if (Mode != EMode::Replaying) return;
+
+	if (FrameIndex >= Frames.Num())
+	{
+		StopReplay();
+		return;
+	}
+
+	Character->SetScriptedInput(Frames[FrameIndex].Input);
+}
+
+void UTraversalReplaySubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || bPendingStart || !IsValid(Character)) return;
+
+	const uint32 Checksum = Character->GetTraversalChecksum();
+	if (Mode == EMode::Recording)
+	{
+		FTraversalReplayFrame& Frame = Frames.AddDefaulted_GetRef();
+		Frame.Input = Character->GetLastInputFrame();
+		Frame.Checksum = Checksum;
+	}
+	else if (Mode == EMode::Replaying && Frames.IsValidIndex(FrameIndex))
+	{
+		if (Checksum != Frames[FrameIndex].Checksum)
+		{
+			if (NumMismatches++ == 0) FirstMismatchFrame = FrameIndex;
+		}
+		ReplayChecksum = FCrc::MemCrc32(&Checksum, sizeof(Checksum), ReplayChecksum);
+	}
+
+	++FrameIndex;
+}
+
+bool UTraversalReplaySubsystem::SaveReplay(const FString& Path, FTraversalReplayHeader& InHeader, TArray<FTraversalReplayFrame>& InFrames)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	uint32 Magic = ReplayMagic;
+	uint32 Version = ReplayVersion;
+	Writer << Magic << Version;
+	Writer << InHeader;
+	SerializeFrames(Writer, InFrames);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool UTraversalReplaySubsystem::LoadReplay(const FString& Path, FTraversalReplayHeader& OutHeader, TArray<FTraversalReplayFrame>& OutFrames)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path)) return false;
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Magic != ReplayMagic || Version != ReplayVersion) return false;
+
+	Reader << OutHeader;
+	SerializeFrames(Reader, OutFrames);
+	return !Reader.IsError();
+}
@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TraversalInput.h"
+#include "TraversalReplaySubsystem.generated.h"
+
+class AThirdPersonDemoCharacter;
+
+/** Where a recording starts from and how fast it ticks **/
+struct FTraversalReplayHeader
+{
+	float FixedDeltaSeconds = 1.f / 60.f;
+	FVector StartLocation = FVector::ZeroVector;
+	FRotator StartRotation = FRotator::ZeroRotator;
+	FVector StartVelocity = FVector::ZeroVector;
+
+	friend FArchive& operator<<(FArchive& Ar, FTraversalReplayHeader& Header);
+};
+
+/** Recorded input of a frame and the checksum of the state it led to **/
+struct FTraversalReplayFrame
+{
+	FTraversalInputFrame Input;
+	uint32 Checksum = 0;
+};
+
+/**
+ * Records the input stream of the local traversal character to a compact binary file and replays it at a fixed timestep,
+ * checking every frame against the recorded state checksum. Used to confirm optimizations don't change behaviour.
+ *
+ * Traversal.Record.Start [Step=<seconds>], Traversal.Record.Stop [File=<path>], Traversal.Replay [File=<path>] [Quit]
+ */
+UCLASS()
+class UTraversalReplaySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Record the character from the next frame on, ticking at a fixed timestep. The character has to be in the default traversal state **/
+	bool StartRecording(AThirdPersonDemoCharacter* InCharacter, const float FixedDeltaSeconds);
+
+	/** Stop recording and write the file **/
+	bool StopRecording(const FString& Path);
+
+	/** Load a recording and replay it on the character from the next frame on **/
+	bool StartReplay(AThirdPersonDemoCharacter* InCharacter, const FString& Path, const bool bInQuitWhenDone);
+
+	/** Stop replaying and log how the replay compared with the recording **/
+	void StopReplay();
+
+	bool IsRecording() const { return Mode == EMode::Recording; }
+	bool IsReplaying() const { return Mode == EMode::Replaying; }
+
+	/** File used when no path is given **/
+	static FString GetDefaultReplayPath();
+
+private:
+	enum class EMode : uint8
+	{
+		Idle,
+		Recording,
+		Replaying
+	};
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void Start(const EMode NewMode, AThirdPersonDemoCharacter* InCharacter);
+	void Stop();
+
+	static bool SaveReplay(const FString& Path, FTraversalReplayHeader& InHeader, TArray<FTraversalReplayFrame>& InFrames);
+	static bool LoadReplay(const FString& Path, FTraversalReplayHeader& OutHeader, TArray<FTraversalReplayFrame>& OutFrames);
+
+	EMode Mode = EMode::Idle;
+
+	UPROPERTY()
+	AThirdPersonDemoCharacter* Character;
+
+	FTraversalReplayHeader Header;
+	TArray<FTraversalReplayFrame> Frames;
+
+	/** Set until the first frame ticked, which records or restores the header **/
+	bool bPendingStart = false;
+	int32 FrameIndex = 0;
+
+	/** Replay results **/
+	int32 NumMismatches = 0;
+	int32 FirstMismatchFrame = INDEX_NONE;
+	uint32 ReplayChecksum = 0;
+	bool bQuitWhenDone = false;
+
+	/** Timestep settings to restore when done **/
+	bool bSavedUseFixedTimeStep = false;
+	double SavedFixedDeltaTime = 0.0;
+
+	FDelegateHandle TickStartHandle;
+	FDelegateHandle PostActorTickHandle;
+};
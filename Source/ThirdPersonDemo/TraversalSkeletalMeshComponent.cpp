@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalSkeletalMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "TraversalStats.h"
+
+UTraversalSkeletalMeshComponent::UTraversalSkeletalMeshComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bEnableUpdateRateOptimizations = true;
+	VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+
+	// The budget allocator only calls CalculateSignificance for meshes that ask it to
+	SetAutoCalculateSignificance(true);
+}
+
+void UTraversalSkeletalMeshComponent::BeginPlay()
+{
+	// Shared by every budgeted mesh, bound once
+	static bool bSignificanceBound = false;
+	if (!bSignificanceBound)
+	{
+		USkeletalMeshComponentBudgeted::SetOnCalculateSignificance(FOnCalculateSignificance::CreateStatic(&UTraversalSkeletalMeshComponent::CalculateSignificance));
+		bSignificanceBound = true;
+	}
+
+	Super::BeginPlay();
+}
+
+void UTraversalSkeletalMeshComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraversalAnimTick);
+
+	// Game thread part of the animation update only, parallel evaluation runs on workers unless a.ParallelAnimEvaluation is 0
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	GTraversalAnimCycles += FPlatformTime::Cycles64() - StartCycles;
+	++GTraversalAnimTicks;
+}
+
+float UTraversalSkeletalMeshComponent::CalculateSignificance(USkeletalMeshComponentBudgeted* Component)
+{
+	const APawn* Pawn = Cast<APawn>(Component->GetOwner());
+	if (Pawn != nullptr && Pawn->IsLocallyControlled() && Pawn->IsPlayerControlled()) return 1.f;
+
+	const UWorld* World = Component->GetWorld();
+	if (World == nullptr) return 1.f;
+
+	// Nearest local camera. Without one, e.g. headless, everything is equally significant
+	float MinDistanceSquared = MAX_flt;
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController == nullptr || !PlayerController->IsLocalController() || PlayerController->PlayerCameraManager == nullptr) continue;
+
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(PlayerController->PlayerCameraManager->GetCameraLocation(), Component->GetComponentLocation()));
+	}
+	if (MinDistanceSquared == MAX_flt) return 1.f;
+
+	const UTraversalSkeletalMeshComponent* TraversalMesh = Cast<UTraversalSkeletalMeshComponent>(Component);
+	const float MaxDistance = TraversalMesh != nullptr ? TraversalMesh->SignificanceDistance : 5000.f;
+	return 1.f - FMath::Clamp(FMath::Sqrt(MinDistanceSquared) / FMath::Max(MaxDistance, 1.f), 0.f, 1.f);
+}
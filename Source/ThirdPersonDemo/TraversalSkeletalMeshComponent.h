@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "TraversalSkeletalMeshComponent.generated.h"
+
+/**
+ * Character mesh of traversal characters. Registers with the animation budget allocator so crowds of traversers
+ * share a fixed animation budget, with significance falling off with distance from the local players' cameras.
+ * Update rate optimizations are on for when the allocator is disabled (a.Budget.Enabled 0).
+ * Offscreen meshes keep ticking montages so montage driven traversal, like climbing up, still completes.
+ */
+UCLASS()
+class UTraversalSkeletalMeshComponent : public USkeletalMeshComponentBudgeted
+{
+	GENERATED_BODY()
+
+public:
+	UTraversalSkeletalMeshComponent(const FObjectInitializer& ObjectInitializer);
+
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Distance from the nearest local camera past which a mesh has the lowest significance **/
+	UPROPERTY(EditAnywhere, Category = "Optimization")
+	float SignificanceDistance = 5000.f;
+
+private:
+	/** Budget allocator significance: 1 for locally controlled characters, then falling off to 0 at SignificanceDistance **/
+	static float CalculateSignificance(USkeletalMeshComponentBudgeted* Component);
+};
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalState.h"
+
+namespace
+{
+	constexpr uint8 StateBit(const ETraversalState State)
+	{
+		return 1 << static_cast<uint8>(State);
+	}
+
+	const FTraversalStateDesc StateDescs[] =
+	{
+		// Default
+		{
+			ETraversalCheck::DefaultMove | ETraversalCheck::LedgeIndicator | ETraversalCheck::Ledge | ETraversalCheck::WallRunEnter,
+			StateBit(ETraversalState::Hanging) | StateBit(ETraversalState::WallRunning) | StateBit(ETraversalState::InCover)
+		},
+		// Hanging. Climbing up and dropping down are driven by input
+		{
+			ETraversalCheck::None,
+			StateBit(ETraversalState::Climbing) | StateBit(ETraversalState::Default)
+		},
+		// Climbing. Finished by the climb animation
+		{
+			ETraversalCheck::None,
+			StateBit(ETraversalState::Default)
+		},
+		// WallRunning
+		{
+			ETraversalCheck::WallRunMove,
+			StateBit(ETraversalState::Default)
+		},
+		// InCover. Movement is only used to pop out while aiming
+		{
+			ETraversalCheck::DefaultMove,
+			StateBit(ETraversalState::Default)
+		}
+	};
+
+	static_assert(UE_ARRAY_COUNT(StateDescs) == static_cast<uint8>(ETraversalState::Count), "Every traversal state needs an entry in the transition table");
+	static_assert(static_cast<uint8>(ETraversalState::Count) <= ETraversalPackedState::StateMask + 1, "Traversal states don't fit in the packed state byte");
+}
+
+const FTraversalStateDesc& GetTraversalStateDesc(const ETraversalState State)
+{
+	check(State < ETraversalState::Count);
+	return StateDescs[static_cast<uint8>(State)];
+}
+
+bool CanTransitionTraversalState(const ETraversalState From, const ETraversalState To)
+{
+	return (GetTraversalStateDesc(From).AllowedTransitions & StateBit(To)) != 0;
+}
@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TraversalState.generated.h"
+
+/** Mutually exclusive traversal states of a character **/
+UENUM(BlueprintType)
+enum class ETraversalState : uint8
+{
+	/** Walking or falling, no traversal move in progress **/
+	Default,
+
+	/** Hanging from a ledge **/
+	Hanging,
+
+	/** Playing the climb up animation from a ledge **/
+	Climbing,
+
+	/** Running along a wall **/
+	WallRunning,
+
+	/** Leaning against cover **/
+	InCover,
+
+	Count UMETA(Hidden)
+};
+
+/** Per-tick checks a state can ask for. Each one owns a fixed set of probes **/
+namespace ETraversalCheck
+{
+	enum Type : uint8
+	{
+		None = 0,
+
+		/** Regular movement input **/
+		DefaultMove = 1 << 0,
+
+		/** Wall run movement. Probes: side wall (current side), ground **/
+		WallRunMove = 1 << 1,
+
+		/** Ledge indicator UI. Probes: edge index, else the ledge scan overlap issued async and its ray fan run on the next frame **/
+		LedgeIndicator = 1 << 2,
+
+		/** Grab a ledge while falling. Probes: edge index, else the ledge scan (one overlap and its ray fan) **/
+		Ledge = 1 << 3,
+
+		/** Start a wall run while falling. Probes: side wall (both sides) **/
+		WallRunEnter = 1 << 4
+	};
+}
+
+/** Bits of the traversal state byte sent with saved moves and replicated to simulated proxies **/
+namespace ETraversalPackedState
+{
+	enum Type : uint8
+	{
+		None = 0,
+
+		/** ETraversalState value **/
+		StateMask = 0x07,
+
+		/** WallRunning only. The wall is on the right **/
+		RightWallRun = 1 << 3,
+
+		/** InCover only **/
+		RightCover = 1 << 4,
+		TallCover = 1 << 5,
+
+		/** Simulated proxies only, moves send aiming as a compressed flag **/
+		Aiming = 1 << 6,
+
+		/** Moves only. The anchor follows the state byte **/
+		HasAnchor = 1 << 7
+	};
+}
+
+/** Static description of a traversal state **/
+struct FTraversalStateDesc
+{
+	/** ETraversalCheck flags Tick runs in this state **/
+	uint8 Checks;
+
+	/** Bit per ETraversalState this state can transition to **/
+	uint8 AllowedTransitions;
+};
+
+/** Returns the description of a state from the transition table **/
+const FTraversalStateDesc& GetTraversalStateDesc(const ETraversalState State);
+
+/** Returns true if the transition table allows going from one state to another **/
+bool CanTransitionTraversalState(const ETraversalState From, const ETraversalState To);
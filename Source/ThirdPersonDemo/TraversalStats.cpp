@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalStats.h"
+#include "GameFramework/Actor.h"
+#include "Trace/Trace.inl"
+
+DEFINE_STAT(STAT_TraversalMoveCharacter);
+DEFINE_STAT(STAT_TraversalTryUIHang);
+DEFINE_STAT(STAT_TraversalTryHang);
+DEFINE_STAT(STAT_TraversalTryEnterWallRun);
+DEFINE_STAT(STAT_TraversalCameraRig);
+DEFINE_STAT(STAT_TraversalLineTrace);
+DEFINE_STAT(STAT_TraversalLedgeScan);
+DEFINE_STAT(STAT_TraversalWallRunPrediction);
+DEFINE_STAT(STAT_TraversalAnimTick);
+DEFINE_STAT(STAT_TraversalCoverQuery);
+DEFINE_STAT(STAT_TraversalBatchTick);
+DEFINE_STAT(STAT_TraversalKernel);
+
+DEFINE_STAT(STAT_TraversalTraces);
+DEFINE_STAT(STAT_TraversalAsyncTraces);
+DEFINE_STAT(STAT_TraversalCachedProbes);
+DEFINE_STAT(STAT_TraversalCoherentProbeHits);
+DEFINE_STAT(STAT_TraversalCoherentProbeMisses);
+DEFINE_STAT(STAT_TraversalCoherentLedgeScanHits);
+DEFINE_STAT(STAT_TraversalCoherentLedgeScanMisses);
+DEFINE_STAT(STAT_TraversalChecksRun);
+DEFINE_STAT(STAT_TraversalChecksSkipped);
+DEFINE_STAT(STAT_TraversalBatchedCharacters);
+DEFINE_STAT(STAT_TraversalStaggeredCharacters);
+DEFINE_STAT(STAT_TraversalProximityCulledChecks);
+DEFINE_STAT(STAT_TraversalCameraSyncProbes);
+DEFINE_STAT(STAT_TraversalLedgeScanRays);
+DEFINE_STAT(STAT_TraversalWallRunPredictions);
+DEFINE_STAT(STAT_TraversalWallRunPredictedSkips);
+
+uint32 GTraversalTraceCount = 0;
+uint64 GTraversalAnimCycles = 0;
+uint32 GTraversalAnimTicks = 0;
+
+UE_TRACE_CHANNEL_DEFINE(TraversalChannel);
+
+UE_TRACE_EVENT_BEGIN(Traversal, StateTransition)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, FrameNumber)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, From)
+	UE_TRACE_EVENT_FIELD(uint8, To)
+UE_TRACE_EVENT_END()
+
+void TraversalTrace::OutputStateTransition(const AActor* Actor, const ETraversalState From, const ETraversalState To)
+{
+	UE_TRACE_LOG(Traversal, StateTransition, TraversalChannel)
+		<< StateTransition.Cycle(FPlatformTime::Cycles64())
+		<< StateTransition.FrameNumber(GFrameCounter)
+		<< StateTransition.ActorId(Actor ? Actor->GetUniqueID() : 0)
+		<< StateTransition.From(static_cast<uint8>(From))
+		<< StateTransition.To(static_cast<uint8>(To));
+}
@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "TraversalState.h"
+
+DECLARE_STATS_GROUP(TEXT("Traversal"), STATGROUP_Traversal, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Movecharacter"), STAT_TraversalMoveCharacter, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TryUIHang"), STAT_TraversalTryUIHang, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TryHang"), STAT_TraversalTryHang, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TryEnterWallRun"), STAT_TraversalTryEnterWallRun, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Camera Rig"), STAT_TraversalCameraRig, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("DoLineTraceCheck"), STAT_TraversalLineTrace, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ledge Scan"), STAT_TraversalLedgeScan, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WallRun Prediction"), STAT_TraversalWallRunPrediction, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Anim Tick"), STAT_TraversalAnimTick, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Cover Query"), STAT_TraversalCoverQuery, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batch Tick"), STAT_TraversalBatchTick, STATGROUP_Traversal, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batch Kernels"), STAT_TraversalKernel, STATGROUP_Traversal, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces"), STAT_TraversalTraces, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Async Traces"), STAT_TraversalAsyncTraces, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cached Probes"), STAT_TraversalCachedProbes, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coherent Probe Hits"), STAT_TraversalCoherentProbeHits, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coherent Probe Misses"), STAT_TraversalCoherentProbeMisses, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coherent Ledge Scan Hits"), STAT_TraversalCoherentLedgeScanHits, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coherent Ledge Scan Misses"), STAT_TraversalCoherentLedgeScanMisses, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Checks Run"), STAT_TraversalChecksRun, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Checks Skipped"), STAT_TraversalChecksSkipped, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Batched Characters"), STAT_TraversalBatchedCharacters, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Staggered Characters"), STAT_TraversalStaggeredCharacters, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Proximity Culled Checks"), STAT_TraversalProximityCulledChecks, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Camera Sync Probes"), STAT_TraversalCameraSyncProbes, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ledge Scan Rays"), STAT_TraversalLedgeScanRays, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("WallRun Predictions"), STAT_TraversalWallRunPredictions, STATGROUP_Traversal, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("WallRun Predicted Skips"), STAT_TraversalWallRunPredictedSkips, STATGROUP_Traversal, );
+
+/** Sync and async traces issued by traversal since startup. Unlike the stats it is available in every build configuration **/
+extern uint32 GTraversalTraceCount;
+
+/** Game thread cycles spent ticking traversal character meshes since startup, and the number of mesh ticks **/
+extern uint64 GTraversalAnimCycles;
+extern uint32 GTraversalAnimTicks;
+
+/** Insights channel for traversal events. Enable with -trace=traversal **/
+UE_TRACE_CHANNEL_EXTERN(TraversalChannel);
+
+namespace TraversalTrace
+{
+	/** Emit a timestamped state transition of the actor on the traversal channel **/
+	void OutputStateTransition(const AActor* Actor, const ETraversalState From, const ETraversalState To);
+}
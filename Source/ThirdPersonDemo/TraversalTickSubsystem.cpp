@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalTickSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "ThirdPersonDemoCharacter.h"
+#include "TraversalStats.h"
+
+static TAutoConsoleVariable<int32> CVarTraversalStaggerFrames(
+	TEXT("traversal.Tick.StaggerFrames"),
+	1,
+	TEXT("Spread the entry probes of traversal characters other than local players over this many frames. 1 runs them every frame."),
+	ECVF_Default);
+
+//////////////////////////////////////////////////////////////////////////
+// FTraversalBatchTickFunction
+
+void FTraversalBatchTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target == nullptr || TickType == LEVELTICK_ViewportsOnly) return;
+
+	Target->TickBatch(DeltaTime);
+}
+
+FString FTraversalBatchTickFunction::DiagnosticMessage()
+{
+	return TEXT("FTraversalBatchTickFunction");
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UTraversalTickSubsystem
+
+void UTraversalTickSubsystem::Deinitialize()
+{
+	if (BatchTickFunction.IsTickFunctionRegistered())
+	{
+		BatchTickFunction.UnRegisterTickFunction();
+	}
+	BatchTickFunction.Target = nullptr;
+	Characters.Reset();
+
+	Super::Deinitialize();
+}
+
+void UTraversalTickSubsystem::RegisterCharacter(AThirdPersonDemoCharacter* Character)
+{
+	if (Character == nullptr || Characters.Contains(Character)) return;
+
+	// The batch tick is registered on the first character so worlds without traversal pay nothing
+	if (!BatchTickFunction.IsTickFunctionRegistered())
+	{
+		BatchTickFunction.Target = this;
+		BatchTickFunction.TickGroup = TG_PrePhysics;
+		BatchTickFunction.bCanEverTick = true;
+		BatchTickFunction.bStartWithTickEnabled = true;
+		BatchTickFunction.RegisterTickFunction(GetWorld()->PersistentLevel);
+	}
+
+	Characters.Add(Character);
+	Character->SetActorTickEnabled(false);
+
+	// Like the actor tick it replaces, the batch has to run after local players processed their input.
+	// Controllers possessing the character later are added by the character
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		AddControllerPrerequisite(Iterator->Get());
+	}
+	AddControllerPrerequisite(Character->GetController());
+
+	// Movement input added by the batch has to be consumed by the movement component on the same frame
+	if (UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement())
+	{
+		MovementComponent->PrimaryComponentTick.AddPrerequisite(this, BatchTickFunction);
+	}
+}
+
+void UTraversalTickSubsystem::UnregisterCharacter(AThirdPersonDemoCharacter* Character)
+{
+	if (Characters.RemoveSingleSwap(Character) == 0) return;
+
+	if (UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement())
+	{
+		MovementComponent->PrimaryComponentTick.RemovePrerequisite(this, BatchTickFunction);
+	}
+}
+
+void UTraversalTickSubsystem::AddControllerPrerequisite(AController* Controller)
+{
+	if (Controller == nullptr || !Controller->IsLocalController()) return;
+
+	BatchTickFunction.AddPrerequisite(Controller, Controller->PrimaryActorTick);
+}
+
+void UTraversalTickSubsystem::TickBatch(const float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraversalBatchTick);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Each character runs its entry probes on one frame out of StaggerFrames, based on its slot in the batch.
+	// Local players always run them so the player never feels the stagger
+	const int32 StaggerFrames = FMath::Max(1, CVarTraversalStaggerFrames.GetValueOnGameThread());
+	const int32 StaggerPhase = static_cast<int32>(GFrameCounter % StaggerFrames);
+
+	// Simulated proxies and the server copies of remote players follow the network instead
+	BatchCharacters.Reset();
+	for (AThirdPersonDemoCharacter* Character : Characters)
+	{
+		if (IsValid(Character) && Character->IsTraversalLocallyPredicted()) BatchCharacters.Add(Character);
+	}
+	Batch.SetNum(BatchCharacters.Num());
+
+	// Gather state, input and tuning into the batch
+	for (int32 Index = 0; Index < BatchCharacters.Num(); ++Index)
+	{
+		const AThirdPersonDemoCharacter* Character = BatchCharacters[Index];
+		const bool bRunEntryChecks = (Character->IsPlayerControlled() && Character->IsLocallyControlled()) || Index % StaggerFrames == StaggerPhase;
+		if (!bRunEntryChecks)
+		{
+			INC_DWORD_STAT(STAT_TraversalStaggeredCharacters);
+		}
+		BatchCharacters[Index]->GatherTraversal(Batch, Index, bRunEntryChecks);
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TraversalKernel);
+		TraversalKernel::ParallelForBatch(Batch, &TraversalKernel::PlanProbes);
+	}
+
+	// Scene queries and their debug draws stay on the game thread
+	for (int32 Index = 0; Index < BatchCharacters.Num(); ++Index)
+	{
+		BatchCharacters[Index]->RunTraversalProbes(Batch, Index);
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TraversalKernel);
+		TraversalKernel::ParallelForBatch(Batch, &TraversalKernel::Decide);
+	}
+
+	// Write the decisions back in one pass
+	for (int32 Index = 0; Index < BatchCharacters.Num(); ++Index)
+	{
+		AThirdPersonDemoCharacter* Character = BatchCharacters[Index];
+		Character->ApplyTraversal(Batch, Index, DeltaSeconds * Character->CustomTimeDilation);
+	}
+
+	INC_DWORD_STAT_BY(STAT_TraversalBatchedCharacters, BatchCharacters.Num());
+	LastBatchSeconds = FPlatformTime::Seconds() - StartTime;
+}
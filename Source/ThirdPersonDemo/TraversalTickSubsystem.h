@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TraversalKernel.h"
+#include "TraversalTickSubsystem.generated.h"
+
+class AController;
+class AThirdPersonDemoCharacter;
+class UTraversalTickSubsystem;
+
+/** Single tick function running the traversal update of every registered character **/
+USTRUCT()
+struct FTraversalBatchTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UTraversalTickSubsystem* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTraversalBatchTickFunction> : public TStructOpsTypeTraitsBase2<FTraversalBatchTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Owns every traversal character of a world and ticks them as one batch instead of one actor tick each.
+ * Traversal decisions run over a FTraversalBatch with ParallelFor, probes and results stay on the game thread.
+ * Entry probes (ledge indicator, ledge grab, wall run start) can be staggered over several frames with traversal.Tick.StaggerFrames.
+ */
+UCLASS()
+class UTraversalTickSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Take over ticking of the character. Its own actor tick is disabled **/
+	void RegisterCharacter(AThirdPersonDemoCharacter* Character);
+
+	/** Stop ticking the character **/
+	void UnregisterCharacter(AThirdPersonDemoCharacter* Character);
+
+	/** Run the batch after a local controller's tick, so the input it processed reaches its character on the same frame **/
+	void AddControllerPrerequisite(AController* Controller);
+
+	/** Tick every registered character **/
+	void TickBatch(const float DeltaSeconds);
+
+	/** Game thread time of the last batch, in seconds **/
+	double GetLastBatchSeconds() const { return LastBatchSeconds; }
+
+	int32 GetNumCharacters() const { return Characters.Num(); }
+
+private:
+	FTraversalBatchTickFunction BatchTickFunction;
+
+	UPROPERTY()
+	TArray<AThirdPersonDemoCharacter*> Characters;
+
+	/** Valid characters of the current batch, in batch order **/
+	TArray<AThirdPersonDemoCharacter*> BatchCharacters;
+
+	FTraversalBatch Batch;
+
+	double LastBatchSeconds = 0.0;
+};
@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TraversalWallRunPredictor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "TraversalDebug.h"
+#include "TraversalMath.h"
+#include "TraversalStats.h"
+
+static TAutoConsoleVariable<int32> CVarTraversalWallRunPrediction(
+	TEXT("traversal.WallRun.Prediction"),
+	1,
+	TEXT("Only run the wall run entry probes while the predicted jump trajectory passes a wall. 0 probes every airborne frame."),
+	ECVF_Default);
+
+namespace
+{
+	/** Horizontal distance between two samples of the trajectory, and most samples per prediction **/
+	constexpr float SampleSpacing = 25.f;
+	constexpr int32 MaxSamples = 48;
+
+	/** Facing and input changes that make the side rays of the prediction outdated **/
+	constexpr float ForwardMinDot = 0.99f;
+	constexpr float ControlMoveTolerance = 0.1f;
+
+	FVector GetBallisticLocation(const FVector& Location, const FVector& Velocity, const float GravityZ, const float Time)
+	{
+		return Location + Velocity * Time + FVector::UpVector * (0.5f * GravityZ * Time * Time);
+	}
+}
+
+bool FTraversalWallRunPredictor::Update(const AActor* Actor, const FTraversalWallRunPredictorInput& Input, const float Time)
+{
+	if (CVarTraversalWallRunPrediction.GetValueOnGameThread() == 0)
+	{
+		Reset();
+		return true;
+	}
+
+	if (bValid && !IsStillValid(Input, Time)) bValid = false;
+	if (!bValid) Predict(Actor, Input, Time);
+
+	const float Elapsed = Time - StartTime;
+	if (Elapsed >= WindowStart && Elapsed <= WindowEnd) return true;
+
+	INC_DWORD_STAT(STAT_TraversalWallRunPredictedSkips);
+	return false;
+}
+
+void FTraversalWallRunPredictor::Reset()
+{
+	bValid = false;
+}
+
+bool FTraversalWallRunPredictor::IsStillValid(const FTraversalWallRunPredictorInput& Input, const float Time) const
+{
+	const float Elapsed = Time - StartTime;
+	if (Elapsed < 0.f || Elapsed > LookaheadTime) return false;
+
+	// Air control, collisions and launches all show up as a departure from the ballistic velocity
+	const FVector PredictedVelocity = StartVelocity + FVector::UpVector * (GravityZ * Elapsed);
+	if (FVector::DistSquared(Input.Velocity, PredictedVelocity) > FMath::Square(Input.VelocityTolerance)) return false;
+
+	// The side probes follow the facing, which follows the input
+	if (FVector::DotProduct(Input.Forward, StartForward) < ForwardMinDot) return false;
+	return FVector::DistSquared(Input.ControlMoveVector, StartControlMoveVector) <= FMath::Square(ControlMoveTolerance);
+}
+
+void FTraversalWallRunPredictor::Predict(const AActor* Actor, const FTraversalWallRunPredictorInput& Input, const float Time)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraversalWallRunPrediction);
+	INC_DWORD_STAT(STAT_TraversalWallRunPredictions);
+
+	bValid = true;
+	StartTime = Time;
+	StartVelocity = Input.Velocity;
+	StartForward = Input.Forward;
+	StartControlMoveVector = Input.ControlMoveVector;
+	GravityZ = Input.GravityZ;
+	WindowStart = 0.f;
+	WindowEnd = -1.f;
+
+	// Past the time the vertical velocity drops below the wall run minimum there is nothing to predict
+	LookaheadTime = Input.MaxLookaheadTime;
+	if (GravityZ < 0.f)
+	{
+		LookaheadTime = FMath::Min(LookaheadTime, (Input.Velocity.Z - Input.WallRunMinVerticalVelocity) / -GravityZ);
+	}
+	const float HorizontalSpeed = TraversalMath::GetHorizontal(Input.Velocity).Size();
+	if (LookaheadTime <= 0.f || HorizontalSpeed <= KINDA_SMALL_NUMBER) return;
+
+	const int32 NumSamples = FMath::Clamp(FMath::CeilToInt(HorizontalSpeed * LookaheadTime / SampleSpacing), 1, MaxSamples);
+	const float SampleTime = LookaheadTime / NumSamples;
+	const FVector RightOffset = TraversalMath::RotateAboutZ90(Input.Forward, true) * Input.WallRunSideDistance;
+	const FVector ProbeOffset = FVector::DownVector * Input.SideProbeDrop;
+
+	// One overlap of the box around every side ray of the trajectory
+	FBox Bounds(ForceInit);
+	for (int32 Sample = 0; Sample <= NumSamples; ++Sample)
+	{
+		Bounds += GetBallisticLocation(Input.Location, Input.Velocity, GravityZ, Sample * SampleTime) + ProbeOffset;
+	}
+	Bounds = Bounds.ExpandBy(Input.WallRunSideDistance);
+
+	// Same query setup as the side probes
+	const ECollisionChannel Channel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery_MAX);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TraversalWallRunPrediction), false, Actor);
+
+	INC_DWORD_STAT(STAT_TraversalTraces);
+	++GTraversalTraceCount;
+
+	TArray<FOverlapResult> Overlaps;
+	Actor->GetWorld()->OverlapMultiByChannel(Overlaps, Bounds.GetCenter(), FQuat::Identity, Channel, FCollisionShape::MakeBox(Bounds.GetExtent()), QueryParams);
+
+	TArray<UPrimitiveComponent*, TInlineAllocator<8>> Candidates;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (Component == nullptr || Component->GetCollisionResponseToChannel(Channel) != ECR_Block) continue;
+		Candidates.AddUnique(Component);
+	}
+	if (Candidates.Num() == 0) return;
+
+	// Side rays along the trajectory, narrow phase only
+	int32 FirstHitSample = INDEX_NONE;
+	int32 LastHitSample = INDEX_NONE;
+	FHitResult Hit;
+	for (int32 Sample = 0; Sample <= NumSamples; ++Sample)
+	{
+		const FVector Start = GetBallisticLocation(Input.Location, Input.Velocity, GravityZ, Sample * SampleTime) + ProbeOffset;
+		bool bHit = false;
+		for (UPrimitiveComponent* Component : Candidates)
+		{
+			bHit = Component->LineTraceComponent(Hit, Start, Start + RightOffset, QueryParams) || Component->LineTraceComponent(Hit, Start, Start - RightOffset, QueryParams);
+			if (bHit) break;
+		}
+
+#if WITH_TRAVERSAL_DEBUG
+		TraversalDebug::RecordProbe(Actor, ETraversalProbe::WallRunPrediction, Start - RightOffset, Start + RightOffset, bHit, Hit.ImpactPoint, false);
+#endif
+		if (!bHit) continue;
+
+		if (FirstHitSample == INDEX_NONE) FirstHitSample = Sample;
+		LastHitSample = Sample;
+	}
+	if (FirstHitSample == INDEX_NONE) return;
+
+	// Widen by a sample on each side, walls are only known at the samples
+	WindowStart = (FirstHitSample - 1) * SampleTime;
+	WindowEnd = (LastHitSample + 1) * SampleTime;
+}
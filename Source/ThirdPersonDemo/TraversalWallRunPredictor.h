@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Airborne state the wall run prediction is built from, and checked against on later frames **/
+struct FTraversalWallRunPredictorInput
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Forward = FVector::ForwardVector;
+	FVector Velocity = FVector::ZeroVector;
+	FVector ControlMoveVector = FVector::ZeroVector;
+	float GravityZ = 0.f;
+
+	/** Same segments as the side wall run probes: Location + Down * SideProbeDrop, then WallRunSideDistance sideways **/
+	float SideProbeDrop = 0.f;
+	float WallRunSideDistance = 30.f;
+
+	/** Wall run can only start above this vertical velocity, which bounds how far ahead the trajectory is worth sweeping **/
+	float WallRunMinVerticalVelocity = -100.f;
+
+	/** Longest stretch of trajectory swept **/
+	float MaxLookaheadTime = 1.f;
+
+	/** Velocity drift from the ballistic prediction, in cm/s, after which the prediction is rebuilt **/
+	float VelocityTolerance = 50.f;
+};
+
+/**
+ * Predicts when a wall run entry is possible during a jump, so the side wall probes only run while it is.
+ * The ballistic trajectory is swept once, with one overlap query and narrow-phase side rays along it, giving the
+ * time window in which a wall is within WallRunSideDistance. The prediction holds until the velocity drifts
+ * from the ballistic curve, the input or facing changes, or the window runs out.
+ */
+class FTraversalWallRunPredictor
+{
+public:
+	/** Rebuild the prediction if needed. @return True if the side probes should run this frame **/
+	bool Update(const AActor* Actor, const FTraversalWallRunPredictorInput& Input, const float Time);
+
+	/** Drop the prediction, e.g. on landing **/
+	void Reset();
+
+	/** @return True if a prediction is held **/
+	bool IsValid() const { return bValid; }
+
+private:
+	bool IsStillValid(const FTraversalWallRunPredictorInput& Input, const float Time) const;
+	void Predict(const AActor* Actor, const FTraversalWallRunPredictorInput& Input, const float Time);
+
+	bool bValid = false;
+
+	/** Takeoff state of the prediction **/
+	float StartTime = 0.f;
+	FVector StartVelocity = FVector::ZeroVector;
+	FVector StartForward = FVector::ForwardVector;
+	FVector StartControlMoveVector = FVector::ZeroVector;
+	float GravityZ = 0.f;
+
+	/** Seconds after StartTime the prediction covers, and the part of it a wall is within reach. Empty when WindowEnd < WindowStart **/
+	float LookaheadTime = 0.f;
+	float WindowStart = 0.f;
+	float WindowEnd = -1.f;
+};